@@ -0,0 +1,631 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos and collaborators. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#include "bgsimplifier.h"
+#include "solver.h"
+#include "varreplacer.h"
+#include "simplifier.h"
+#include "clausevivifier.h"
+#include "clabstraction.h"
+#include "clauseallocator.h"
+#include "time_mem.h"
+#include <iomanip>
+
+using namespace CMSat;
+using std::cout;
+using std::endl;
+
+BgSimplifier::BgSimplifier(Solver* _solver) :
+    solver(_solver)
+    , numBackground(0)
+    , numVars(0)
+    , snapSimplify(0)
+    , snapReplaced(0)
+    , snapConsolidated(0)
+    , lastSnapConfl(0)
+    , nextStartConfl(0)
+    , qhead(0)
+    , steps(0)
+    , maxSteps(0)
+    , abort(false)
+    , done(false)
+    , thread(NULL)
+{
+}
+
+BgSimplifier::~BgSimplifier()
+{
+    abort = true;
+    stopThread();
+}
+
+void BgSimplifier::stopThread()
+{
+    if (thread == NULL)
+        return;
+
+    thread->join();
+    delete thread;
+    thread = NULL;
+}
+
+bool BgSimplifier::mergeAndStart()
+{
+    assert(solver->ok);
+    if (thread != NULL) {
+        if (!done)
+            return true;
+
+        stopThread();
+        if (!merge())
+            return false;
+    }
+
+    if (solver->sumConflicts() >= nextStartConfl) {
+        start();
+    }
+
+    return solver->ok;
+}
+
+bool BgSimplifier::finish()
+{
+    assert(solver->ok);
+    if (thread == NULL)
+        return true;
+
+    abort = true;
+    stopThread();
+
+    return merge();
+}
+
+void BgSimplifier::start()
+{
+    assert(thread == NULL);
+    assert(solver->decisionLevel() == 0);
+    const double myTime = cpuTime();
+
+    takeSnapshot();
+    nextStartConfl = solver->sumConflicts() + solver->conf.bgSimpEvery;
+    runStats = Stats();
+    runStats.snapshotTime = cpuTime() - myTime;
+    if (candidates.empty()) {
+        globalStats += runStats;
+        return;
+    }
+
+    runStats.numJobs = 1;
+    runStats.candidates = candidates.size();
+    maxSteps = solver->conf.bgSimpBudgetM*1000ULL*1000ULL;
+    abort = false;
+    done = false;
+    thread = new std::thread(&BgSimplifier::work, this);
+}
+
+void BgSimplifier::takeSnapshot()
+{
+    lits.clear();
+    clauses.clear();
+    origLits.clear();
+    candidates.clear();
+    numVars = solver->nVars();
+    snapSimplify = solver->solveStats.numSimplify;
+    snapReplaced = solver->varReplacer->getNumReplacedVars();
+    snapConsolidated = solver->clAllocator->getNumConsolidated();
+
+    for(vector<ClOffset>::const_iterator
+        it = solver->longIrredCls.begin(), end = solver->longIrredCls.end()
+        ; it != end
+        ; it++
+    ) {
+        const Clause& cl = *solver->clAllocator->getPointer(*it);
+        addSnapClause(cl.begin(), cl.end());
+    }
+
+    //Implicit clauses, both irredundant and learnt, each only once
+    Lit tmp[3];
+    for(size_t wsLit = 0; wsLit < numVars*2; wsLit++) {
+        const Lit lit = Lit::toLit(wsLit);
+        const vec<Watched>& ws = solver->watches[wsLit];
+        for(vec<Watched>::const_iterator
+            it = ws.begin(), end = ws.end()
+            ; it != end
+            ; it++
+        ) {
+            if (it->isBinary()
+                && lit < it->lit1()
+            ) {
+                tmp[0] = lit;
+                tmp[1] = it->lit1();
+                addSnapClause(tmp, tmp + 2);
+            }
+
+            if (it->isTri()
+                && lit < it->lit1()
+                && lit < it->lit2()
+            ) {
+                tmp[0] = lit;
+                tmp[1] = it->lit1();
+                tmp[2] = it->lit2();
+                addSnapClause(tmp, tmp + 3);
+            }
+        }
+    }
+    numBackground = clauses.size();
+
+    //Low-glue learnt clauses made since the last job
+    for(vector<ClOffset>::const_iterator
+        it = solver->longRedCls.begin(), end = solver->longRedCls.end()
+        ; it != end
+        ; it++
+    ) {
+        const Clause& cl = *solver->clAllocator->getPointer(*it);
+        if (cl.freed()
+            || cl.stats.glue > solver->conf.tierMidGlue
+            || cl.stats.conflictNumIntroduced < lastSnapConfl
+        ) {
+            continue;
+        }
+
+        if (addSnapClause(cl.begin(), cl.end())) {
+            candidates.push_back(Candidate(*it, origLits.size(), cl.size()));
+            origLits.insert(origLits.end(), cl.begin(), cl.end());
+        }
+    }
+
+    lastSnapConfl = solver->sumConflicts();
+}
+
+///Copies the clause sorted, without the literals false at level 0, unless satisfied
+bool BgSimplifier::addSnapClause(const Lit* begin, const Lit* end)
+{
+    const uint32_t at = lits.size();
+    for(const Lit* l = begin; l != end; l++) {
+        const lbool val = solver->value(*l);
+        if (val == l_True) {
+            lits.resize(at);
+            return false;
+        }
+
+        if (val == l_Undef)
+            lits.push_back(*l);
+    }
+
+    //Only 2-long and longer clauses are watched in the worker
+    if (lits.size() - at < 2) {
+        lits.resize(at);
+        return false;
+    }
+    std::sort(lits.begin() + at, lits.end());
+    clauses.push_back(SnapClause(at, lits.size() - at));
+
+    return true;
+}
+
+void BgSimplifier::work()
+{
+    const double myTime = cpuTime();
+    steps = 0;
+    assigns.clear();
+    assigns.resize(numVars, l_Undef);
+    trail.clear();
+    qhead = 0;
+
+    subsume();
+    vivify();
+
+    //Free the worker's memory, the snapshot is still needed for merging
+    vector<vector<uint32_t> >().swap(watches);
+    vector<lbool>().swap(assigns);
+
+    runStats.workTime = cpuTime() - myTime;
+    done = true;
+}
+
+/**
+@brief Removes the candidates that are subsumed by another snapshot clause
+
+As in Simplifier::findSubsumed0(), every clause goes through the occurrence
+list of its literal that has the fewest occurrences, and the abstractions are
+checked before the literals. Only the candidates are in the lists. Of two equal
+clauses the one earlier in the snapshot is kept, so background clauses are
+never removed.
+*/
+void BgSimplifier::subsume()
+{
+    vector<vector<uint32_t> > occur(numVars*2);
+    for(size_t index = numBackground; index < clauses.size(); index++) {
+        const SnapLits cl = getLits(index);
+        for(uint32_t i = 0; i < cl.size(); i++) {
+            occur[cl[i].toInt()].push_back(index);
+        }
+    }
+
+    vector<CL_ABST_TYPE> abst(clauses.size());
+    for(size_t index = 0; index < clauses.size(); index++) {
+        abst[index] = calcAbstraction(getLits(index));
+    }
+    steps += lits.size();
+
+    int64_t limit = (int64_t)maxSteps - (int64_t)steps;
+    for(size_t index = 0; index < clauses.size() && !abort && limit > 0; index++) {
+        if (index >= numBackground
+            && candidates[index - numBackground].subsumed
+        ) {
+            continue;
+        }
+
+        const SnapLits ps = getLits(index);
+        Lit best = ps[0];
+        for(uint32_t i = 1; i < ps.size(); i++) {
+            if (occur[ps[i].toInt()].size() < occur[best.toInt()].size())
+                best = ps[i];
+        }
+
+        const vector<uint32_t>& occ = occur[best.toInt()];
+        limit -= ps.size() + occ.size();
+        for(vector<uint32_t>::const_iterator
+            it = occ.begin(), end = occ.end()
+            ; it != end
+            ; it++
+        ) {
+            Candidate& cand = candidates[*it - numBackground];
+            const SnapLits other = getLits(*it);
+            if (*it == index
+                || cand.subsumed
+                || other.size() < ps.size()
+                || (other.size() == ps.size() && *it < index)
+                || !Simplifier::subsetAbst(abst[index], abst[*it])
+            ) {
+                continue;
+            }
+
+            if (Simplifier::subset(ps, other, limit)) {
+                cand.subsumed = true;
+                runStats.subsumed++;
+            }
+        }
+    }
+    steps = (int64_t)maxSteps - limit;
+}
+
+void BgSimplifier::vivify()
+{
+    watches.clear();
+    watches.resize(numVars*2);
+    for(size_t i = 0; i < numBackground; i++) {
+        const SnapClause& cl = clauses[i];
+        watches[lits[cl.start].toInt()].push_back(i);
+        watches[lits[cl.start + 1].toInt()].push_back(i);
+    }
+    steps += numBackground;
+
+    for(size_t at = 0; at < candidates.size() && !abort && steps < maxSteps; at++) {
+        if (!candidates[at].subsumed)
+            vivifyCandidate(at);
+    }
+}
+
+/**
+@brief Shortens the candidate with the vivification of the ClauseVivifier
+
+Only the background clauses are propagated, so the result is RUP wrt. them.
+*/
+void BgSimplifier::vivifyCandidate(const size_t at)
+{
+    SnapClause& cl = clauses[numBackground + at];
+    vivLits.assign(lits.begin() + cl.start, lits.begin() + cl.start + cl.size);
+    const bool shortened = ClauseVivifier::vivifyLits(
+        *this
+        , vivLits
+        , uselessLits
+        , 1
+        , steps
+    );
+    cancel();
+    if (!shortened)
+        return;
+
+    std::copy(vivLits.begin(), vivLits.end(), lits.begin() + cl.start);
+    runStats.vivified++;
+    runStats.litsRem += cl.size - vivLits.size();
+    cl.size = vivLits.size();
+    candidates[at].vivified = true;
+}
+
+void BgSimplifier::enqueue(const Lit lit)
+{
+    assert(value(lit) == l_Undef);
+    assigns[lit.var()] = boolToLBool(!lit.sign());
+    trail.push_back(lit);
+}
+
+void BgSimplifier::cancel()
+{
+    for(vector<Lit>::const_iterator
+        it = trail.begin(), end = trail.end()
+        ; it != end
+        ; it++
+    ) {
+        assigns[it->var()] = l_Undef;
+    }
+    trail.clear();
+    qhead = 0;
+}
+
+///Two-watched-literal propagation over the background clauses. A conflict is by the index of the clause
+PropBy BgSimplifier::propagate()
+{
+    while (qhead < trail.size()) {
+        const Lit falseLit = ~trail[qhead++];
+        vector<uint32_t>& ws = watches[falseLit.toInt()];
+        steps += ws.size();
+
+        vector<uint32_t>::iterator i = ws.begin();
+        vector<uint32_t>::iterator j = i;
+        const vector<uint32_t>::iterator end = ws.end();
+        for(; i != end; i++) {
+            const SnapClause& cl = clauses[*i];
+            Lit* const c = &lits[cl.start];
+            if (c[0] == falseLit)
+                std::swap(c[0], c[1]);
+            assert(c[1] == falseLit);
+
+            if (value(c[0]) == l_True) {
+                *j++ = *i;
+                continue;
+            }
+
+            //Find new watch
+            bool found = false;
+            for(uint32_t k = 2; k < cl.size; k++) {
+                if (value(c[k]) != l_False) {
+                    std::swap(c[1], c[k]);
+                    watches[c[1].toInt()].push_back(*i);
+                    found = true;
+                    break;
+                }
+            }
+            if (found)
+                continue;
+
+            *j++ = *i;
+            if (value(c[0]) == l_False) {
+                //Conflict, keep the rest of the watches
+                const uint32_t confl = *i;
+                for(i++; i != end; i++) {
+                    *j++ = *i;
+                }
+                ws.resize(ws.size() - (end - j));
+                return PropBy(confl);
+            }
+            enqueue(c[0]);
+        }
+        ws.resize(ws.size() - (end - j));
+    }
+
+    return PropBy();
+}
+
+bool BgSimplifier::sameClause(const ClOffset offset, const Candidate& cand) const
+{
+    const Clause& cl = *solver->clAllocator->getPointer(offset);
+    if (cl.freed()
+        || !cl.learnt()
+        || cl.size() != cand.origSize
+    ) {
+        return false;
+    }
+
+    for(uint32_t i = 0; i < cl.size(); i++) {
+        if (!solver->seen[cl[i].toInt()])
+            return false;
+    }
+
+    return true;
+}
+
+/**
+@brief Finds the candidate in the solver
+
+The literals of the candidate must be marked in solver->seen. Returns the max.
+offset if the clause has been removed or changed since the snapshot.
+*/
+ClOffset BgSimplifier::findClause(const Candidate& cand)
+{
+    if (solver->clAllocator->getNumConsolidated() == snapConsolidated) {
+        if (sameClause(cand.offset, cand))
+            return cand.offset;
+
+        return std::numeric_limits<ClOffset>::max();
+    }
+
+    //Offsets have changed, look through the watchlists. Only two of the
+    //literals are watched, but we don't know which ones
+    for(uint32_t i = 0; i < cand.origSize; i++) {
+        const Lit lit = origLits[cand.origStart + i];
+        const vec<Watched>& ws = solver->watches[lit.toInt()];
+        for(vec<Watched>::const_iterator
+            it = ws.begin(), end = ws.end()
+            ; it != end
+            ; it++
+        ) {
+            if (it->isClause()
+                && sameClause(it->getOffset(), cand)
+            ) {
+                return it->getOffset();
+            }
+        }
+    }
+
+    return std::numeric_limits<ClOffset>::max();
+}
+
+bool BgSimplifier::merge()
+{
+    assert(thread == NULL);
+    assert(solver->ok);
+    assert(solver->decisionLevel() == 0);
+    const double myTime = cpuTime();
+
+    if (solver->solveStats.numSimplify != snapSimplify
+        || solver->varReplacer->getNumReplacedVars() != snapReplaced
+    ) {
+        runStats.numDiscarded++;
+        runStats.subsumed = 0;
+        runStats.vivified = 0;
+        runStats.litsRem = 0;
+        globalStats += runStats;
+        return true;
+    }
+
+    //The stats of the worker are replaced with what was actually merged
+    runStats.numMerged++;
+    runStats.subsumed = 0;
+    runStats.vivified = 0;
+    runStats.litsRem = 0;
+    size_t numRemoved = 0;
+    for(size_t at = 0; at < candidates.size() && solver->ok; at++) {
+        const Candidate& cand = candidates[at];
+        if (!cand.subsumed && !cand.vivified)
+            continue;
+
+        const Lit* const orig = &origLits[cand.origStart];
+        for(uint32_t i = 0; i < cand.origSize; i++) {
+            solver->seen[orig[i].toInt()] = 1;
+        }
+        const ClOffset offset = findClause(cand);
+        for(uint32_t i = 0; i < cand.origSize; i++) {
+            solver->seen[orig[i].toInt()] = 0;
+        }
+
+        if (offset == std::numeric_limits<ClOffset>::max()) {
+            runStats.notFound++;
+            continue;
+        }
+
+        if (cand.subsumed) {
+            runStats.subsumed++;
+        } else {
+            //Add the new clause first, so the proof stays valid
+            const SnapClause& cl = clauses[numBackground + at];
+            tmpLits.assign(lits.begin() + cl.start, lits.begin() + cl.start + cl.size);
+            const ClauseStats stats = solver->clAllocator->getPointer(offset)->stats;
+            Clause* newCl = solver->addClauseInt(tmpLits, true, stats);
+            if (newCl != NULL) {
+                solver->longRedCls.push_back(solver->clAllocator->getOffset(newCl));
+            }
+            runStats.vivified++;
+            runStats.litsRem += cand.origSize - cl.size;
+            if (cl.size == 1)
+                runStats.units++;
+        }
+
+        //Removed from longRedCls below, by its freed flag
+        solver->detachClause(offset);
+        solver->clAllocator->clauseFree(offset);
+        numRemoved++;
+    }
+
+    if (numRemoved > 0) {
+        vector<ClOffset>& cls = solver->longRedCls;
+        size_t j = 0;
+        for(size_t i = 0; i < cls.size(); i++) {
+            if (!solver->clAllocator->getPointer(cls[i])->freed())
+                cls[j++] = cls[i];
+        }
+        cls.resize(j);
+    }
+
+    runStats.mergeTime = cpuTime() - myTime;
+    if (solver->conf.verbosity >= 2) {
+        cout
+        << "c [bgsimp] cands: " << runStats.candidates
+        << " subsumed: " << runStats.subsumed
+        << " vivified: " << runStats.vivified
+        << " lits-rem: " << runStats.litsRem
+        << " not found: " << runStats.notFound
+        << " bg T: " << std::fixed << std::setprecision(2) << runStats.workTime
+        << " merge T: " << std::fixed << std::setprecision(2) << runStats.mergeTime
+        << endl;
+    }
+    globalStats += runStats;
+
+    return solver->ok;
+}
+
+BgSimplifier::Stats& BgSimplifier::Stats::operator+=(const Stats& other)
+{
+    numJobs += other.numJobs;
+    numMerged += other.numMerged;
+    numDiscarded += other.numDiscarded;
+    candidates += other.candidates;
+    notFound += other.notFound;
+    subsumed += other.subsumed;
+    vivified += other.vivified;
+    litsRem += other.litsRem;
+    units += other.units;
+    workTime += other.workTime;
+    snapshotTime += other.snapshotTime;
+    mergeTime += other.mergeTime;
+
+    return *this;
+}
+
+void BgSimplifier::Stats::print() const
+{
+    cout << "c -------- BACKGROUND SIMPLIFIER STATS ----------" << endl;
+    printStatsLine("c jobs"
+        , numJobs
+        , numDiscarded
+        , "discarded"
+    );
+    printStatsLine("c candidates"
+        , candidates
+        , notFound
+        , "not found at merge"
+    );
+    printStatsLine("c subsumed"
+        , subsumed
+        , (double)subsumed/(double)candidates*100.0
+        , "% of candidates"
+    );
+    printStatsLine("c vivified"
+        , vivified
+        , (double)vivified/(double)candidates*100.0
+        , "% of candidates"
+    );
+    printStatsLine("c lits removed"
+        , litsRem
+        , units
+        , "units"
+    );
+    printStatsLine("c background time"
+        , workTime
+        , "s"
+    );
+    printStatsLine("c snapshot+merge time"
+        , snapshotTime + mergeTime
+        , "s"
+    );
+    cout << "c -------- BACKGROUND SIMPLIFIER STATS END ----------" << endl;
+}
@@ -0,0 +1,229 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos and collaborators. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#ifndef __BGSIMPLIFIER_H__
+#define __BGSIMPLIFIER_H__
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include "solvertypes.h"
+#include "clause.h"
+#include "propby.h"
+
+namespace CMSat {
+using std::vector;
+
+class Solver;
+
+/**
+@brief Vivifies and subsumes the new learnt clauses on a background thread
+
+At a restart, start() takes a snapshot of the clause database at level 0: the
+irredundant long clauses and all binary&tertiary clauses as the background, and
+the long learnt clauses with low glue added since the previous job as the
+candidates. The worker thread then only touches the snapshot: it removes the
+candidates subsumed by another snapshot clause with the subset check of the
+Simplifier, and vivifies the remaining ones with ClauseVivifier::vivifyLits()
+over its own propagation of the background clauses.
+
+The results are merged by the search thread at a later restart. A candidate is
+found through its offset, or if memory has been consolidated since, by its
+literals in the watchlists. Candidates removed or changed by the solver in the
+meantime are simply skipped. If variables have been
+replaced or a simplification round has run since the snapshot, the results are
+thrown away: the background clauses they were derived from may not exist
+anymore, which would break the DRUP proof.
+*/
+class BgSimplifier
+{
+    public:
+        BgSimplifier(Solver* solver);
+        ~BgSimplifier();
+
+        ///Merge the results if the job is done, then start a new job if due
+        bool mergeAndStart();
+
+        ///Stop the job early and merge what it has done, before simplifyProblem()
+        bool finish();
+
+        struct Stats
+        {
+            Stats() :
+                numJobs(0)
+                , numMerged(0)
+                , numDiscarded(0)
+                , candidates(0)
+                , notFound(0)
+                , subsumed(0)
+                , vivified(0)
+                , litsRem(0)
+                , units(0)
+                , workTime(0)
+                , snapshotTime(0)
+                , mergeTime(0)
+            {}
+
+            Stats& operator+=(const Stats& other);
+            void print() const;
+
+            uint64_t numJobs;
+            uint64_t numMerged;
+            uint64_t numDiscarded;
+            uint64_t candidates;
+            uint64_t notFound; ///<Removed or changed by the solver by merge time
+            uint64_t subsumed;
+            uint64_t vivified;
+            uint64_t litsRem;
+            uint64_t units;
+            double   workTime; ///<CPU time of the worker thread
+            double   snapshotTime;
+            double   mergeTime;
+        };
+
+        const Stats& getStats() const;
+
+    private:
+        friend class ClauseVivifier;
+        Solver* solver;
+
+        ///Clause of the snapshot, its literals at lits[start..start+size)
+        struct SnapClause
+        {
+            SnapClause(const uint32_t _start, const uint32_t _size) :
+                start(_start)
+                , size(_size)
+            {}
+
+            uint32_t start;
+            uint32_t size;
+        };
+
+        ///Literals of a snapshot clause, for the templates that take a clause
+        struct SnapLits
+        {
+            SnapLits(const Lit* _begin, const uint32_t _num) :
+                begin(_begin)
+                , num(_num)
+            {}
+
+            uint32_t size() const
+            {
+                return num;
+            }
+
+            const Lit& operator[](const uint32_t at) const
+            {
+                return begin[at];
+            }
+
+            const Lit* begin;
+            uint32_t num;
+        };
+        SnapLits getLits(const size_t index) const;
+
+        struct Candidate
+        {
+            Candidate(
+                const ClOffset _offset
+                , const uint32_t _origStart
+                , const uint32_t _origSize
+            ) :
+                offset(_offset)
+                , origStart(_origStart)
+                , origSize(_origSize)
+                , subsumed(false)
+                , vivified(false)
+            {}
+
+            ClOffset offset; ///<Only valid if memory has not been consolidated since
+            uint32_t origStart; ///<Literals as in the solver, in origLits
+            uint32_t origSize;
+            bool subsumed;
+            bool vivified;
+        };
+
+        void start();
+        void takeSnapshot();
+        bool addSnapClause(const Lit* begin, const Lit* end);
+        bool merge();
+        void stopThread();
+        ClOffset findClause(const Candidate& cand);
+        bool sameClause(const ClOffset offset, const Candidate& cand) const;
+
+        //Worker thread
+        void work();
+        void subsume();
+        void vivify();
+        void vivifyCandidate(const size_t at);
+        PropBy propagate();
+        void enqueue(const Lit lit);
+        void cancel();
+        lbool value(const Lit lit) const
+        {
+            return assigns[lit.var()] ^ lit.sign();
+        }
+
+        //Snapshot. Background clauses first, candidates at the end
+        vector<Lit> lits;
+        vector<SnapClause> clauses;
+        size_t numBackground;
+        vector<Lit> origLits;
+        vector<Candidate> candidates;
+        size_t numVars;
+        uint64_t snapSimplify;
+        size_t snapReplaced;
+        uint64_t snapConsolidated;
+        uint64_t lastSnapConfl;
+        uint64_t nextStartConfl;
+
+        //Worker state
+        vector<lbool> assigns;
+        vector<Lit> trail;
+        size_t qhead;
+        vector<vector<uint32_t> > watches; ///<Background clauses, by watched literal
+        vector<Lit> vivLits;
+        vector<Lit> uselessLits;
+        uint64_t steps;
+        uint64_t maxSteps;
+        std::atomic<bool> abort;
+        std::atomic<bool> done;
+        std::thread* thread;
+
+        //Results of the worker are in the candidates and runStats
+        vector<Lit> tmpLits;
+        Stats runStats;
+        Stats globalStats;
+};
+
+inline const BgSimplifier::Stats& BgSimplifier::getStats() const
+{
+    return globalStats;
+}
+
+inline BgSimplifier::SnapLits BgSimplifier::getLits(const size_t index) const
+{
+    return SnapLits(&lits[clauses[index].start], clauses[index].size);
+}
+
+} //end namespace
+
+#endif //__BGSIMPLIFIER_H__
@@ -0,0 +1,617 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos and collaborators. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#include "bva.h"
+#include "simplifier.h"
+#include "solver.h"
+#include "clabstraction.h"
+#include "time_mem.h"
+#include <iomanip>
+#include <limits>
+
+using namespace CMSat;
+
+BVA::BVA(Simplifier* _simplifier, Solver* _solver) :
+    simplifier(_simplifier)
+    , solver(_solver)
+    , seen(_simplifier->seen)
+    , seen2(_simplifier->seen2)
+{
+}
+
+bool BVA::bva()
+{
+    assert(solver->okay());
+    runStats.clear();
+
+    //The clauses added are not RUP, so they cannot be part of a DRUP proof
+    #ifdef DRUP
+    if (solver->drup) {
+        return solver->okay();
+    }
+    #endif
+
+    const double myTime = cpuTime();
+    runStats.numCalls = 1;
+    simplifier->toDecrease = &simplifier->numMaxBVA;
+
+    litCount.clear();
+    litCount.resize(solver->nVarsReal()*2, 0);
+    markBlockedOn();
+
+    while(!litQueue.empty()) {
+        litQueue.pop();
+    }
+    for(size_t i = 0; i < solver->nVars()*2; i++) {
+        pushLit(Lit::toLit(i));
+    }
+
+    while(!litQueue.empty()
+        && *simplifier->toDecrease > 0
+    ) {
+        const std::pair<uint32_t, uint32_t> top = litQueue.top();
+        litQueue.pop();
+        const Lit lit = Lit::toLit(top.second);
+        if (!litOK(lit))
+            continue;
+
+        //Number of occurrences changed since it was queued
+        if (numIrredOcc(lit) != top.first) {
+            pushLit(lit);
+            continue;
+        }
+
+        tryLit(lit);
+    }
+    if (*simplifier->toDecrease <= 0) {
+        runStats.timeOut++;
+    }
+
+    runStats.cpu_time = cpuTime() - myTime;
+    if (solver->conf.verbosity >= 1) {
+        runStats.printShort();
+    }
+    globalStats += runStats;
+
+    return solver->okay();
+}
+
+/**
+@brief Marks the variables that still have clauses blocked on them
+
+When the model is extended, such a variable may be flipped to satisfy a blocked
+clause. This is only safe because the clauses containing its negation all
+resolve to a tautology with the blocked clause -- which would not be true for
+the (x v C) clauses replacing them. So BVA must not touch these variables.
+*/
+void BVA::markBlockedOn()
+{
+    blockedOn.clear();
+    blockedOn.resize(solver->nVarsReal(), 0);
+    for(vector<BlockedClause>::const_iterator
+        it = simplifier->blockedClauses.begin(), end = simplifier->blockedClauses.end()
+        ; it != end
+        ; it++
+    ) {
+        const Var var = getUpdatedVar(it->blockedOn.var(), solver->outerToInterMain);
+        if (!simplifier->var_elimed[var]) {
+            blockedOn[var] = 1;
+        }
+    }
+}
+
+bool BVA::litOK(const Lit lit) const
+{
+    return solver->value(lit) == l_Undef
+        && solver->varData[lit.var()].removed == Removed::none
+        && !blockedOn[lit.var()];
+}
+
+bool BVA::clauseOK(const OccurCl& cl)
+{
+    getLits(cl, tmpLits);
+    for(vector<Lit>::const_iterator
+        it = tmpLits.begin(), end = tmpLits.end()
+        ; it != end
+        ; it++
+    ) {
+        if (!litOK(*it))
+            return false;
+    }
+
+    return true;
+}
+
+void BVA::pushLit(const Lit lit)
+{
+    if (!litOK(lit))
+        return;
+
+    //Fewer than 3 occurrences can never give any reduction
+    const uint32_t num = numIrredOcc(lit);
+    if (num >= 3) {
+        litQueue.push(std::make_pair(num, lit.toInt()));
+    }
+}
+
+bool BVA::isIrred(const Watched& ws) const
+{
+    if (ws.isBinary() || ws.isTri())
+        return !ws.learnt();
+
+    assert(ws.isClause());
+    const Clause& cl = *solver->clAllocator->getPointer(ws.getOffset());
+    return !cl.learnt();
+}
+
+uint32_t BVA::numIrredOcc(const Lit lit)
+{
+    const vec<Watched>& ws = solver->watches[lit.toInt()];
+    *simplifier->toDecrease -= ws.size() + 10;
+
+    uint32_t num = 0;
+    for(vec<Watched>::const_iterator
+        it = ws.begin(), end = ws.end()
+        ; it != end
+        ; it++
+    ) {
+        num += isIrred(*it);
+    }
+
+    return num;
+}
+
+void BVA::getLits(const OccurCl& cl, vector<Lit>& lits) const
+{
+    lits.clear();
+    if (cl.ws.isBinary()) {
+        lits.push_back(cl.lit);
+        lits.push_back(cl.ws.lit1());
+    } else if (cl.ws.isTri()) {
+        lits.push_back(cl.lit);
+        lits.push_back(cl.ws.lit1());
+        lits.push_back(cl.ws.lit2());
+    } else {
+        const Clause& c = *solver->clAllocator->getPointer(cl.ws.getOffset());
+        lits.insert(lits.end(), c.begin(), c.end());
+    }
+}
+
+int64_t BVA::reduction(const size_t numLits, const size_t numCls) const
+{
+    return (int64_t)(numLits*numCls) - (int64_t)numLits - (int64_t)numCls;
+}
+
+void BVA::tryLit(const Lit lit)
+{
+    runStats.triedLits++;
+    mLits.clear();
+    mLits.push_back(lit);
+    mCls.clear();
+    mClsMatched.clear();
+
+    const vec<Watched>& ws = solver->watches[lit.toInt()];
+    *simplifier->toDecrease -= ws.size();
+    for(vec<Watched>::const_iterator
+        it = ws.begin(), end = ws.end()
+        ; it != end
+        ; it++
+    ) {
+        if (isIrred(*it)
+            && clauseOK(OccurCl(lit, *it))
+        ) {
+            mCls.push_back(OccurCl(lit, *it));
+            mClsMatched.push_back(vector<OccurCl>());
+        }
+    }
+
+    //Grow L one literal at a time, as long as the reduction grows
+    while(*simplifier->toDecrease > 0) {
+        findMatches(lit);
+
+        //The l' that matched the most clauses
+        Lit best = lit_Undef;
+        uint32_t bestNum = 0;
+        for(vector<Lit>::const_iterator
+            it = countedLits.begin(), end = countedLits.end()
+            ; it != end
+            ; it++
+        ) {
+            if (litCount[it->toInt()] > bestNum) {
+                best = *it;
+                bestNum = litCount[it->toInt()];
+            }
+            litCount[it->toInt()] = 0;
+        }
+        countedLits.clear();
+
+        if (best == lit_Undef
+            || reduction(mLits.size()+1, bestNum) <= reduction(mLits.size(), mCls.size())
+        ) {
+            break;
+        }
+
+        //Only keep the clauses in M for which (best v C) exists
+        vector<OccurCl> newMCls;
+        vector<vector<OccurCl> > newMClsMatched;
+        for(vector<Match>::const_iterator
+            it = matches.begin(), end = matches.end()
+            ; it != end
+            ; it++
+        ) {
+            if (it->lit != best)
+                continue;
+
+            newMCls.push_back(mCls[it->at]);
+            newMClsMatched.push_back(mClsMatched[it->at]);
+            newMClsMatched.back().push_back(it->cl);
+        }
+        mLits.push_back(best);
+        mCls.swap(newMCls);
+        mClsMatched.swap(newMClsMatched);
+    }
+
+    if (mLits.size() > 1
+        && reduction(mLits.size(), mCls.size()) > 0
+    ) {
+        replace(lit);
+    }
+}
+
+/**
+@brief Finds all (l' v C) for all (l v C) in M, counts the l'-s in litCount
+
+The candidates for (l' v C) are looked for in the occurrence list of the
+literal of C that has the shortest one.
+*/
+void BVA::findMatches(const Lit lit)
+{
+    matches.clear();
+    for(vector<Lit>::const_iterator
+        it = mLits.begin(), end = mLits.end()
+        ; it != end
+        ; it++
+    ) {
+        seen2[it->toInt()] = 1;
+    }
+
+    vector<Lit> found;
+    for(size_t at = 0; at < mCls.size(); at++) {
+        getLits(mCls[at], tmpLits);
+        *simplifier->toDecrease -= tmpLits.size();
+
+        //Mark C, find its literal with the shortest occurrence list
+        Lit minLit = lit_Undef;
+        size_t minSize = std::numeric_limits<size_t>::max();
+        CL_ABST_TYPE abst = 0;
+        for(vector<Lit>::const_iterator
+            it = tmpLits.begin(), end = tmpLits.end()
+            ; it != end
+            ; it++
+        ) {
+            if (*it == lit)
+                continue;
+
+            seen[it->toInt()] = 1;
+            abst |= abst_var(it->var());
+            const size_t size = solver->watches[it->toInt()].size();
+            if (size < minSize) {
+                minLit = *it;
+                minSize = size;
+            }
+        }
+        assert(minLit != lit_Undef);
+
+        const vec<Watched>& ws = solver->watches[minLit.toInt()];
+        *simplifier->toDecrease -= ws.size();
+        for(vec<Watched>::const_iterator
+            it = ws.begin(), end = ws.end()
+            ; it != end
+            ; it++
+        ) {
+            //Must be the same size, and must contain C
+            if (it->isBinary() != (tmpLits.size() == 2)
+                || it->isTri() != (tmpLits.size() == 3)
+                || (it->isClause() && !simplifier->subsetAbst(abst, it->getAbst()))
+                || !isIrred(*it)
+            ) {
+                continue;
+            }
+
+            const OccurCl cl(minLit, *it);
+            getLits(cl, tmpLits2);
+            *simplifier->toDecrease -= tmpLits2.size();
+            if (tmpLits2.size() != tmpLits.size())
+                continue;
+
+            Lit other = lit_Undef;
+            for(vector<Lit>::const_iterator
+                it2 = tmpLits2.begin(), end2 = tmpLits2.end()
+                ; it2 != end2
+                ; it2++
+            ) {
+                if (!seen[it2->toInt()]) {
+                    if (other != lit_Undef) {
+                        other = lit_Error;
+                        break;
+                    }
+                    other = *it2;
+                }
+            }
+
+            //Already in L, or already found for this clause
+            if (other == lit_Undef
+                || other == lit_Error
+                || other == ~lit
+                || seen2[other.toInt()]
+                || !litOK(other)
+            ) {
+                continue;
+            }
+
+            seen2[other.toInt()] = 1;
+            found.push_back(other);
+            matches.push_back(Match(other, at, cl));
+            if (litCount[other.toInt()] == 0) {
+                countedLits.push_back(other);
+            }
+            litCount[other.toInt()]++;
+        }
+
+        //Clear
+        for(vector<Lit>::const_iterator
+            it = tmpLits.begin(), end = tmpLits.end()
+            ; it != end
+            ; it++
+        ) {
+            seen[it->toInt()] = 0;
+        }
+        for(vector<Lit>::const_iterator
+            it = found.begin(), end = found.end()
+            ; it != end
+            ; it++
+        ) {
+            seen2[it->toInt()] = 0;
+        }
+        found.clear();
+    }
+
+    for(vector<Lit>::const_iterator
+        it = mLits.begin(), end = mLits.end()
+        ; it != end
+        ; it++
+    ) {
+        seen2[it->toInt()] = 0;
+    }
+}
+
+void BVA::replace(const Lit lit)
+{
+    const Var newVar = solver->newVarInt();
+    solver->numBVAVars++;
+    litCount.resize(solver->nVarsReal()*2, 0);
+    blockedOn.resize(solver->nVarsReal(), 0);
+    const Lit newLit = Lit(newVar, false);
+
+    if (solver->conf.verbosity >= 6) {
+        cout
+        << "c [bva] replacing " << mLits.size() << "x" << mCls.size()
+        << " clauses on lits " << mLits
+        << " with new var " << newVar + 1
+        << endl;
+    }
+
+    //(~x v l') for every l' in L
+    newCls.clear();
+    for(vector<Lit>::const_iterator
+        it = mLits.begin(), end = mLits.end()
+        ; it != end
+        ; it++
+    ) {
+        tmpLits.clear();
+        tmpLits.push_back(~newLit);
+        tmpLits.push_back(*it);
+        newCls.push_back(tmpLits);
+    }
+
+    //(x v C) for every (l v C) in M, and remove all (l' v C)
+    implicitToRem.clear();
+    longToRem.clear();
+    for(size_t at = 0; at < mCls.size(); at++) {
+        getLits(mCls[at], tmpLits);
+        for(vector<Lit>::iterator
+            it = tmpLits.begin(), end = tmpLits.end()
+            ; it != end
+            ; it++
+        ) {
+            if (*it == lit)
+                *it = newLit;
+        }
+        newCls.push_back(tmpLits);
+
+        removeOccurCl(mCls[at]);
+        for(vector<OccurCl>::const_iterator
+            it = mClsMatched[at].begin(), end = mClsMatched[at].end()
+            ; it != end
+            ; it++
+        ) {
+            removeOccurCl(*it);
+        }
+    }
+
+    removeOldClauses();
+    addNewClauses(newLit);
+    runStats.newVars++;
+
+    //Their occurrences have changed, they may be good for another round
+    pushLit(lit);
+    pushLit(newLit);
+    pushLit(~newLit);
+}
+
+void BVA::removeOccurCl(const OccurCl& cl)
+{
+    if (cl.ws.isClause()) {
+        longToRem.push_back(cl.ws.getOffset());
+    } else {
+        getLits(cl, tmpLits2);
+        std::sort(tmpLits2.begin(), tmpLits2.end());
+        implicitToRem.push_back(tmpLits2);
+    }
+}
+
+void BVA::removeOldClauses()
+{
+    //Duplicate clauses may have matched more than once
+    std::sort(implicitToRem.begin(), implicitToRem.end());
+    implicitToRem.erase(
+        std::unique(implicitToRem.begin(), implicitToRem.end())
+        , implicitToRem.end()
+    );
+    std::sort(longToRem.begin(), longToRem.end());
+    longToRem.erase(
+        std::unique(longToRem.begin(), longToRem.end())
+        , longToRem.end()
+    );
+
+    for(vector<vector<Lit> >::const_iterator
+        it = implicitToRem.begin(), end = implicitToRem.end()
+        ; it != end
+        ; it++
+    ) {
+        const vector<Lit>& lits = *it;
+        *simplifier->toDecrease -= solver->watches[lits[0].toInt()].size();
+        *simplifier->toDecrease -= solver->watches[lits[1].toInt()].size();
+        if (lits.size() == 2) {
+            solver->detachBinClause(lits[0], lits[1], false);
+        } else {
+            *simplifier->toDecrease -= solver->watches[lits[2].toInt()].size();
+            solver->detachTriClause(lits[0], lits[1], lits[2], false);
+        }
+        runStats.clRemoved++;
+        runStats.litsRemoved += lits.size();
+    }
+
+    for(vector<ClOffset>::const_iterator
+        it = longToRem.begin(), end = longToRem.end()
+        ; it != end
+        ; it++
+    ) {
+        const Clause& cl = *solver->clAllocator->getPointer(*it);
+        runStats.clRemoved++;
+        runStats.litsRemoved += cl.size();
+        simplifier->unlinkClause(*it, false);
+    }
+}
+
+void BVA::addNewClauses(const Lit newLit)
+{
+    std::sort(newCls.begin(), newCls.end());
+    newCls.erase(std::unique(newCls.begin(), newCls.end()), newCls.end());
+
+    for(vector<vector<Lit> >::const_iterator
+        it = newCls.begin(), end = newCls.end()
+        ; it != end
+        ; it++
+    ) {
+        Clause* newCl = solver->addClauseInt(
+            *it //Literals in new clause
+            , false //Is the new clause learnt?
+            , ClauseStats() //Statistics for this new clause
+            , false //Should clause be attached?
+        );
+        assert(solver->okay());
+
+        if (newCl != NULL) {
+            simplifier->linkInClause(*newCl);
+            simplifier->clauses.push_back(solver->clAllocator->getOffset(newCl));
+        }
+        runStats.clAdded++;
+        runStats.litsAdded += it->size();
+    }
+    simplifier->touched.touch(newLit);
+}
+
+BVA::Stats& BVA::Stats::operator+=(const Stats& other)
+{
+    numCalls += other.numCalls;
+    triedLits += other.triedLits;
+    newVars += other.newVars;
+    clRemoved += other.clRemoved;
+    clAdded += other.clAdded;
+    litsRemoved += other.litsRemoved;
+    litsAdded += other.litsAdded;
+    timeOut += other.timeOut;
+    cpu_time += other.cpu_time;
+
+    return *this;
+}
+
+void BVA::Stats::printShort() const
+{
+    cout
+    << "c [bva]"
+    << " tried: " << triedLits
+    << " new vars: " << newVars
+    << " cl-rem: " << clRemoved
+    << " cl-add: " << clAdded
+    << " lits-rem: " << ((int64_t)litsRemoved - (int64_t)litsAdded)
+    << " T: " << std::fixed << std::setprecision(2) << cpu_time
+    << " T-out: " << (timeOut ? "Y" : "N")
+    << endl;
+}
+
+void BVA::Stats::print() const
+{
+    cout << "c -------- BVA STATS ----------" << endl;
+    printStatsLine("c time"
+        , cpu_time
+        , cpu_time/(double)numCalls
+        , "per call"
+    );
+
+    printStatsLine("c timed out"
+        , timeOut
+        , (double)timeOut/(double)numCalls*100.0
+        , "% of calls"
+    );
+
+    printStatsLine("c lits tried"
+        , triedLits
+    );
+
+    printStatsLine("c new vars"
+        , newVars
+    );
+
+    printStatsLine("c cl removed"
+        , clRemoved
+        , clAdded
+        , "added"
+    );
+
+    printStatsLine("c lits removed"
+        , litsRemoved
+        , litsAdded
+        , "added"
+    );
+    cout << "c -------- BVA STATS END ----------" << endl;
+}
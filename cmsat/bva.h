@@ -0,0 +1,186 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos and collaborators. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#ifndef __BVA_H__
+#define __BVA_H__
+
+#include <vector>
+#include <queue>
+#include <iostream>
+#include "solvertypes.h"
+#include "watched.h"
+
+namespace CMSat {
+using std::vector;
+using std::cout;
+using std::endl;
+
+class Solver;
+class Simplifier;
+
+/**
+@brief Bounded variable addition, as per Manthey, Heule and Biere
+
+Looks for a set of literals L and a set of clauses M, all containing literal
+'l', such that for every literal l' in L and every clause (l v C) in M, the
+clause (l' v C) is also in the irreducible clauses. These |L|*|M| clauses are
+replaced with (~x v l') for every l' in L and (x v C) for every (l v C) in M,
+where 'x' is a new variable. This is only done if it reduces the number of
+clauses, which is mostly the case for the pairwise at-most-one and similar
+encodings.
+
+The new formula is satisfiable exactly when the old one was, and every model
+of it is a model of the old one when 'x' is ignored: no model reconstruction
+is needed, the added variables are simply left out of the model given back
+to the user. They take the next outer variable numbers, but are not part of
+the numbering of the user (see Solver::outsideToOuter), so the user can still
+add variables, and cannot use the ones added by BVA.
+
+Works on the occurrence lists of Simplifier, only looks at the irreducible
+clauses, and leaves alone the variables that have clauses blocked on them.
+The clauses it adds are not implied by the ones it removes, so it is switched
+off when a DRUP proof is being written.
+*/
+class BVA
+{
+    public:
+        BVA(Simplifier* simplifier, Solver* solver);
+
+        ///Returns FALSE if UNSAT has been found
+        bool bva();
+
+        struct Stats
+        {
+            Stats() :
+                numCalls(0)
+                , triedLits(0)
+                , newVars(0)
+                , clRemoved(0)
+                , clAdded(0)
+                , litsRemoved(0)
+                , litsAdded(0)
+                , timeOut(0)
+                , cpu_time(0)
+            {}
+
+            void clear()
+            {
+                Stats tmp;
+                *this = tmp;
+            }
+
+            Stats& operator+=(const Stats& other);
+            void print() const;
+            void printShort() const;
+
+            uint64_t numCalls;
+            uint64_t triedLits;
+            uint64_t newVars;
+            uint64_t clRemoved;
+            uint64_t clAdded;
+            uint64_t litsRemoved;
+            uint64_t litsAdded;
+            uint64_t timeOut;
+            double   cpu_time;
+        };
+
+        const Stats& getStats() const;
+
+    private:
+        Simplifier* simplifier;
+        Solver* solver;
+
+        ///An irreducible clause, as it is in the occurrence list of 'lit'
+        struct OccurCl
+        {
+            OccurCl(const Lit _lit, const Watched& _ws) :
+                lit(_lit)
+                , ws(_ws)
+            {}
+
+            Lit lit;
+            Watched ws;
+        };
+
+        ///Clause (l' v C) found for clause (l v C)
+        struct Match
+        {
+            Match(const Lit _lit, const size_t _at, const OccurCl& _cl) :
+                lit(_lit)
+                , at(_at)
+                , cl(_cl)
+            {}
+
+            Lit lit; ///<l'
+            size_t at; ///<Index of (l v C) in mCls
+            OccurCl cl; ///<(l' v C)
+        };
+
+        void tryLit(const Lit lit);
+        void findMatches(const Lit lit);
+        void replace(const Lit lit);
+        void addNewClauses(const Lit newLit);
+        void removeOldClauses();
+        void removeOccurCl(const OccurCl& cl);
+        bool isIrred(const Watched& ws) const;
+        void getLits(const OccurCl& cl, vector<Lit>& lits) const;
+        uint32_t numIrredOcc(const Lit lit);
+        void markBlockedOn();
+        bool litOK(const Lit lit) const;
+        bool clauseOK(const OccurCl& cl);
+        void pushLit(const Lit lit);
+        int64_t reduction(const size_t numLits, const size_t numCls) const;
+
+        //Current literal set L and clause set M, with the clauses
+        //(l' v C) found for each clause in M
+        vector<Lit> mLits;
+        vector<OccurCl> mCls;
+        vector<vector<OccurCl> > mClsMatched;
+        vector<Match> matches;
+
+        //Literals to try, most occurring first
+        std::priority_queue<std::pair<uint32_t, uint32_t> > litQueue;
+
+        //Temporaries
+        vector<unsigned char>& seen;
+        vector<unsigned char>& seen2;
+        vector<uint32_t> litCount;
+        vector<char> blockedOn;
+        vector<Lit> countedLits;
+        vector<Lit> tmpLits;
+        vector<Lit> tmpLits2;
+        vector<vector<Lit> > newCls;
+        vector<vector<Lit> > implicitToRem;
+        vector<ClOffset> longToRem;
+
+        //Stats
+        Stats runStats;
+        Stats globalStats;
+};
+
+inline const BVA::Stats& BVA::getStats() const
+{
+    return globalStats;
+}
+
+} //end namespace
+
+#endif //__BVA_H__
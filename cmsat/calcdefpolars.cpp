@@ -93,7 +93,7 @@ void CalcDefPolars::tallyVotesBinTri(const vector<vec<Watched> >& watches)
             if (it2->isTri()
                 && lit.toInt() < it2->lit1().toInt()
                 && it2->lit1().toInt() < it2->lit2().toInt()
-                && it2->learnt()
+                && !it2->learnt()
             ) {
                 if (lit.sign()) votes[lit.var()] += 0.3;
                 else votes[lit.var()] -= 0.3;
@@ -0,0 +1,377 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos and collaborators. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#include "cardfinder.h"
+#include "solver.h"
+#include "time_mem.h"
+#include <iomanip>
+#include <algorithm>
+
+using namespace CMSat;
+using std::cout;
+using std::endl;
+
+CardFinder::CardFinder(Solver* _solver) :
+    solver(_solver)
+    , timeLeft(0)
+    , origOtfHyperbin(false)
+{
+}
+
+uint32_t CardFinder::numIrredBins(const Lit lit)
+{
+    const vec<Watched>& ws = solver->watches[(~lit).toInt()];
+    timeLeft -= ws.size();
+
+    uint32_t num = 0;
+    for(vec<Watched>::const_iterator
+        it = ws.begin(), end = ws.end()
+        ; it != end
+        ; it++
+    ) {
+        if (it->isBinary()
+            && !it->learnt()
+            && solver->value(it->lit1()) == l_Undef
+        ) {
+            num++;
+        }
+    }
+
+    return num;
+}
+
+void CardFinder::findAndAttach()
+{
+    assert(solver->cards.empty());
+    assert(solver->decisionLevel() == 0);
+    if (!solver->conf.doCardFind
+        || !solver->okay()
+    ) {
+        return;
+    }
+
+    const double myTime = cpuTime();
+    runStats.clear();
+    runStats.numCalls = 1;
+    timeLeft = solver->conf.cardFindLimitM*1000LL*1000LL;
+
+    //These are all-zero between calls, only their size may need changing
+    const size_t numLits = solver->nVars()*2;
+    numAdjacent.resize(numLits, 0);
+    inCandidates.resize(numLits, 0);
+    counted.resize(numLits, 0);
+
+    //Literals that could be in a large enough constraint, most connected first
+    degree.clear();
+    degree.resize(numLits, 0);
+    litsToTry.clear();
+    for(size_t i = 0; i < numLits; i++) {
+        const Lit lit = Lit::toLit(i);
+        if (solver->value(lit) != l_Undef)
+            continue;
+
+        degree[i] = numIrredBins(lit);
+        if (degree[i] + 1 >= solver->conf.cardMinSize)
+            litsToTry.push_back(lit);
+    }
+    std::sort(litsToTry.begin(), litsToTry.end(), DegreeSorter(degree));
+
+    for(vector<Lit>::const_iterator
+        it = litsToTry.begin(), end = litsToTry.end()
+        ; it != end
+        ; it++
+    ) {
+        if (timeLeft < 0) {
+            runStats.timeOut++;
+            break;
+        }
+
+        tryLit(*it);
+    }
+
+    if (!solver->cards.empty()) {
+        origOtfHyperbin = solver->conf.otfHyperbin;
+        solver->conf.otfHyperbin = false;
+        solver->needToAddBinClause.clear();
+        solver->uselessBin.clear();
+    }
+
+    runStats.cpu_time = cpuTime() - myTime;
+    if (solver->conf.verbosity >= 1) {
+        runStats.printShort();
+    }
+    globalStats += runStats;
+}
+
+/**
+@brief Builds a clique of at-most-one relations containing 'lit'
+
+The candidates are the literals 'other' with a binary clause (~lit V ~other).
+They are added in the order of their degree, if they are adjacent to all the
+literals added so far.
+*/
+void CardFinder::tryLit(const Lit lit)
+{
+    runStats.triedLits++;
+    members.clear();
+    candidates.clear();
+
+    const vec<Watched>& ws = solver->watches[(~lit).toInt()];
+    timeLeft -= ws.size();
+    for(vec<Watched>::const_iterator
+        it = ws.begin(), end = ws.end()
+        ; it != end
+        ; it++
+    ) {
+        if (!it->isBinary() || it->learnt())
+            continue;
+
+        const Lit other = ~it->lit1();
+        if (solver->value(other) != l_Undef
+            || inCandidates[other.toInt()]
+        ) {
+            continue;
+        }
+
+        inCandidates[other.toInt()] = 1;
+        numAdjacent[other.toInt()] = 1;
+        candidates.push_back(other);
+    }
+
+    if (candidates.size() + 1 >= solver->conf.cardMinSize) {
+        std::sort(candidates.begin(), candidates.end(), DegreeSorter(degree));
+        timeLeft -= candidates.size();
+
+        members.push_back(lit);
+        for(vector<Lit>::const_iterator
+            it = candidates.begin(), end = candidates.end()
+            ; it != end
+            ; it++
+        ) {
+            if (numAdjacent[it->toInt()] != members.size())
+                continue;
+
+            members.push_back(*it);
+
+            //Count each candidate adjacent to the new member only once, the
+            //binary clause may be there more than once
+            const vec<Watched>& ws2 = solver->watches[(~*it).toInt()];
+            timeLeft -= ws2.size();
+            for(vec<Watched>::const_iterator
+                it2 = ws2.begin(), end2 = ws2.end()
+                ; it2 != end2
+                ; it2++
+            ) {
+                if (!it2->isBinary() || it2->learnt())
+                    continue;
+
+                const Lit other = ~it2->lit1();
+                if (!inCandidates[other.toInt()]
+                    || counted[other.toInt()]
+                ) {
+                    continue;
+                }
+
+                counted[other.toInt()] = 1;
+                toClear.push_back(other);
+                numAdjacent[other.toInt()]++;
+            }
+
+            for(vector<Lit>::const_iterator
+                it2 = toClear.begin(), end2 = toClear.end()
+                ; it2 != end2
+                ; it2++
+            ) {
+                counted[it2->toInt()] = 0;
+            }
+            toClear.clear();
+        }
+    }
+
+    for(vector<Lit>::const_iterator
+        it = candidates.begin(), end = candidates.end()
+        ; it != end
+        ; it++
+    ) {
+        inCandidates[it->toInt()] = 0;
+        numAdjacent[it->toInt()] = 0;
+    }
+
+    if (members.size() >= solver->conf.cardMinSize) {
+        addCard();
+    }
+}
+
+/**
+@brief Replaces the binary clauses between the members with a constraint
+*/
+void CardFinder::addCard()
+{
+    const uint32_t num = solver->cards.size();
+    for(vector<Lit>::const_iterator
+        it = members.begin(), end = members.end()
+        ; it != end
+        ; it++
+    ) {
+        inCandidates[it->toInt()] = 1;
+    }
+
+    //Both watches of each binary clause are removed, duplicates included
+    uint64_t removed = 0;
+    for(vector<Lit>::const_iterator
+        it = members.begin(), end = members.end()
+        ; it != end
+        ; it++
+    ) {
+        vec<Watched>& ws = solver->watches[(~*it).toInt()];
+        timeLeft -= ws.size();
+
+        vec<Watched>::iterator i = ws.begin();
+        vec<Watched>::iterator j = i;
+        for(vec<Watched>::iterator end2 = ws.end(); i != end2; i++) {
+            if (i->isBinary()
+                && !i->learnt()
+                && inCandidates[(~i->lit1()).toInt()]
+            ) {
+                removed++;
+                continue;
+            }
+
+            *j++ = *i;
+        }
+        ws.shrink_(i-j);
+        ws.push(Watched(num, watch_card_t));
+    }
+
+    for(vector<Lit>::const_iterator
+        it = members.begin(), end = members.end()
+        ; it != end
+        ; it++
+    ) {
+        inCandidates[it->toInt()] = 0;
+    }
+
+    assert(removed % 2 == 0);
+    solver->binTri.irredBins -= removed/2;
+    solver->binTri.irredLits -= removed;
+    solver->cards.push_back(members);
+
+    runStats.numCards++;
+    runStats.cardLits += members.size();
+    runStats.binsRemoved += removed/2;
+}
+
+void CardFinder::detach()
+{
+    if (solver->cards.empty())
+        return;
+
+    for(vector<vector<Lit> >::const_iterator
+        it = solver->cards.begin(), end = solver->cards.end()
+        ; it != end
+        ; it++
+    ) {
+        const vector<Lit>& card = *it;
+
+        //A literal may be in more than one constraint, so remove all of them
+        for(size_t i = 0; i < card.size(); i++) {
+            vec<Watched>& ws = solver->watches[(~card[i]).toInt()];
+            vec<Watched>::iterator i2 = ws.begin();
+            vec<Watched>::iterator j2 = i2;
+            for(vec<Watched>::iterator end2 = ws.end(); i2 != end2; i2++) {
+                if (!i2->isCard())
+                    *j2++ = *i2;
+            }
+            ws.shrink_(i2-j2);
+        }
+
+        //Put back the binary clauses. Unlike in Solver::attachBinClause(),
+        //they are not counted as new, they were there before
+        for(size_t i = 0; i < card.size(); i++) {
+            for(size_t i2 = i+1; i2 < card.size(); i2++) {
+                solver->watches[(~card[i]).toInt()].push(Watched(~card[i2], false));
+                solver->watches[(~card[i2]).toInt()].push(Watched(~card[i], false));
+            }
+        }
+        solver->binTri.irredBins += card.size()*(card.size()-1)/2;
+        solver->binTri.irredLits += card.size()*(card.size()-1);
+    }
+    solver->cards.clear();
+    solver->conf.otfHyperbin = origOtfHyperbin;
+}
+
+CardFinder::Stats& CardFinder::Stats::operator+=(const Stats& other)
+{
+    numCalls += other.numCalls;
+    triedLits += other.triedLits;
+    numCards += other.numCards;
+    cardLits += other.cardLits;
+    binsRemoved += other.binsRemoved;
+    timeOut += other.timeOut;
+    cpu_time += other.cpu_time;
+
+    return *this;
+}
+
+void CardFinder::Stats::printShort() const
+{
+    cout
+    << "c [card]"
+    << " tried: " << triedLits
+    << " found: " << numCards
+    << " avg size: " << std::fixed << std::setprecision(1)
+    << ((double)cardLits/(double)std::max<uint64_t>(numCards, 1))
+    << " bins-rem: " << binsRemoved
+    << " T: " << std::fixed << std::setprecision(2) << cpu_time
+    << " T-out: " << (timeOut ? "Y" : "N")
+    << endl;
+}
+
+void CardFinder::Stats::print() const
+{
+    cout << "c -------- CARD STATS ----------" << endl;
+    printStatsLine("c time"
+        , cpu_time
+        , cpu_time/(double)numCalls
+        , "per call"
+    );
+
+    printStatsLine("c timed out"
+        , timeOut
+        , (double)timeOut/(double)numCalls*100.0
+        , "% of calls"
+    );
+
+    printStatsLine("c lits tried"
+        , triedLits
+    );
+
+    printStatsLine("c constraints found"
+        , numCards
+        , (double)cardLits/(double)numCards
+        , "avg size"
+    );
+
+    printStatsLine("c bins replaced"
+        , binsRemoved
+    );
+    cout << "c -------- CARD STATS END ----------" << endl;
+}
@@ -0,0 +1,146 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos and collaborators. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#ifndef __CARDFINDER_H__
+#define __CARDFINDER_H__
+
+#include <vector>
+#include <iostream>
+#include "solvertypes.h"
+
+namespace CMSat {
+using std::vector;
+
+class Solver;
+
+/**
+@brief Finds at-most-one constraints among the binary clauses, to propagate them natively
+
+An at-most-one constraint over literals l1..lk is encoded pairwise as the
+k*(k-1)/2 binary clauses (~li V ~lj). These are found as cliques in the graph
+whose edges are the irredundant binary clauses, greedily, starting from the
+literals with the most such binary clauses. The binary clauses of a clique
+are then replaced with a single entry in the watchlist of each ~li, pointing
+to the constraint in PropEngine::cards.
+
+Each literal set to FALSE by a constraint is explained by the binary clause
+between it and the TRUE literal of the constraint, so conflict analysis works
+on them as it would on the binary clauses, and DRUP proofs stay valid.
+
+The constraints are only attached for the search: detach() puts back the
+binary clauses before anything that needs all the clauses to be there, such as
+the simplifications, variable replacement, or extending the solution.
+On-the-fly hyper-binary resolution is switched off while they are attached:
+propagateFull() and the ancestors it needs do not know about them.
+*/
+class CardFinder
+{
+    public:
+        CardFinder(Solver* solver);
+
+        ///Find the constraints and attach them. Must be at decision level 0
+        void findAndAttach();
+
+        ///Put back the binary clauses of the constraints, if any are attached
+        void detach();
+
+        struct Stats
+        {
+            Stats() :
+                numCalls(0)
+                , triedLits(0)
+                , numCards(0)
+                , cardLits(0)
+                , binsRemoved(0)
+                , timeOut(0)
+                , cpu_time(0)
+            {}
+
+            void clear()
+            {
+                Stats tmp;
+                *this = tmp;
+            }
+
+            Stats& operator+=(const Stats& other);
+            void print() const;
+            void printShort() const;
+
+            uint64_t numCalls;
+            uint64_t triedLits;
+            uint64_t numCards;
+            uint64_t cardLits;
+            uint64_t binsRemoved;
+            uint64_t timeOut;
+            double   cpu_time;
+        };
+
+        const Stats& getStats() const;
+
+    private:
+        Solver* solver;
+
+        void tryLit(const Lit lit);
+        void addCard();
+        uint32_t numIrredBins(const Lit lit);
+
+        ///Orders literals by the number of irredundant binary clauses they are in
+        struct DegreeSorter
+        {
+            DegreeSorter(const vector<uint32_t>& _degree) :
+                degree(_degree)
+            {}
+
+            bool operator()(const Lit a, const Lit b) const
+            {
+                return degree[a.toInt()] > degree[b.toInt()];
+            }
+
+            const vector<uint32_t>& degree;
+        };
+
+        //Literals to start from, and the clique being built
+        vector<Lit> litsToTry;
+        vector<Lit> candidates;
+        vector<Lit> members;
+
+        //Temporaries, indexed by literal
+        vector<uint32_t> degree;
+        vector<uint32_t> numAdjacent; ///<Number of members a candidate is adjacent to
+        vector<char> inCandidates;
+        vector<char> counted;
+        vector<Lit> toClear;
+        int64_t timeLeft;
+        int origOtfHyperbin; ///<conf.otfHyperbin before the constraints were attached
+
+        //Stats
+        Stats runStats;
+        Stats globalStats;
+};
+
+inline const CardFinder::Stats& CardFinder::getStats() const
+{
+    return globalStats;
+}
+
+} //end namespace
+
+#endif //__CARDFINDER_H__
@@ -19,4 +19,27 @@ template <class T> CL_ABST_TYPE calcAbstraction(const T& ps)
     return abstraction;
 }
 
+/**
+@brief Second abstraction of the variables, with an independent hash
+
+Together with calcAbstraction() it gives a 64-bit signature. For a clause to be
+a subset of another, both of its abstractions must be a subset of the other's:
+this is a Bloom filter with two hashes, which filters out more of the false
+positives than a single 64-bit abstraction would.
+*/
+inline CL_ABST_TYPE abst_var2(const uint32_t v)
+{
+    return 1UL << ((v*2654435761U) >> 27);
+}
+
+template <class T> CL_ABST_TYPE calcAbstraction2(const T& ps)
+{
+    CL_ABST_TYPE abstraction = 0;
+
+    for (uint16_t i = 0; i != ps.size(); i++)
+        abstraction |= abst_var2(ps[i].var());
+
+    return abstraction;
+}
+
 #endif //__CL_ABSTRACTION__H__
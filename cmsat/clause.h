@@ -199,6 +199,7 @@ protected:
 public:
     char defOfOrGate; //TODO make it into a bitfield above
     CL_ABST_TYPE abst;
+    CL_ABST_TYPE abst2; ///<See calcAbstraction2(). Not in the watches, only checked once the clause is looked at
     ClauseStats stats;
 
     template<class V>
@@ -265,11 +266,13 @@ public:
     void reCalcAbstraction()
     {
         abst = calcAbstraction(*this);
+        abst2 = calcAbstraction2(*this);
     }
 
     void setStrenghtened()
     {
         abst = calcAbstraction(*this);
+        abst2 = calcAbstraction2(*this);
     }
 
     Lit& operator [] (const uint32_t i)
@@ -438,6 +441,7 @@ enum clauseCleaningTypes {
     , CLEAN_CLAUSES_SIZE_BASED
     , CLEAN_CLAUSES_PROPCONFL_BASED
     ,  CLEAN_CLAUSES_ACTIVITY_BASED
+    , CLEAN_CLAUSES_TIERED
 };
 
 inline std::string getNameOfCleanType(clauseCleaningTypes clauseCleaningType)
@@ -455,6 +459,9 @@ inline std::string getNameOfCleanType(clauseCleaningTypes clauseCleaningType)
         case CLEAN_CLAUSES_ACTIVITY_BASED:
             return "activity";
 
+        case CLEAN_CLAUSES_TIERED:
+            return "tiered";
+
         default:
             assert(false && "Unknown clause cleaning type?");
     };
@@ -547,6 +554,12 @@ struct CleaningStats
         , sizeBasedClean(0)
         , propConflBasedClean(0)
         , actBasedClean(0)
+        , tieredClean(0)
+
+        //Tiers
+        , tierCore(0)
+        , tierMid(0)
+        , tierLocal(0)
     {}
 
     CleaningStats& operator+=(const CleaningStats& other)
@@ -563,6 +576,12 @@ struct CleaningStats
         sizeBasedClean += other.sizeBasedClean;
         propConflBasedClean += other.propConflBasedClean;
         actBasedClean += other.actBasedClean;
+        tieredClean += other.tieredClean;
+
+        //Tiers
+        tierCore += other.tierCore;
+        tierMid += other.tierMid;
+        tierLocal += other.tierLocal;
 
         //Clause Cleaning data
         preRemove += other.preRemove;
@@ -613,6 +632,18 @@ struct CleaningStats
             , (double)propConflBasedClean/(double)nbReduceDB*100.0
             , "% cleans"
         );
+        printStatsLine("c clean by tiers"
+            , tieredClean
+            , (double)tieredClean/(double)nbReduceDB*100.0
+            , "% cleans"
+        );
+
+        //Tiers, summed over the cleanings
+        printStatsLine("c tier core/mid/local cls"
+            , tierCore
+            , tierMid
+            , tierLocal
+        );
 
         //--- Actual clean --
 
@@ -665,6 +696,15 @@ struct CleaningStats
         << " clean type will be " << getNameOfCleanType(clauseCleaningType)
         << endl;
 
+        if (tieredClean) {
+            cout
+            << "c [DBclean]"
+            << " tiers core " << tierCore
+            << " mid " << tierMid
+            << " local " << tierLocal
+            << endl;
+        }
+
         cout
         << "c [DBclean]"
         << " rem " << removed.num
@@ -708,6 +748,12 @@ struct CleaningStats
     size_t sizeBasedClean;
     size_t propConflBasedClean;
     size_t actBasedClean;
+    size_t tieredClean;
+
+    //Tiers: core is kept, used mid-tier is kept, the rest is local
+    uint64_t tierCore;
+    uint64_t tierMid;
+    uint64_t tierLocal;
 
     //Clause Cleaning
     Data removed;
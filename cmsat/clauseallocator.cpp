@@ -56,6 +56,7 @@ ClauseAllocator::ClauseAllocator() :
     , size(0)
     , maxSize(0)
     , currentlyUsedSize(0)
+    , numConsolidated(0)
 {
     assert(MIN_LIST_SIZE < MAXSIZE);
 }
@@ -65,7 +66,7 @@ ClauseAllocator::ClauseAllocator() :
 */
 ClauseAllocator::~ClauseAllocator()
 {
-    free(dataStart);
+    MemTracker::trackedFree(MemTag::clauses, dataStart, maxSize*sizeof(BASE_DATA_TYPE));
 }
 
 /**
@@ -136,8 +137,10 @@ void* ClauseAllocator::allocEnough(
         }
 
         //Reallocate data
-        dataStart = (BASE_DATA_TYPE*)realloc(
-            dataStart
+        dataStart = (BASE_DATA_TYPE*)MemTracker::trackedRealloc(
+            MemTag::clauses
+            , dataStart
+            , maxSize*sizeof(BASE_DATA_TYPE)
             , newMaxSize*sizeof(BASE_DATA_TYPE)
         );
 
@@ -233,9 +236,10 @@ void ClauseAllocator::consolidate(
     //Neccesities:
     //1) There is too much memory allocated. Re-allocation will save space
     //   Avoiding segfault (max is 16 outerOffsets, more than 10 is near)
-    //2) There is too much empty, unused space (>30%)
+    //2) There is too much empty, unused space (>50%). Clauses freed by
+    //   reduceDB() are still watched until then, so don't do it too often
     if (!force
-        && ((double)currentlyUsedSize/(double)size > 0.7)
+        && ((double)currentlyUsedSize/(double)size > 0.5)
        ) {
         if (solver->conf.verbosity >= 3) {
             cout << "c Not consolidating memory." << endl;
@@ -243,8 +247,10 @@ void ClauseAllocator::consolidate(
         return;
     }
 
+    numConsolidated++;
+
     //Data for new struct
-    vector<uint32_t> newOrigClauseSizes;
+    ClauseSizeVec newOrigClauseSizes;
     vector<ClOffset> newOffsets;
     uint64_t newSize = 0;
 
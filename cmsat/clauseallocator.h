@@ -31,6 +31,7 @@
 #include <vector>
 
 #include "watched.h"
+#include "memtracker.h"
 
 #define BASE_DATA_TYPE uint32_t
 
@@ -88,6 +89,12 @@ class ClauseAllocator {
 
         uint64_t getMemUsed() const;
 
+        ///Offsets obtained before a change of this are invalid
+        uint64_t getNumConsolidated() const
+        {
+            return numConsolidated;
+        }
+
     private:
         void updateAllOffsetsAndPointers(
             Solver* solver
@@ -102,7 +109,8 @@ class ClauseAllocator {
         the running of the solver. Therefore, it is imperative that their orignal
         size is saved. This way, we can later move clauses around.
         */
-        vector<uint32_t> origClauseSizes;
+        typedef vector<uint32_t, TrackedAlloc<uint32_t, MemTag::clauses> > ClauseSizeVec;
+        ClauseSizeVec origClauseSizes;
         size_t maxSize; ///<The number of BASE_DATA_TYPE datapieces allocated
         /**
         @brief The estimated used size of the stack
@@ -112,6 +120,7 @@ class ClauseAllocator {
         overestimation almost all the time
         */
         size_t currentlyUsedSize;
+        uint64_t numConsolidated;
 
         void* allocEnough(const uint32_t size, const bool reconstruct);
 };
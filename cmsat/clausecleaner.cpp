@@ -71,8 +71,8 @@ void ClauseCleaner::treatImplicitClauses()
         vec<Watched>::iterator j = i;
         for (vec<Watched>::iterator end2 = ws.end(); i != end2; i++) {
 
-            //Skip clauses
-            if (i->isClause()) {
+            //Skip clauses, at-most-one and XOR constraints
+            if (i->isClause() || i->isCard() || i->isXor()) {
                 *j++ = *i;
                 continue;
             }
@@ -85,10 +85,10 @@ void ClauseCleaner::treatImplicitClauses()
                         && lit < i->lit1()
                     ) {
                         (*solver->drup)
-                        << "d "
-                        << lit << " "
+                        << DrupFlag::del
+                        << lit
                         << i->lit1()
-                        << " 0\n";
+                        << DrupFlag::fin;
                     }
                     #endif
 
@@ -96,6 +96,7 @@ void ClauseCleaner::treatImplicitClauses()
                         remLBin++;
                     } else {
                         remNonLBin++;
+                        solver->touchIrred(i->lit1());
                     }
                 } else {
                     assert(solver->value(i->lit1()) == l_Undef);
@@ -155,9 +156,9 @@ void ClauseCleaner::treatImplicitClauses()
                 #ifdef DRUP
                 if (solver->drup) {
                     (*solver->drup)
-                    << lits[0] << " "
+                    << lits[0]
                     << lits[1]
-                    << " 0\n";
+                    << DrupFlag::fin;
                 }
                 #endif
             }
@@ -170,18 +171,21 @@ void ClauseCleaner::treatImplicitClauses()
                     && i->lit1() < i->lit2()
                 ) {
                     (*solver->drup)
-                    << "d "
-                    << lit << " "
-                    << i->lit1() << " "
+                    << DrupFlag::del
+                    << lit
+                    << i->lit1()
                     << i->lit2()
-                    << " 0\n";
+                    << DrupFlag::fin;
                 }
                 #endif
 
-                if (i->learnt())
+                if (i->learnt()) {
                     remLTri++;
-                else
+                } else {
                     remNonLTri++;
+                    solver->touchIrred(i->lit1());
+                    solver->touchIrred(i->lit2());
+                }
             } else {
                 *j++ = *i;
             }
@@ -267,7 +271,7 @@ inline bool ClauseCleaner::cleanClause(ClOffset offset)
             solver->detachModifiedClause(origLit1, origLit2, origSize, &cl);
             #ifdef DRUP
             if (solver->drup) {
-                (*solver->drup) << "d " << origCl << " 0\n";
+                (*solver->drup) << DrupFlag::del << origCl << DrupFlag::fin;
             }
             #endif
             return true;
@@ -278,8 +282,8 @@ inline bool ClauseCleaner::cleanClause(ClOffset offset)
     #ifdef DRUP
     if (solver->drup && i != j) {
         (*solver->drup)
-        << cl << " 0\n"
-        << "d " << origCl << " 0\n";
+        << cl << DrupFlag::fin
+        << DrupFlag::del << origCl << DrupFlag::fin;
     }
     #endif
 
@@ -294,10 +298,12 @@ inline bool ClauseCleaner::cleanClause(ClOffset offset)
             solver->attachTriClause(cl[0], cl[1], cl[2], cl.learnt());
             return true;
         } else {
-            if (cl.learnt())
+            if (cl.learnt()) {
                 solver->binTri.redLits -= i-j;
-            else
+            } else {
                 solver->binTri.irredLits -= i-j;
+                solver->touchIrredLits(cl);
+            }
         }
     }
 
@@ -67,7 +67,8 @@ inline void ClauseCleaner::removeAndCleanAll()
 
 #ifndef NDEBUG
     //Once we have cleaned the watchlists
-    //no watchlist whose lit is set may be non-empty
+    //no watchlist whose lit is set may be non-empty, except for the
+    //watches of clauses freed by reduceDB(), of at-most-one and of XOR constraints
     size_t wsLit = 0;
     for(vector<vec<Watched> >::const_iterator
         it = solver->watches.begin(), end = solver->watches.end()
@@ -76,7 +77,12 @@ inline void ClauseCleaner::removeAndCleanAll()
     ) {
         const Lit lit = Lit::toLit(wsLit);
         if (solver->value(lit) != l_Undef) {
-            assert(it->empty());
+            for(const Watched& w: *it) {
+                assert(w.isCard()
+                    || w.isXor()
+                    || (w.isClause()
+                        && solver->clAllocator->getPointer(w.getOffset())->freed()));
+            }
         }
     }
 #endif
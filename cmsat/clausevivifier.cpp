@@ -23,6 +23,7 @@
 #include "clausecleaner.h"
 #include "time_mem.h"
 #include "solver.h"
+#include "inprocsched.h"
 #include <iomanip>
 using namespace CMSat;
 using std::cout;
@@ -104,6 +105,7 @@ bool ClauseVivifier::vivifyClausesTriIrred()
     uint64_t origLitRem = runStats.numLitsRem;
     double myTime = cpuTime();
     uint64_t maxNumProps = 2LL*1000LL*1000LL;
+    maxNumProps = (double)maxNumProps * solver->inprocSched->budget(Inproc::vivify);
     uint64_t oldBogoProps = solver->propStats.bogoProps;
     size_t origTrailSize = solver->trail.size();
 
@@ -132,7 +134,6 @@ bool ClauseVivifier::vivifyClausesTriIrred()
                 && lit < ws[i].lit1()
                 && ws[i].lit1() < ws[i].lit2()
             ) {
-                uselessLits.clear();
                 lits.resize(3);
                 lits[0] = lit;
                 lits[1] = ws[i].lit1();
@@ -209,6 +210,7 @@ bool ClauseVivifier::asymmClausesLongIrred()
     uint64_t maxNumProps = 20LL*1000LL*1000LL;
     if (solver->binTri.irredLits + solver->binTri.redLits < 500000)
         maxNumProps *=2;
+    maxNumProps = (double)maxNumProps * solver->inprocSched->budget(Inproc::vivify);
 
     extraTime = 0;
     uint64_t oldBogoProps = solver->propStats.bogoProps;
@@ -272,7 +274,6 @@ bool ClauseVivifier::asymmClausesLongIrred()
         assert(!cl.learnt());
 
         //Copy literals
-        uselessLits.clear();
         lits.resize(cl.size());
         std::copy(cl.begin(), cl.end(), lits.begin());
 
@@ -339,42 +340,16 @@ ClOffset ClauseVivifier::testVivify(
     }
     #endif
 
-    //Try to enqueue the literals in 'queueByBy' amounts and see if we fail
-    bool failed = false;
-    uint32_t done = 0;
+    const uint32_t origSize = lits.size();
     solver->newDecisionLevel();
-    for (; done < lits.size();) {
-        uint32_t i2 = 0;
-        for (; (i2 < queueByBy) && ((done+i2) < lits.size()); i2++) {
-            lbool val = solver->value(lits[done+i2]);
-            if (val == l_Undef) {
-                solver->enqueue(~lits[done+i2]);
-            } else if (val == l_False) {
-                //Record that there is no use for this literal
-                uselessLits.push_back(lits[done+i2]);
-            }
-        }
-        done += i2;
-        extraTime += 5;
-        failed = (!solver->propagate().isNULL());
-        if (failed) {
-            break;
-        }
-    }
+    const bool shortened = vivifyLits(*solver, lits, uselessLits, queueByBy, extraTime);
     solver->cancelZeroLight();
     assert(solver->ok);
 
-    if (uselessLits.size() > 0 || (failed && done < lits.size())) {
+    if (shortened) {
         //Stats
         runStats.numClShorten++;
         extraTime += 20;
-        const uint32_t origSize = lits.size();
-
-        //Remove useless literals from 'lits'
-        lits.resize(done);
-        for (uint32_t i2 = 0; i2 < uselessLits.size(); i2++) {
-            remove(lits, uselessLits[i2]);
-        }
 
         //Make new clause
         Clause *cl2 = solver->addClauseInt(lits, learnt);
@@ -395,7 +370,7 @@ ClOffset ClauseVivifier::testVivify(
             cout
             << "c --> orig size:" << origSize << endl
             << "c --> new size:" << (cl2 == NULL ? 0 : cl2->size()) << endl
-            << "c --> removing lits from end:" << origSize - done << endl
+            << "c --> removing lits from end:" << origSize - lits.size() - uselessLits.size() << endl
             << "c --> useless lits in middle:" << uselessLits.size()
             << endl;
         }
@@ -449,6 +424,7 @@ bool ClauseVivifier::vivifyClausesCache(
     ) {
         maxCountTime /= 2;
     }
+    maxCountTime = (double)maxCountTime * solver->inprocSched->budget(Inproc::vivify);
 
     Stats::CacheBased tmpStats;
     tmpStats.totalCls = clauses.size();
@@ -812,6 +788,7 @@ void ClauseVivifier::subsumeImplicit()
     uint64_t stampTriRem = 0;
     uint64_t cacheTriRem = 0;
     timeAvailable = 1900LL*1000LL*1000LL;
+    timeAvailable = (double)timeAvailable * solver->inprocSched->budget(Inproc::implicit);
     const bool doStamp = solver->conf.doStamp;
     uint64_t numWatchesLooked = 0;
 
@@ -915,7 +892,7 @@ void ClauseVivifier::subsumeImplicit()
                 ) {
                     for(size_t i = 0; i < lits.size() && !remove; i++) {
                         timeAvailable -= solver->implCache[lit.toInt()].lits.size();
-                        for (vector<LitExtra>::const_iterator
+                        for (LitExtraVec::const_iterator
                             it2 = solver->implCache[lits[i].toInt()].lits.begin()
                             , end2 = solver->implCache[lits[i].toInt()].lits.end()
                             ; it2 != end2
@@ -947,11 +924,11 @@ void ClauseVivifier::subsumeImplicit()
                     #ifdef DRUP
                     if (solver->drup) {
                         (*solver->drup)
-                        << "d "
-                        << lit << " "
-                        << i->lit1() << " "
+                        << DrupFlag::del
+                        << lit
+                        << i->lit1()
                         << i->lit2()
-                        << " 0\n";
+                        << DrupFlag::fin;
                     }
                     #endif
                     continue;
@@ -985,15 +962,17 @@ void ClauseVivifier::subsumeImplicit()
                 } else {
                     solver->binTri.irredLits -= 2;
                     solver->binTri.irredBins--;
+                    solver->touchIrred(lit);
+                    solver->touchIrred(i->lit1());
                 }
 
                 #ifdef DRUP
                 if (solver->drup) {
                     (*solver->drup)
-                    << "d "
-                    << lit << " "
+                    << DrupFlag::del
+                    << lit
                     << i->lit1()
-                    << " 0\n";
+                    << DrupFlag::fin;
                 }
                 #endif
 
@@ -1037,6 +1016,7 @@ bool ClauseVivifier::strengthenImplicit()
     uint64_t stampRem = 0;
     const size_t origTrailSize = solver->trail.size();
     timeAvailable = 1000LL*1000LL*1000LL;
+    timeAvailable = (double)timeAvailable * solver->inprocSched->budget(Inproc::implicit);
     double myTime = cpuTime();
     const bool doStamp = solver->conf.doStamp;
     uint64_t numWatchesLooked = 0;
@@ -1093,7 +1073,7 @@ bool ClauseVivifier::strengthenImplicit()
                         if (solver->drup) {
                             (*solver->drup)
                             << lits[0]
-                            << " 0\n";
+                            << DrupFlag::fin;
                         }
                         #endif
                         remLitFromBin++;
@@ -1137,7 +1117,7 @@ bool ClauseVivifier::strengthenImplicit()
                     if (solver->drup) {
                         (*solver->drup)
                         << lit
-                        << " 0\n";
+                        << DrupFlag::fin;
                     }
                     #endif
 
@@ -1192,16 +1172,16 @@ bool ClauseVivifier::strengthenImplicit()
                     if (solver->drup) {
                         (*solver->drup)
                         //Add shortened
-                        << i->lit1() << " "
+                        << i->lit1()
                         << i->lit2()
-                        << " 0\n"
+                        << DrupFlag::fin
 
                         //Delete old
-                        << "d "
-                        << lit << " "
-                        << i->lit1() << " "
+                        << DrupFlag::del
+                        << lit
+                        << i->lit1()
                         << i->lit2()
-                        << " 0\n";
+                        << DrupFlag::fin;
                     }
                     #endif
 
@@ -1236,16 +1216,16 @@ bool ClauseVivifier::strengthenImplicit()
                         if (solver->drup) {
                             (*solver->drup)
                             //Add shortened
-                            << lits[0] << " "
+                            << lits[0]
                             << lits[1]
-                            << " 0\n"
+                            << DrupFlag::fin
 
                             //Delete old
-                            << "d "
-                            << lit << " "
-                            << i->lit1() << " "
+                            << DrupFlag::del
+                            << lit
+                            << i->lit1()
                             << i->lit2()
-                            << " 0\n"
+                            << DrupFlag::fin
                             ;
                         }
                         #endif
@@ -1260,14 +1240,14 @@ bool ClauseVivifier::strengthenImplicit()
                             (*solver->drup)
                             //Add shortened
                             << lits[0]
-                            << " 0\n"
+                            << DrupFlag::fin
 
                             //Delete old
-                            << "d "
-                            << lit << " "
-                            << i->lit1() << " "
+                            << DrupFlag::del
+                            << lit
+                            << i->lit1()
                             << i->lit2()
-                            << " 0\n"
+                            << DrupFlag::fin
                             ;
                         }
                         #endif
@@ -1355,5 +1335,8 @@ void ClauseVivifier::removeTri(
     } else {
         solver->binTri.irredLits -= 3;
         solver->binTri.irredTris--;
+        for(size_t i = 0; i < 3; i++) {
+            solver->touchIrred(lits[i]);
+        }
     }
 }
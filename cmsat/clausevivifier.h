@@ -27,6 +27,7 @@
 #include "constants.h"
 #include "solvertypes.h"
 #include "cloffset.h"
+#include "alg.h"
 
 namespace CMSat {
 
@@ -42,6 +43,15 @@ class ClauseVivifier {
         void subsumeImplicit();
         bool strengthenImplicit();
 
+        template<class T>
+        static bool vivifyLits(
+            T& prop
+            , vector<Lit>& lits
+            , vector<Lit>& uselessLits
+            , const uint32_t queueByBy
+            , uint64_t& extraTime
+        );
+
         struct Stats
         {
             Stats() :
@@ -325,6 +335,58 @@ inline const ClauseVivifier::Stats& ClauseVivifier::getStats() const
     return globalStats;
 }
 
+/**
+@brief Shortens 'lits' by enqueueing the negation of its literals, 'queueByBy'
+at a time, and propagating
+
+The literals already false are of no use, and the ones after a conflict can be
+dropped. 'prop' only needs value(), enqueue() and propagate(), so it is either
+the solver or the snapshot of the BgSimplifier. The caller cancels the
+assignments. Returns TRUE if 'lits' has been shortened
+*/
+template<class T>
+bool ClauseVivifier::vivifyLits(
+    T& prop
+    , vector<Lit>& lits
+    , vector<Lit>& uselessLits
+    , const uint32_t queueByBy
+    , uint64_t& extraTime
+) {
+    //Try to enqueue the literals in 'queueByBy' amounts and see if we fail
+    uselessLits.clear();
+    bool failed = false;
+    uint32_t done = 0;
+    for (; done < lits.size();) {
+        uint32_t i2 = 0;
+        for (; (i2 < queueByBy) && ((done+i2) < lits.size()); i2++) {
+            lbool val = prop.value(lits[done+i2]);
+            if (val == l_Undef) {
+                prop.enqueue(~lits[done+i2]);
+            } else if (val == l_False) {
+                //Record that there is no use for this literal
+                uselessLits.push_back(lits[done+i2]);
+            }
+        }
+        done += i2;
+        extraTime += 5;
+        failed = (!prop.propagate().isNULL());
+        if (failed) {
+            break;
+        }
+    }
+
+    if (uselessLits.empty() && !(failed && done < lits.size()))
+        return false;
+
+    //Remove useless literals from 'lits'
+    lits.resize(done);
+    for (uint32_t i2 = 0; i2 < uselessLits.size(); i2++) {
+        remove(lits, uselessLits[i2]);
+    }
+
+    return true;
+}
+
 } //end namespace
 
 #endif //CLAUSEVIVIFIER_H
@@ -146,6 +146,10 @@ bool CompHandler::handle()
         SolverConf conf;
         Solver newSolver(conf);
         configureNewSolver(&newSolver, vars.size());
+        #ifdef DRUP
+        //The sub-solver's proof goes into ours, in our numbering
+        newSolver.setDrup(solver->drup, &interToOuter);
+        #endif
         moveVariablesBetweenSolvers(&newSolver, vars, comp);
 
         //Move clauses over
@@ -676,7 +680,7 @@ void CompHandler::readdRemovedClauses()
         }
 
         //Add the clause to the system
-        solver->addClause(tmp);
+        solver->addClauseOuter(tmp);
         assert(solver->okay());
 
         //Move 'at' along
@@ -52,6 +52,9 @@ void CompleteDetachReatacher::detachNonBinsNonTris()
     solver->binTri.irredBins = stay.nonLearntBins/2;
     solver->binTri.redTris = stay.learntTris/3;
     solver->binTri.irredTris = stay.nonLearntTris/3;
+
+    //Watches of lazily freed clauses are gone, too
+    solver->numLazyFreed = 0;
 }
 
 /**
@@ -78,6 +81,8 @@ CompleteDetachReatacher::ClausesStay CompleteDetachReatacher::clearWatchNotBinNo
             else
                 stay.nonLearntTris++;
 
+            *j++ = *i;
+        } else if (i->isCard() || i->isXor()) {
             *j++ = *i;
         }
     }
@@ -167,9 +172,9 @@ bool CompleteDetachReatacher::cleanClause(Clause* cl)
             #ifdef DRUP
             if (solver->drup && i != j) {
                 (*solver->drup)
-                << "d "
+                << DrupFlag::del
                 << origCl
-                << endl;
+                << DrupFlag::fin;
             }
             #endif
 
@@ -184,13 +189,13 @@ bool CompleteDetachReatacher::cleanClause(Clause* cl)
     #ifdef DRUP
     if (solver->drup && i != j) {
         (*solver->drup)
-        << cl
-        << " 0\n"
+        << *cl
+        << DrupFlag::fin
 
         //Delete old one
-        << "d "
+        << DrupFlag::del
         << origCl
-        << " 0\n";
+        << DrupFlag::fin;
     }
     #endif
 
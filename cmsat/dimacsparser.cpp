@@ -154,7 +154,7 @@ void DimacsParser::readClause(StreamBuffer& in, vector<Lit>& lits)
                 exit(-1);
             }
 
-            while (var >= solver->nVars())
+            while (var >= solver->nVarsOutside())
                 solver->newVar();
         }
         lits.push_back( (parsed_lit > 0) ? Lit(var, false) : Lit(var, true) );
@@ -252,7 +252,7 @@ void DimacsParser::parseComments(StreamBuffer& in, const std::string str)
         if (ret == l_True) {
             partFile << "s SATISFIABLE" << endl;
             partFile << "v ";
-            for (Var i = 0; i != solver->nVars(); i++) {
+            for (Var i = 0; i != solver->nVarsOutside(); i++) {
                 if (solver->model[i] != l_Undef)
                     partFile
                     << ((solver->model[i]==l_True) ? "" : "-")
@@ -334,10 +334,25 @@ void DimacsParser::readFullClause(StreamBuffer& in)
     std::string str;
     bool needToParseComments = false;
 
-    //Is it an XOR clause?
+    //Is it an XOR clause? Negated literals flip the right hand side
     if ( *in == 'x') {
-        cout << "ERROR: Cannot read XOR clause!" << endl;
-        exit(-1);
+        ++in;
+        readClause(in, lits);
+        skipLine(in);
+
+        bool rhs = true;
+        vector<Var> vars;
+        for(vector<Lit>::const_iterator
+            it = lits.begin(), end = lits.end()
+            ; it != end
+            ; it++
+        ) {
+            rhs ^= it->sign();
+            vars.push_back(it->var());
+        }
+        solver->addXorClause(vars, rhs);
+        numXorClauses++;
+        return;
     }
 
     //read in the actual clause
@@ -408,6 +423,7 @@ template <class T> void DimacsParser::parse_DIMACS(T input_stream)
     debugLibPart = 1;
     numLearntClauses = 0;
     numNormClauses = 0;
+    numXorClauses = 0;
     const uint32_t origNumVars = solver->nVars();
 
     StreamBuffer in(input_stream);
@@ -418,7 +434,9 @@ template <class T> void DimacsParser::parse_DIMACS(T input_stream)
         << std::setw(12) << numLearntClauses
         << " learnts, "
         << std::setw(12) << numNormClauses
-        << " normals "
+        << " normals, "
+        << std::setw(12) << numXorClauses
+        << " xors"
         << endl;
 
         cout << "c -- vars added " << std::setw(10) << (solver->nVars() - origNumVars)
@@ -65,6 +65,7 @@ class DimacsParser
         std::vector<Lit> lits; ///<To reduce temporary creation overhead
         uint32_t numLearntClauses; ///<Number of learnt non-xor clauses added
         uint32_t numNormClauses; ///<Number of non-learnt, non-xor claues added
+        uint32_t numXorClauses; ///<Number of xor clauses added
 };
 
 }
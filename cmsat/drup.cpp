@@ -0,0 +1,260 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos and collaborators. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#include "drup.h"
+#include <iostream>
+
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+
+using namespace CMSat;
+using std::cout;
+using std::endl;
+
+bool DrupWriter::ChunkRing::push(Chunk* chunk)
+{
+    const size_t at = tail.load(std::memory_order_relaxed);
+    const size_t next = (at + 1) % ringSize;
+    if (next == head.load(std::memory_order_acquire))
+        return false;
+
+    slots[at] = chunk;
+    tail.store(next, std::memory_order_release);
+    return true;
+}
+
+bool DrupWriter::ChunkRing::pop(Chunk*& chunk)
+{
+    const size_t at = head.load(std::memory_order_relaxed);
+    if (at == tail.load(std::memory_order_acquire))
+        return false;
+
+    chunk = slots[at];
+    head.store((at + 1) % ringSize, std::memory_order_release);
+    return true;
+}
+
+bool DrupWriter::ChunkRing::isEmpty() const
+{
+    return head.load(std::memory_order_acquire)
+        == tail.load(std::memory_order_acquire);
+}
+
+DrupWriter::DrupWriter(const Format _format, const int _compressLevel) :
+    format(_format)
+    , compressLevel(_compressLevel)
+    , toStdout(false)
+    , inLine(false)
+    , numLines(0)
+    , current(NULL)
+    , pos(NULL)
+    , end(NULL)
+    , finishing(false)
+    , failed(false)
+    , ioThread(NULL)
+    , outFile(NULL)
+    , gzOut(NULL)
+{
+    current = new Chunk;
+    resetPos();
+}
+
+DrupWriter::~DrupWriter()
+{
+    close();
+    delete current;
+
+    Chunk* chunk;
+    while (empty.pop(chunk)) {
+        delete chunk;
+    }
+}
+
+bool DrupWriter::open(const std::string& filename)
+{
+    outFile = fopen(filename.c_str(), "wb");
+    if (outFile == NULL)
+        return false;
+
+    if (compressLevel > 0) {
+        #ifdef USE_ZLIB
+        char mode[4] = {'w', 'b', (char)('0' + std::min(compressLevel, 9)), 0};
+        gzOut = gzdopen(fileno(outFile), mode);
+        if (gzOut == NULL) {
+            fclose(outFile);
+            outFile = NULL;
+            return false;
+        }
+        #else
+        cout
+        << "c WARNING: compiled without zlib, DRUP output will not be compressed"
+        << endl;
+        #endif
+    }
+
+    ioThread = new std::thread(&DrupWriter::ioThreadMain, this);
+    return true;
+}
+
+void DrupWriter::openStdout()
+{
+    toStdout = true;
+}
+
+void DrupWriter::resetPos()
+{
+    current->used = 0;
+    pos = current->data;
+    end = current->data + chunkSize;
+}
+
+DrupWriter::Chunk* DrupWriter::getFreeChunk()
+{
+    Chunk* chunk;
+    if (empty.pop(chunk))
+        return chunk;
+
+    return new Chunk;
+}
+
+void DrupWriter::writeSync()
+{
+    cout.write(current->data, pos - current->data);
+    resetPos();
+}
+
+void DrupWriter::handOver()
+{
+    if (toStdout) {
+        writeSync();
+        return;
+    }
+
+    if (ioThread == NULL || hasFailed()) {
+        //Not opened, already closed, or cannot be written: drop
+        resetPos();
+        return;
+    }
+
+    current->used = pos - current->data;
+    if (!full.push(current)) {
+        //I/O thread is behind, wait for it
+        std::unique_lock<std::mutex> lock(waitMutex);
+        while (!full.push(current)) {
+            hasSpace.wait(lock);
+        }
+    }
+    notify(hasData);
+
+    current = getFreeChunk();
+    resetPos();
+}
+
+void DrupWriter::notify(std::condition_variable& cond)
+{
+    //The waiting thread checks the rings while holding the mutex, so taking
+    //it here means the change is either seen or the waiter is woken up
+    {
+        std::lock_guard<std::mutex> lock(waitMutex);
+    }
+    cond.notify_one();
+}
+
+void DrupWriter::close()
+{
+    if (toStdout) {
+        writeSync();
+        cout << std::flush;
+        return;
+    }
+
+    if (ioThread == NULL)
+        return;
+
+    if (pos != current->data) {
+        handOver();
+    }
+    finishing.store(true, std::memory_order_release);
+    notify(hasData);
+    ioThread->join();
+    delete ioThread;
+    ioThread = NULL;
+
+    #ifdef USE_ZLIB
+    if (gzOut != NULL) {
+        //Also closes the underlying fd
+        if (gzclose((gzFile)gzOut) != Z_OK)
+            failed.store(true, std::memory_order_release);
+        gzOut = NULL;
+        outFile = NULL;
+    }
+    #endif
+
+    if (outFile != NULL) {
+        if (fclose(outFile) != 0)
+            failed.store(true, std::memory_order_release);
+        outFile = NULL;
+    }
+}
+
+void DrupWriter::writeChunk(const Chunk* chunk)
+{
+    //Once a write failed, the proof is broken, don't write the rest
+    if (hasFailed())
+        return;
+
+    #ifdef USE_ZLIB
+    if (gzOut != NULL) {
+        if (gzwrite((gzFile)gzOut, chunk->data, chunk->used) != (int)chunk->used) {
+            failed.store(true, std::memory_order_release);
+        }
+        return;
+    }
+    #endif
+
+    if (fwrite(chunk->data, 1, chunk->used, outFile) != chunk->used) {
+        failed.store(true, std::memory_order_release);
+    }
+}
+
+void DrupWriter::ioThreadMain()
+{
+    while (true) {
+        Chunk* chunk;
+        if (full.pop(chunk)) {
+            writeChunk(chunk);
+            if (!empty.push(chunk))
+                delete chunk;
+
+            notify(hasSpace);
+            continue;
+        }
+
+        //The last chunk is pushed before "finishing" is set
+        std::unique_lock<std::mutex> lock(waitMutex);
+        while (full.isEmpty() && !finishing.load(std::memory_order_acquire)) {
+            hasData.wait(lock);
+        }
+        if (full.isEmpty())
+            break;
+    }
+}
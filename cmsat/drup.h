@@ -0,0 +1,297 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos and collaborators. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#ifndef __DRUP_H__
+#define __DRUP_H__
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "constants.h"
+#include "solvertypes.h"
+#include "clause.h"
+
+namespace CMSat {
+
+///Starts a deletion line, or ends the clause, in the proof
+enum class DrupFlag {
+    fin
+    , del
+};
+
+/**
+@brief Writes the DRUP/DRAT proof, either as text or as binary DRAT
+
+The proof is produced by the solver with "<<", e.g.
+\code
+(*drup) << DrupFlag::del << cl << DrupFlag::fin;
+\endcode
+where DrupFlag::del makes the line a deletion and DrupFlag::fin ends the
+clause. The tokens are not formatted through an ostream, but encoded straight
+into a fixed-size chunk. Full chunks are passed to a background thread over a
+single-producer single-consumer ring, which writes (and optionally gzips) them.
+The solver thread therefore never waits on the disk unless the ring is full.
+
+Literals are written through the stack of variable maps, innermost first, so
+that the proof is always in the numbering of the original problem, no matter
+how the solver (or the component sub-solvers) renumbered the variables.
+
+Binary DRAT: every line is an 'a' (add) or 'd' (delete) byte, followed by the
+literals encoded as 2*(var+1)+sign in 7-bit varints, followed by a 0 byte.
+*/
+class DrupWriter
+{
+    public:
+        enum class Format {
+            text
+            , binary
+        };
+
+        DrupWriter(const Format format, const int compressLevel);
+        ~DrupWriter();
+
+        ///Open file and start the I/O thread. Returns false on failure
+        bool open(const std::string& filename);
+
+        ///Write synchronously to stdout, interleaved with the rest of output
+        void openStdout();
+
+        ///Write out everything and stop the I/O thread
+        void close();
+
+        ///Writing the proof failed at some point. The rest of it is dropped
+        bool hasFailed() const
+        {
+            return failed.load(std::memory_order_acquire);
+        }
+
+        ///Translate literals through "map" before the maps pushed earlier
+        void pushVarMap(const std::vector<Var>* map)
+        {
+            varMaps.push_back(map);
+        }
+
+        void popVarMap()
+        {
+            assert(!varMaps.empty());
+            varMaps.pop_back();
+        }
+
+        DrupWriter& operator<<(Lit lit)
+        {
+            if (!inLine)
+                startLine(false);
+
+            for(size_t i = varMaps.size(); i > 0; i--) {
+                lit = Lit((*varMaps[i-1])[lit.var()], lit.sign());
+            }
+
+            ensureSpace(maxLitBytes);
+            if (format == Format::binary) {
+                writeVarint(2*(lit.var()+1) + (uint32_t)lit.sign());
+            } else {
+                if (lit.sign())
+                    *pos++ = '-';
+                writeNum(lit.var()+1);
+                *pos++ = ' ';
+            }
+
+            return *this;
+        }
+
+        DrupWriter& operator<<(const Clause& cl)
+        {
+            for(const Lit *l = cl.begin(), *end = cl.end(); l != end; l++) {
+                *this << *l;
+            }
+
+            return *this;
+        }
+
+        DrupWriter& operator<<(const std::vector<Lit>& lits)
+        {
+            for(std::vector<Lit>::const_iterator
+                it = lits.begin(), end = lits.end()
+                ; it != end
+                ; it++
+            ) {
+                *this << *it;
+            }
+
+            return *this;
+        }
+
+        DrupWriter& operator<<(const DrupFlag flag)
+        {
+            if (flag == DrupFlag::del) {
+                startLine(true);
+            } else {
+                endLine();
+            }
+
+            return *this;
+        }
+
+        uint64_t getNumLines() const
+        {
+            return numLines;
+        }
+
+    private:
+        static const size_t chunkSize = 1024*1024;
+        static const size_t ringSize = 64;
+        static const size_t maxLitBytes = 16;
+
+        struct Chunk
+        {
+            size_t used;
+            char data[chunkSize];
+        };
+
+        ///Lock-free single-producer single-consumer queue of chunks
+        class ChunkRing
+        {
+            public:
+                ChunkRing() :
+                    head(0)
+                    , tail(0)
+                {}
+
+                bool push(Chunk* chunk);
+                bool pop(Chunk*& chunk);
+                bool isEmpty() const;
+
+            private:
+                Chunk* slots[ringSize];
+                std::atomic<size_t> head; ///<Next slot to pop, consumer-owned
+                std::atomic<size_t> tail; ///<Next slot to push, producer-owned
+        };
+
+        void startLine(const bool isDelete)
+        {
+            if (inLine)
+                return;
+
+            inLine = true;
+            ensureSpace(2);
+            if (format == Format::binary) {
+                *pos++ = isDelete ? 'd' : 'a';
+            } else if (isDelete) {
+                *pos++ = 'd';
+                *pos++ = ' ';
+            }
+        }
+
+        void endLine()
+        {
+            if (!inLine)
+                startLine(false);
+
+            ensureSpace(2);
+            if (format == Format::binary) {
+                *pos++ = 0;
+            } else {
+                *pos++ = '0';
+                *pos++ = '\n';
+            }
+            inLine = false;
+            numLines++;
+
+            if (toStdout)
+                writeSync();
+        }
+
+        void ensureSpace(const size_t bytes)
+        {
+            if ((size_t)(end - pos) < bytes)
+                handOver();
+        }
+
+        void writeVarint(uint32_t val)
+        {
+            while (val > 127) {
+                *pos++ = (char)(128 | (val & 127));
+                val >>= 7;
+            }
+            *pos++ = (char)val;
+        }
+
+        void writeNum(uint32_t val)
+        {
+            char tmp[12];
+            char* at = tmp;
+            do {
+                *at++ = '0' + (val % 10);
+                val /= 10;
+            } while (val != 0);
+
+            while (at != tmp) {
+                *pos++ = *--at;
+            }
+        }
+
+        //Producer side
+        void handOver();
+        void writeSync();
+        Chunk* getFreeChunk();
+        void resetPos();
+
+        //Consumer side
+        void ioThreadMain();
+        void writeChunk(const Chunk* chunk);
+
+        ///Wake up the other thread, waiting on 'cond' for the rings to change
+        void notify(std::condition_variable& cond);
+
+        const Format format;
+        const int compressLevel;
+        std::vector<const std::vector<Var>*> varMaps;
+        bool toStdout;
+        bool inLine;
+        uint64_t numLines;
+
+        Chunk* current;
+        char* pos;
+        char* end;
+
+        ChunkRing full; ///<Solver --> I/O thread
+        ChunkRing empty; ///<I/O thread --> solver, for reuse
+        std::atomic<bool> finishing;
+        std::atomic<bool> failed;
+        std::thread* ioThread;
+
+        //Only used to sleep while the rings are full or empty
+        std::mutex waitMutex;
+        std::condition_variable hasData; ///<I/O thread waits on it
+        std::condition_variable hasSpace; ///<Solver waits on it
+
+        FILE* outFile;
+        void* gzOut; ///<gzFile, if compressing
+};
+
+} //end namespace
+
+#endif //__DRUP_H__
@@ -450,7 +450,7 @@ void GateFinder::findOrGates(const bool learntGatesToo)
         for (const Lit *l = cl.begin(), *end2 = cl.end(); l != end2; l++) {
             Lit lit = *l;
             //TODO stamping
-            //const vector<LitExtra>& cache = solver->implCache[(~lit).toInt()].lits;
+            //const LitExtraVec& cache = solver->implCache[(~lit).toInt()].lits;
             const vec<Watched>& ws = solver->watches[(~lit).toInt()];
 
             if (
@@ -491,9 +491,9 @@ void GateFinder::findOrGate(
 
         //Try to find corresponding binary clause in cache
         //TODO stamping
-        /*const vector<LitExtra>& cache = solver->implCache[(~otherLit).toInt()].lits;
+        /*const LitExtraVec& cache = solver->implCache[(~otherLit).toInt()].lits;
         *subsumer->toDecrease -= cache.size();
-        for (vector<LitExtra>::const_iterator
+        for (LitExtraVec::const_iterator
             cacheLit = cache.begin(), endCache = cache.end()
             ; cacheLit != endCache && !OK
             ; cacheLit++
@@ -0,0 +1,412 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos and collaborators. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+
+#include "gaussian.h"
+#include "solver.h"
+#include <algorithm>
+
+using namespace CMSat;
+using std::cout;
+using std::endl;
+
+const uint32_t Gaussian::noCol;
+
+Gaussian::Gaussian(
+    Solver* _solver
+    , const vector<Xor>& _xors
+    , const uint32_t _matrixNum
+) :
+    solver(_solver)
+    , matrixNum(_matrixNum)
+    , xors(_xors)
+    , numRows(0)
+    , numCols(0)
+    , visitNum(0)
+    , inConflict(false)
+{
+}
+
+bool Gaussian::init()
+{
+    assert(solver->okay());
+    assert(solver->decisionLevel() == 0);
+
+    //The columns are the variables, in order
+    varToCol.clear();
+    varToCol.resize(solver->nVars(), noCol);
+    colToVar.clear();
+    for(vector<Xor>::const_iterator
+        it = xors.begin(), end = xors.end()
+        ; it != end
+        ; it++
+    ) {
+        for(vector<Var>::const_iterator
+            it2 = it->vars.begin(), end2 = it->vars.end()
+            ; it2 != end2
+            ; it2++
+        ) {
+            assert(solver->value(*it2) == l_Undef);
+            if (varToCol[*it2] == noCol) {
+                varToCol[*it2] = 0;
+                colToVar.push_back(*it2);
+            }
+        }
+    }
+    std::sort(colToVar.begin(), colToVar.end());
+    for(uint32_t col = 0; col < colToVar.size(); col++) {
+        varToCol[colToVar[col]] = col;
+    }
+    numCols = colToVar.size();
+    numRows = xors.size();
+
+    mat.resize(numRows, numCols);
+    for(uint32_t row = 0; row < numRows; row++) {
+        mat.getMatrixAt(row).set(xors[row], varToCol);
+    }
+    vector<Xor>().swap(xors);
+
+    eliminate();
+    if (!solver->okay())
+        return false;
+
+    //Watch the first non-basic column of each row
+    colWatches.clear();
+    colWatches.resize(numCols);
+    rowWatch.clear();
+    rowWatch.resize(numRows, noCol);
+    rowKept.clear();
+    rowKept.resize(numRows, 0);
+    for(uint32_t row = 0; row < numRows; row++) {
+        const PackedRow r = mat.getMatrixAt(row);
+        colWatches[rowBasic[row]].push_back(row);
+
+        uint32_t col = r.nextBit(0);
+        if (col == rowBasic[row])
+            col = r.nextBit(col+1);
+
+        if (col < numCols) {
+            setWatch(row, col);
+            continue;
+        }
+
+        //Only the basic column is left, its variable is set
+        const Lit lit = Lit(colToVar[rowBasic[row]], !r.is_true());
+        solver->enqueue(lit);
+        stats.units++;
+    }
+
+    stats.numMatrices = 1;
+    stats.rows = numRows;
+    stats.cols = numCols;
+    if (solver->conf.verbosity >= 2) {
+        cout
+        << "c [gauss] matrix " << matrixNum
+        << " rows: " << numRows
+        << " cols: " << numCols
+        << " units: " << stats.units
+        << endl;
+    }
+
+    return true;
+}
+
+/**
+@brief Brings the matrix to reduced row echelon form
+
+The rows that become all-zero are removed. If one of them has its right hand
+side set, the problem is UNSAT.
+*/
+void Gaussian::eliminate()
+{
+    rowBasic.clear();
+
+    uint32_t active = 0;
+    for(uint32_t col = 0; col < numCols && active < numRows; col++) {
+        uint32_t row = active;
+        while(row < numRows && !mat.getMatrixAt(row)[col]) {
+            row++;
+        }
+        if (row == numRows)
+            continue;
+
+        if (row != active)
+            mat.getMatrixAt(active).swapBoth(mat.getMatrixAt(row));
+
+        const PackedRow pivotRow = mat.getMatrixAt(active);
+        for(uint32_t other = 0; other < numRows; other++) {
+            if (other != active && mat.getMatrixAt(other)[col])
+                mat.getMatrixAt(other) ^= pivotRow;
+        }
+
+        rowBasic.push_back(col);
+        active++;
+    }
+
+    for(uint32_t row = active; row < numRows; row++) {
+        assert(mat.getMatrixAt(row).isZero());
+        if (mat.getMatrixAt(row).is_true()) {
+            solver->ok = false;
+            return;
+        }
+    }
+    numRows = active;
+    mat.resizeNumRows(numRows);
+}
+
+/**
+@brief Updates the rows watching the column of 'var', which has just been set
+
+Rows that stopped watching it are removed from its watchlist. After a
+conflict, the remaining rows are only kept.
+*/
+bool Gaussian::propagate(const Var var, PropBy& confl)
+{
+    if (var >= varToCol.size() || varToCol[var] == noCol)
+        return true;
+
+    const uint32_t col = varToCol[var];
+    visitNum++;
+    inConflict = false;
+
+    //Rows may be added to the end while going through it, use indices
+    vector<uint32_t>& ws = colWatches[col];
+    size_t j = 0;
+    for(size_t i = 0; i < ws.size(); i++) {
+        const uint32_t row = ws[i];
+        if ((rowBasic[row] != col && rowWatch[row] != col)
+            || rowKept[row] == visitNum
+        ) {
+            continue;
+        }
+
+        if (!inConflict) {
+            stats.visited++;
+            if (rowBasic[row] == col)
+                basicSet(row, confl);
+            else
+                fixRow(row, confl);
+
+            if (rowBasic[row] != col && rowWatch[row] != col)
+                continue;
+        }
+
+        rowKept[row] = visitNum;
+        ws[j++] = row;
+    }
+    ws.resize(j);
+
+    return !inConflict;
+}
+
+/**
+@brief The variable of the basic column of 'row' has been set
+
+Another unset column of the row becomes the basic one, preferably not the
+watched one.
+*/
+void Gaussian::basicSet(const uint32_t row, PropBy& confl)
+{
+    const PackedRow r = mat.getMatrixAt(row);
+    uint32_t newBasic = noCol;
+    for(uint32_t col = r.nextBit(0); col < numCols; col = r.nextBit(col+1)) {
+        if (col == rowBasic[row]
+            || solver->value(colToVar[col]) != l_Undef
+        ) {
+            continue;
+        }
+
+        newBasic = col;
+        if (col != rowWatch[row])
+            break;
+    }
+
+    //All set, the basic variable was set last
+    if (newBasic == noCol) {
+        fixRow(row, confl);
+        return;
+    }
+
+    pivot(row, newBasic);
+    if (rowWatch[row] == newBasic)
+        fixRow(row, confl);
+
+    for(vector<uint32_t>::const_iterator
+        it = changedRows.begin(), end = changedRows.end()
+        ; it != end
+        ; it++
+    ) {
+        fixRow(*it, confl);
+    }
+}
+
+/**
+@brief Makes 'col' the basic column of 'row', XOR-ing the row into all others that have it
+*/
+void Gaussian::pivot(const uint32_t row, const uint32_t col)
+{
+    stats.pivots++;
+    rowBasic[row] = col;
+    if (rowWatch[row] != col)
+        colWatches[col].push_back(row);
+
+    changedRows.clear();
+    const PackedRow r = mat.getMatrixAt(row);
+    for(uint32_t other = 0; other < numRows; other++) {
+        if (other == row)
+            continue;
+
+        PackedRow o = mat.getMatrixAt(other);
+        if (o[col]) {
+            o ^= r;
+            changedRows.push_back(other);
+            stats.rowXors++;
+        }
+    }
+}
+
+/**
+@brief Makes sure the watched column of 'row' is an unset non-basic one
+
+If there is none, the watched column becomes the one set at the highest
+level, and the row propagates or is checked.
+*/
+void Gaussian::fixRow(const uint32_t row, PropBy& confl)
+{
+    const uint32_t watch = rowWatch[row];
+    if (watch != noCol
+        && watch != rowBasic[row]
+        && mat.getMatrixAt(row)[watch]
+        && solver->value(colToVar[watch]) == l_Undef
+    ) {
+        return;
+    }
+
+    uint32_t maxLevelCol;
+    const uint32_t col = findWatch(row, maxLevelCol);
+    if (col != noCol) {
+        setWatch(row, col);
+        return;
+    }
+
+    setWatch(row, maxLevelCol);
+    propOrConfl(row, confl);
+}
+
+/**
+@brief The first unset non-basic column of 'row', or noCol
+
+'maxLevelCol' is set to the set non-basic column with the highest level
+*/
+uint32_t Gaussian::findWatch(const uint32_t row, uint32_t& maxLevelCol) const
+{
+    const PackedRow r = mat.getMatrixAt(row);
+    maxLevelCol = noCol;
+    uint32_t maxLevel = 0;
+    for(uint32_t col = r.nextBit(0); col < numCols; col = r.nextBit(col+1)) {
+        if (col == rowBasic[row])
+            continue;
+
+        const Var var = colToVar[col];
+        if (solver->value(var) == l_Undef)
+            return col;
+
+        if (maxLevelCol == noCol || solver->varData[var].level > maxLevel) {
+            maxLevelCol = col;
+            maxLevel = solver->varData[var].level;
+        }
+    }
+
+    return noCol;
+}
+
+void Gaussian::setWatch(const uint32_t row, const uint32_t col)
+{
+    if (rowWatch[row] == col)
+        return;
+
+    rowWatch[row] = col;
+    if (col != noCol)
+        colWatches[col].push_back(row);
+}
+
+/**
+@brief All non-basic columns of 'row' are set: propagate its basic variable, or check it
+
+Nothing is done once a conflict has been found.
+*/
+void Gaussian::propOrConfl(const uint32_t row, PropBy& confl)
+{
+    if (inConflict)
+        return;
+
+    const PackedRow r = mat.getMatrixAt(row);
+    bool parity = r.is_true();
+    tmpClause.clear();
+    for(uint32_t col = r.nextBit(0); col < numCols; col = r.nextBit(col+1)) {
+        if (col == rowBasic[row])
+            continue;
+
+        const Var var = colToVar[col];
+        assert(solver->value(var) != l_Undef);
+        const bool isTrue = solver->value(var) == l_True;
+        parity ^= isTrue;
+        tmpClause.push_back(Lit(var, isTrue));
+    }
+
+    //The basic variable must be equal to 'parity'
+    const Var basicVar = colToVar[rowBasic[row]];
+    const lbool val = solver->value(basicVar);
+    if (val == l_Undef) {
+        const Lit lit = Lit(basicVar, !parity);
+        vector<Lit>& reason = solver->gaussReasons[basicVar];
+        reason.clear();
+        reason.push_back(lit);
+        reason.insert(reason.end(), tmpClause.begin(), tmpClause.end());
+        solver->enqueue(lit, PropBy(basicVar, xor_t, true));
+        stats.propagations++;
+        return;
+    }
+
+    if ((val == l_True) == parity)
+        return;
+
+    solver->gaussConflict.swap(tmpClause);
+    solver->gaussConflict.push_back(Lit(basicVar, val == l_True));
+    confl = PropBy(var_Undef, xor_t, true);
+    inConflict = true;
+    stats.conflicts++;
+}
+
+Gaussian::Stats& Gaussian::Stats::operator+=(const Stats& other)
+{
+    numMatrices += other.numMatrices;
+    rows += other.rows;
+    cols += other.cols;
+    units += other.units;
+    visited += other.visited;
+    pivots += other.pivots;
+    rowXors += other.rowXors;
+    propagations += other.propagations;
+    conflicts += other.conflicts;
+
+    return *this;
+}
@@ -0,0 +1,151 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos and collaborators. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+
+#ifndef __GAUSSIAN_H__
+#define __GAUSSIAN_H__
+
+#include <vector>
+#include <limits>
+#include "solvertypes.h"
+#include "propby.h"
+#include "packedmatrix.h"
+#include "xor.h"
+
+namespace CMSat {
+using std::vector;
+
+class Solver;
+
+/**
+@brief Propagates a set of XOR constraints as a matrix kept in reduced row echelon form
+
+The rows are the XORs, the columns their variables. Each row has a basic
+column that is in no other row, and watches one more, non-basic column. When
+the variable of a watched column is set, another unset non-basic column of the
+row is watched instead. When that of the basic column is set, an unset
+non-basic column becomes the basic one, and the row is XOR-ed into the others
+that have it. If no unset column is left, the basic variable is propagated, or
+the row is checked.
+
+If a row has an unset column, one of its two watched columns is unset. Once
+all are set, one of them is the one set at the highest level, so this still
+holds after backtracking.
+
+The clause that propagated a variable is stored in PropEngine::gaussReasons,
+that of a conflict in PropEngine::gaussConflict.
+*/
+class Gaussian
+{
+    public:
+        Gaussian(Solver* solver, const vector<Xor>& xors, const uint32_t matrixNum);
+
+        ///Put the XORs in the matrix and eliminate. Returns FALSE if UNSAT
+        bool init();
+
+        ///Tell the matrix 'var' has been set. Returns FALSE on conflict
+        bool propagate(const Var var, PropBy& confl);
+
+        struct Stats
+        {
+            Stats() :
+                numMatrices(0)
+                , rows(0)
+                , cols(0)
+                , units(0)
+                , visited(0)
+                , pivots(0)
+                , rowXors(0)
+                , propagations(0)
+                , conflicts(0)
+            {}
+
+            Stats& operator+=(const Stats& other);
+
+            uint64_t numMatrices;
+            uint64_t rows;
+            uint64_t cols;
+            uint64_t units; ///<Found when the matrices were built
+            uint64_t visited;
+            uint64_t pivots;
+            uint64_t rowXors;
+            uint64_t propagations;
+            uint64_t conflicts;
+        };
+
+        const Stats& getStats() const;
+        uint32_t getNumRows() const;
+        uint32_t getNumCols() const;
+
+    private:
+        Solver* solver;
+        const uint32_t matrixNum;
+        vector<Xor> xors;
+        PackedMatrix mat;
+        uint32_t numRows;
+        uint32_t numCols;
+        static const uint32_t noCol = std::numeric_limits<uint32_t>::max();
+
+        //Columns
+        vector<Var> colToVar;
+        vector<uint32_t> varToCol; ///<noCol if the variable is not in the matrix
+        vector<vector<uint32_t> > colWatches; ///<Rows watching the column. May be stale
+
+        //Rows
+        vector<uint32_t> rowBasic;
+        vector<uint32_t> rowWatch; ///<The watched non-basic column
+        vector<uint64_t> rowKept; ///<So that a row is only kept once in a watchlist
+
+        void eliminate();
+        void basicSet(const uint32_t row, PropBy& confl);
+        void pivot(const uint32_t row, const uint32_t col);
+        void fixRow(const uint32_t row, PropBy& confl);
+        uint32_t findWatch(const uint32_t row, uint32_t& maxLevelCol) const;
+        void setWatch(const uint32_t row, const uint32_t col);
+        void propOrConfl(const uint32_t row, PropBy& confl);
+
+        //Temporaries
+        vector<uint32_t> changedRows;
+        vector<Lit> tmpClause;
+        uint64_t visitNum;
+        bool inConflict;
+
+        Stats stats;
+};
+
+inline const Gaussian::Stats& Gaussian::getStats() const
+{
+    return stats;
+}
+
+inline uint32_t Gaussian::getNumRows() const
+{
+    return numRows;
+}
+
+inline uint32_t Gaussian::getNumCols() const
+{
+    return numCols;
+}
+
+} //end namespace
+
+#endif //__GAUSSIAN_H__
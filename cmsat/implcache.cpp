@@ -137,7 +137,7 @@ bool ImplCache::clean(Solver* solver)
                     #ifdef DRUP
                     if (solver->drup) {
                         *(solver->drup)
-                        << lit << " 0\n";
+                        << lit << DrupFlag::fin;
                     }
                     #endif
 
@@ -151,11 +151,11 @@ bool ImplCache::clean(Solver* solver)
             || solver->varData[var].removed == Removed::replaced
             || solver->varData[var].removed == Removed::decomposed
         ) {
-            vector<LitExtra> tmp1;
+            LitExtraVec tmp1;
             numFreed += implCache[Lit(var, false).toInt()].lits.capacity();
             implCache[Lit(var, false).toInt()].lits.swap(tmp1);
 
-            vector<LitExtra> tmp2;
+            LitExtraVec tmp2;
             numFreed += implCache[Lit(var, true).toInt()].lits.capacity();
             implCache[Lit(var, true).toInt()].lits.swap(tmp2);
         }
@@ -175,9 +175,9 @@ bool ImplCache::clean(Solver* solver)
 
         //Update to replaced vars, remove vars already set or eliminated
         Lit vertLit = Lit::toLit(wsLit);
-        vector<LitExtra>::iterator it = trans->lits.begin();
-        vector<LitExtra>::iterator it2 = it;
-        for (vector<LitExtra>::iterator end = trans->lits.end(); it != end; it++) {
+        LitExtraVec::iterator it = trans->lits.begin();
+        LitExtraVec::iterator it2 = it;
+        for (LitExtraVec::iterator end = trans->lits.end(); it != end; it++) {
             Lit lit = it->getLit();
             assert(lit.var() != vertLit.var());
 
@@ -218,7 +218,7 @@ bool ImplCache::clean(Solver* solver)
         //1) set nonLearnt right (above we might have it set later)
         //2) clear 'inside'
         //3) clear 'nonLearnt'
-        for (vector<LitExtra>::iterator it = trans->lits.begin(), end = trans->lits.end(); it != end; it++) {
+        for (LitExtraVec::iterator it = trans->lits.begin(), end = trans->lits.end(); it != end; it++) {
             Lit lit = it->getLit();
 
             //Clear 'inside'
@@ -389,14 +389,14 @@ void ImplCache::tryVar(
 
     Lit lit = Lit(var, false);
 
-    const vector<LitExtra>& cache1 = implCache[lit.toInt()].lits;
+    const LitExtraVec& cache1 = implCache[lit.toInt()].lits;
     assert(solver->watches.size() > (lit.toInt()));
     const vec<Watched>& ws1 = solver->watches[lit.toInt()];
-    const vector<LitExtra>& cache2 = implCache[(~lit).toInt()].lits;
+    const LitExtraVec& cache2 = implCache[(~lit).toInt()].lits;
     const vec<Watched>& ws2 = solver->watches[(~lit).toInt()];
 
     //Fill 'seen' and 'val' from cache
-    for (vector<LitExtra>::const_iterator
+    for (LitExtraVec::const_iterator
         it = cache1.begin(), end = cache1.end()
         ; it != end
         ; it++
@@ -437,7 +437,7 @@ void ImplCache::tryVar(
 
     //Try to see if we propagate the same or opposite from the other end
     //Using cache
-    for (vector<LitExtra>::const_iterator
+    for (LitExtraVec::const_iterator
         it = cache2.begin(), end = cache2.end()
         ; it != end
         ; it++
@@ -475,7 +475,7 @@ void ImplCache::tryVar(
     }
 
     //Clear 'seen' and 'val'
-    for (vector<LitExtra>::const_iterator it = cache1.begin(), end = cache1.end(); it != end; it++) {
+    for (LitExtraVec::const_iterator it = cache1.begin(), end = cache1.end(); it != end; it++) {
         seen[it->getLit().var()] = false;
         val[it->getLit().var()] = false;
     }
@@ -490,7 +490,7 @@ void ImplCache::tryVar(
 }
 
 bool TransCache::merge(
-    const vector<LitExtra>& otherLits //Lits to add
+    const LitExtraVec& otherLits //Lits to add
     , const Lit extraLit //Add this, too to the list of lits
     , const bool learnt //The step was a learnt step?
     , const Var leaveOut //Leave this literal out
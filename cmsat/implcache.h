@@ -28,6 +28,7 @@
 #include <vector>
 #include "constants.h"
 #include "solvertypes.h"
+#include "memtracker.h"
 
 namespace CMSat {
 
@@ -78,6 +79,8 @@ private:
 
 };
 
+typedef std::vector<LitExtra, TrackedAlloc<LitExtra, MemTag::implcache> > LitExtraVec;
+
 class TransCache {
 public:
     TransCache()
@@ -85,7 +88,7 @@ public:
     {};
 
     bool merge(
-        const vector<LitExtra>& otherLits
+        const LitExtraVec& otherLits
         , const Lit extraLit
         , const bool learnt
         , const Var leaveOut
@@ -102,7 +105,7 @@ public:
 
     void updateVars(const std::vector< uint32_t >& outerToInter);
 
-    std::vector<LitExtra> lits;
+    LitExtraVec lits;
     //uint64_t conflictLastUpdated;
 
 private:
@@ -0,0 +1,191 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos and collaborators. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#include "inprocsched.h"
+#include "solver.h"
+#include "time_mem.h"
+#include <iomanip>
+
+using namespace CMSat;
+using std::cout;
+using std::endl;
+
+InprocSched::InprocSched(Solver* _solver) :
+    solver(_solver)
+    , numRounds(0)
+    , startTime(0)
+    , startFreeVars(0)
+    , startIrredLits(0)
+    , startTrailSize(0)
+{
+}
+
+double InprocSched::budget(const Inproc tech) const
+{
+    if (!solver->conf.doInprocSched)
+        return 1.0;
+
+    return techs[(int)tech].mult;
+}
+
+bool InprocSched::shouldRun(const Inproc tech)
+{
+    if (!solver->conf.doInprocSched)
+        return true;
+
+    Tech& t = techs[(int)tech];
+    //With inprocStarvedEvery of 0, starved techniques are never run
+    const uint32_t every = solver->conf.inprocStarvedEvery;
+    if (t.mult <= solver->conf.inprocMinBudget
+        && (every == 0 || numRounds % every != 0)
+    ) {
+        t.skipped++;
+        return false;
+    }
+
+    return true;
+}
+
+void InprocSched::start(const Inproc)
+{
+    startTime = cpuTime();
+    startFreeVars = solver->getNumFreeVars();
+    startIrredLits = solver->binTri.irredLits;
+    startTrailSize = solver->trail.size();
+}
+
+void InprocSched::finish(const Inproc tech)
+{
+    Tech& t = techs[(int)tech];
+    const double time = cpuTime() - startTime;
+    const size_t freeVars = solver->getNumFreeVars();
+    const uint64_t irredLits = solver->binTri.irredLits;
+
+    //Var-elim may add literals, and units may be found without removing vars
+    const size_t varsRem = freeVars < startFreeVars ? startFreeVars - freeVars : 0;
+    const uint64_t litsRem = irredLits < startIrredLits ? startIrredLits - irredLits : 0;
+
+    t.calls++;
+    t.cpu_time += time;
+    t.varsRem += varsRem;
+    t.litsRem += litsRem;
+    t.units += solver->trail.size() - startTrailSize;
+
+    t.ranThisRound = true;
+    t.roundTime += time;
+    if (startFreeVars > 0)
+        t.roundGain += (double)varsRem/(double)startFreeVars;
+    if (startIrredLits > 0)
+        t.roundGain += (double)litsRem/(double)startIrredLits;
+}
+
+void InprocSched::endRound()
+{
+    numRounds++;
+    if (!solver->conf.doInprocSched)
+        return;
+
+    //Average payoff per second of the techniques that ran
+    double sumRate = 0;
+    size_t numRan = 0;
+    for(const Tech& t: techs) {
+        if (!t.ranThisRound)
+            continue;
+
+        sumRate += t.roundGain/std::max(t.roundTime, 0.001);
+        numRan++;
+    }
+    if (numRan == 0)
+        return;
+
+    const double avgRate = sumRate/(double)numRan;
+    for(Tech& t: techs) {
+        if (!t.ranThisRound)
+            continue;
+
+        const double rate = t.roundGain/std::max(t.roundTime, 0.001);
+        if (t.roundGain == 0) {
+            t.mult *= 0.5;
+        } else if (rate >= avgRate) {
+            t.mult *= 1.5;
+        } else {
+            t.mult *= 0.8;
+        }
+        t.mult = std::max(t.mult, solver->conf.inprocMinBudget);
+        t.mult = std::min(t.mult, solver->conf.inprocMaxBudget);
+    }
+
+    if (solver->conf.verbosity >= 2) {
+        cout << "c [sched] budgets:";
+        for(int i = 0; i < (int)Inproc::num_techniques; i++) {
+            const Tech& t = techs[i];
+            cout << " " << inproc_to_string((Inproc)i) << " ";
+            if (!t.ranThisRound) {
+                cout << "skip";
+            } else {
+                cout
+                << std::fixed << std::setprecision(2)
+                << t.roundGain/std::max(t.roundTime, 0.001)
+                << "/s";
+            }
+            cout
+            << " -> x" << std::fixed << std::setprecision(2) << t.mult;
+        }
+        cout << endl;
+    }
+
+    for(Tech& t: techs) {
+        t.ranThisRound = false;
+        t.roundTime = 0;
+        t.roundGain = 0;
+    }
+}
+
+void InprocSched::print() const
+{
+    cout << "c ----- INPROCESSING SCHEDULER STATS --------" << endl;
+    printStatsLine("c rounds"
+        , numRounds
+    );
+    for(int i = 0; i < (int)Inproc::num_techniques; i++) {
+        const Tech& t = techs[i];
+        const string name = inproc_to_string((Inproc)i);
+        printStatsLine("c " + name + " calls"
+            , t.calls
+            , t.skipped
+            , "skipped"
+        );
+        printStatsLine("c " + name + " time"
+            , t.cpu_time
+            , t.mult
+            , "budget mult"
+        );
+        printStatsLine("c " + name + " vars rem"
+            , t.varsRem
+            , t.units
+            , "units"
+        );
+        printStatsLine("c " + name + " irred lits rem"
+            , t.litsRem
+        );
+    }
+    cout << "c ----- INPROCESSING SCHEDULER STATS END --------" << endl;
+}
@@ -0,0 +1,146 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos and collaborators. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#ifndef __INPROCSCHED_H__
+#define __INPROCSCHED_H__
+
+#include <string>
+#include "solvertypes.h"
+
+namespace CMSat {
+
+class Solver;
+
+/**
+@brief The simplifications whose budget is set by InprocSched
+*/
+enum class Inproc {
+    probe = 0   ///<Failed literal probing
+    , vivify    ///<Clause vivification, cache- and propagation-based
+    , simplify  ///<Occurrence-based: subsumption, var-elim, blocked clauses...
+    , implicit  ///<Subsumption&strengthening of the binary&tertiary clauses
+    , num_techniques ///<Must be last
+};
+
+inline std::string inproc_to_string(const Inproc tech)
+{
+    switch(tech) {
+        case Inproc::probe:
+            return "probe";
+
+        case Inproc::vivify:
+            return "vivify";
+
+        case Inproc::simplify:
+            return "simplify";
+
+        case Inproc::implicit:
+            return "implicit";
+
+        case Inproc::num_techniques:
+            break;
+    }
+
+    assert(false && "oops, one of the inprocessing techniques has no string name");
+
+    return "Ooops, undefined!";
+}
+
+/**
+@brief Gives each inprocessing technique a budget based on its earlier payoff
+
+Every call of a technique in simplifyProblem() is wrapped into start() and
+finish(), which measure the time it took, and how much it reduced the number of
+free variables and irredundant literals (units found count as free variables
+removed). The payoff of a technique in a round is the relative reduction of
+both, per second.
+
+At the end of each round the multipliers of the techniques are updated: one
+that has paid off better than the average of the round gets more, one that has
+paid off less gets a bit less, and one that has not paid off at all gets half.
+The techniques scale their own time limits with budget(). A technique whose
+multiplier is at the minimum is starved: it is only run every few rounds, to
+see whether it has become useful again.
+*/
+class InprocSched
+{
+    public:
+        InprocSched(Solver* solver);
+
+        ///Multiplier for the time limits of the technique
+        double budget(const Inproc tech) const;
+
+        ///False if the technique is starved and it's not its turn
+        bool shouldRun(const Inproc tech);
+
+        void start(const Inproc tech);
+        void finish(const Inproc tech);
+
+        ///Update the multipliers based on the round that has just finished
+        void endRound();
+
+        void print() const;
+
+    private:
+        Solver* solver;
+
+        struct Tech
+        {
+            Tech() :
+                mult(1.0)
+                , ranThisRound(false)
+                , roundTime(0)
+                , roundGain(0)
+                , calls(0)
+                , skipped(0)
+                , cpu_time(0)
+                , varsRem(0)
+                , litsRem(0)
+                , units(0)
+            {}
+
+            //Budget
+            double   mult;
+            bool     ranThisRound;
+            double   roundTime;
+            double   roundGain;
+
+            //Stats
+            uint64_t calls;
+            uint64_t skipped;
+            double   cpu_time;
+            uint64_t varsRem;
+            uint64_t litsRem;
+            uint64_t units;
+        };
+        Tech techs[(int)Inproc::num_techniques];
+        uint64_t numRounds;
+
+        //Snapshot taken at start()
+        double   startTime;
+        size_t   startFreeVars;
+        uint64_t startIrredLits;
+        size_t   startTrailSize;
+};
+
+} //end namespace
+
+#endif //__INPROCSCHED_H__
@@ -240,7 +240,7 @@ void Main::printResultFunc(
     if (ret == l_True && (printResult || toFile)) {
 
         if(!toFile) *os << "v ";
-        for (Var var = 0; var != solver->nVarsReal(); var++) {
+        for (Var var = 0; var != solver->nVarsOutside(); var++) {
             if (solver->model[var] != l_Undef)
                 *os << ((solver->model[var] == l_True)? "" : "-") << var+1 << " ";
         }
@@ -287,6 +287,8 @@ void Main::parseCommandLine()
     #ifdef DRUP
     string drupfilname;
     int drupExistsCheck = 1;
+    string drupFormat = "binary";
+    int drupCompress = 0;
     #endif
 
     // Declare the supported options.
@@ -307,8 +309,18 @@ void Main::parseCommandLine()
         , "Perform regular simplification rounds")
     ("simplify", po::value<int>(&conf.doSimplify)->default_value(conf.doSimplify)
         , "Perform occurrence-list-based optimisations (var-elim, subsumption, blocking, etc)")
+    ("simpthreads", po::value<uint32_t>(&conf.numSimpThreads)->default_value(conf.numSimpThreads)
+        , "Threads used by occurrence-list-based optimisations. With more than 1, subsumption&strengthening tries every clause, and resolvents for var-elim are calculated for batches of variables, in parallel")
     ("clbtwsimp", po::value<uint64_t>(&conf.numCleanBetweenSimplify)->default_value(conf.numCleanBetweenSimplify)
         , "Perform this many cleaning iterations between simplification rounds")
+    ("inprocsched", po::value<int>(&conf.doInprocSched)->default_value(conf.doInprocSched)
+        , "Give each simplification a time budget based on how many variables and literals it removed per second in earlier rounds")
+    ("inprocmin", po::value<double>(&conf.inprocMinBudget)->default_value(conf.inprocMinBudget)
+        , "Lowest budget multiplier of a simplification. Ones at this level are only run every --inprocstarve rounds")
+    ("inprocmax", po::value<double>(&conf.inprocMaxBudget)->default_value(conf.inprocMaxBudget)
+        , "Highest budget multiplier of a simplification")
+    ("inprocstarve", po::value<uint32_t>(&conf.inprocStarvedEvery)->default_value(conf.inprocStarvedEvery)
+        , "Run starved simplifications only every this many rounds")
     ("recur", po::value<int>(&conf.doRecursiveMinim)->default_value(conf.doRecursiveMinim)
         , "Perform recursive minimisation")
     ("unsat", po::value<int>(&conf.optimiseUnsat)->default_value(conf.optimiseUnsat)
@@ -318,6 +330,10 @@ void Main::parseCommandLine()
         , "Put DRUP verification information into this file")
     ("drupexistscheck", po::value<int>(&drupExistsCheck)->default_value(drupExistsCheck)
         , "Check if the drup file provided already exists")
+    ("drupformat", po::value<string>(&drupFormat)->default_value(drupFormat)
+        , "{binary,text}. Binary DRAT is faster to write and smaller. --drupdebug always uses text")
+    ("drupcompress", po::value<int>(&drupCompress)->default_value(drupCompress)
+        , "[0..9] gzip the DRUP file on the fly at this level. 0 = no compression")
     ("drupdebug", po::bool_switch(&drupDebug)
         , "Output DRUP verification into the console. Helpful to see where DRUP fails -- use in conjunction with --verb 20. The --drup option must still be given")
     #endif
@@ -336,13 +352,19 @@ void Main::parseCommandLine()
     ("agilg", po::value<double>(&conf.agilityG)->default_value(conf.agilityG, ssAgilG.str())
         , "See paper by Armin Biere on agilities")
     ("restart", po::value<string>()
-        , "{geom, agility, glue, glueagility}  Restart strategy to follow.")
+        , "{geom, agility, glue, glueagility, bandit}  Restart strategy to follow. 'bandit' -> choose among the others before every simplification round, based on the glues of the clauses they led to learn")
+    ("banditexplore", po::value<double>(&conf.restartBanditExplore)->default_value(conf.restartBanditExplore)
+        , "Exploration factor of the restart strategy bandit. Higher values try the less successful strategies more often")
     ("agillim", po::value<double>(&conf.agilityLimit)->default_value(conf.agilityLimit, ssAgilL.str())
         , "The agility below which the agility is considered too low")
     ("agilviollim", po::value<uint64_t>(&conf.agilityViolationLimit)->default_value(conf.agilityViolationLimit)
         , "Number of agility limit violations over which to demand a restart")
     ("gluehist", po::value<uint32_t>(&conf.shortTermHistorySize)->default_value(conf.shortTermHistorySize)
         , "The size of the moving window for short-term glue history of learnt clauses. If higher, the minimal number of conflicts between restarts is longer")
+    ("chrono", po::value<int>(&conf.doChronoBT)->default_value(conf.doChronoBT)
+        , "Backtrack chronologically (only one level) if the backjump would be long")
+    ("chronothresh", po::value<uint32_t>(&conf.chronoBTThreshold)->default_value(conf.chronoBTThreshold)
+        , "Backjumps over more than this many levels are done chronologically")
     ;
 
     po::options_description reduceDBOptions("Learnt clause removal options");
@@ -350,7 +372,11 @@ void Main::parseCommandLine()
     ("ltclean", po::value<double>(&conf.ratioRemoveClauses)->default_value(conf.ratioRemoveClauses)
         , "Remove at least this ratio of learnt clauses when doing learnt clause-cleaning")
     ("clean", po::value<string>(&typeclean)->default_value(getNameOfCleanType(conf.clauseCleaningType))
-        , "Metric to use to clean clauses: 'size', 'glue', 'activity' or 'propconfl' for sum of propagations and conflicts caused in last iteration")
+        , "Metric to use to clean clauses: 'size', 'glue', 'activity' or 'propconfl' for sum of propagations and conflicts caused in last iteration. 'tiered' keeps low-glue clauses, and used mid-glue ones, and cleans the rest by propconfl")
+    ("tiercore", po::value<uint32_t>(&conf.tierCoreGlue)->default_value(conf.tierCoreGlue)
+        , "With tiered cleaning, learnt clauses with at most this glue are kept forever")
+    ("tiermid", po::value<uint32_t>(&conf.tierMidGlue)->default_value(conf.tierMidGlue)
+        , "With tiered cleaning, learnt clauses with at most this glue are kept while they are used")
     ("preclean", po::value<int>(&conf.doPreClauseCleanPropAndConfl)->default_value(conf.doPreClauseCleanPropAndConfl)
         , "Before cleaning clauses with whatever sorting strategy, remove learnt clauses whose sum of props&conflicts during last iteration is less than 'precleanlimit'")
     ("precleanlim", po::value<uint32_t>(&conf.preClauseCleanLimit)->default_value(conf.preClauseCleanLimit)
@@ -381,6 +407,18 @@ void Main::parseCommandLine()
         , "[0 - 1] freq. of picking var at random")
     ("polar", po::value<string>()->default_value("auto")
         , "{true,false,rnd,auto} Selects polarity mode. 'true' -> selects only positive polarity when branching. 'false' -> selects only negative polarity when brancing. 'auto' -> selects last polarity used (also called 'caching')")
+    ("branch", po::value<string>()->default_value("vsids")
+        , "{vsids,vmtf,auto} Decision heuristic. 'vsids' -> activity heap. 'vmtf' -> variable-move-to-front queue. 'auto' -> VMTF when restarts are glue- or agility-based, VSIDS when they are geometric")
+    ("target", po::value<int>(&conf.doTargetPhase)->default_value(conf.doTargetPhase)
+        , "{0,1,2} Decide on the polarities of the longest conflict-free trail since the last restart. 0 -> never, 1 -> only with geometric restarts, 2 -> always")
+    ("rephase", po::value<int>(&conf.doRephase)->default_value(conf.doRephase)
+        , "Periodically reset saved polarities to best, original (Jeroslow-Wang), inverted or random")
+    ("rephaseint", po::value<uint64_t>(&conf.rephaseInterval)->default_value(conf.rephaseInterval)
+        , "Conflicts between rephases, multiplied by the number of rephases so far")
+    ("sls", po::value<int>(&conf.doSLS)->default_value(conf.doSLS)
+        , "Rephase with the best assignment of a stochastic local search (ProbSAT) run. If it finds a model, solving finishes with it. Only used with --rephase 1")
+    ("slswork", po::value<uint64_t>(&conf.slsWorkLimit)->default_value(conf.slsWorkLimit)
+        , "Number of literals a local search run may visit")
     ("dompickf", po::value<uint32_t>(&conf.dominPickFreq)->default_value(conf.dominPickFreq)
         , "Use dominating literal every once in N when picking decision literal")
     ("flippolf", po::value<uint32_t>(&conf.flipPolarFreq)->default_value(conf.flipPolarFreq)
@@ -429,6 +467,8 @@ void Main::parseCommandLine()
         , "Sort variable elimination order by guessing(0) or by calculation(1)")
     ("elimcomplexupdate", po::value<int>(&conf.updateVarElimComplexityOTF)->default_value(conf.updateVarElimComplexityOTF)
         , "Update estimated elimination complexity on-the-fly while eliminating")
+    ("incelimscore", po::value<int>(&conf.incVarElimScore)->default_value(conf.incVarElimScore)
+        , "Keep estimated elimination complexities between simplification rounds, and only re-calculate them for variables whose clauses have changed")
     ("elimcoststrategy", po::value<int>(&conf.varElimCostEstimateStrategy)->default_value(conf.varElimCostEstimateStrategy)
         , "How simple strategy (guessing, above) is calculated. Valid values: [0..1]")
     ("subsume1", po::value<int>(&conf.doSubsume1)->default_value(conf.doSubsume1)
@@ -437,6 +477,10 @@ void Main::parseCommandLine()
         , "Do blocked-clause removal")
     ("asymmte", po::value<int>(&conf.doAsymmTE)->default_value(conf.doAsymmTE)
         , "Do asymmetric tautology elimination. See Armin Biere & collaborators' papers")
+    ("bva", po::value<int>(&conf.doBVA)->default_value(conf.doBVA)
+        , "Do bounded variable addition: replace grids of clauses with new variables. New variables cannot be added after solving if it's on")
+    ("bvalimit", po::value<uint64_t>(&conf.bvaLimitM)->default_value(conf.bvaLimitM)
+        , "Time limit of bounded variable addition, in millions of occurrence list entries visited")
     ("noextbinsubs", po::value<int>(&conf.doExtBinSubs)->default_value(conf.doExtBinSubs)
         , "No extended subsumption with binary clauses")
     ("eratio", po::value<double>(&conf.varElimRatioPerIter)->default_value(conf.varElimRatioPerIter, ssERatio.str())
@@ -463,6 +507,18 @@ void Main::parseCommandLine()
     //    , "Mix XORs and OrGates for new truths")
     ;
 
+    po::options_description gaussOptions("Gauss-Jordan options");
+    gaussOptions.add_options()
+    ("gauss", po::value<int>(&conf.doGauss)->default_value(conf.doGauss)
+        , "Propagate the XORs that share variables through Gauss-Jordan matrices during search. While a matrix is in use, on-the-fly hyper-binary resolution (--otfhyper) is switched off")
+    ("maxnummatrixes", po::value<uint32_t>(&conf.gaussMaxNumMatrixes)->default_value(conf.gaussMaxNumMatrixes)
+        , "Maximum number of matrices, the largest sets of XORs are used")
+    ("minmatrixrows", po::value<uint32_t>(&conf.gaussMinMatrixRows)->default_value(conf.gaussMinMatrixRows)
+        , "Smaller sets of XORs are propagated one by one")
+    ("maxmatrixrows", po::value<uint32_t>(&conf.gaussMaxMatrixRows)->default_value(conf.gaussMaxMatrixRows)
+        , "Larger sets of XORs are propagated one by one")
+    ;
+
     po::options_description eqLitOpts("Equivalent literal options");
     eqLitOpts.add_options()
     ("scc", po::value<int>(&conf.doFindAndReplaceEqLits)->default_value(conf.doFindAndReplaceEqLits)
@@ -514,6 +570,14 @@ void Main::parseCommandLine()
         , "Perform lazy hyper-binary resolution while propagating")
     ("binpri", po::value<int>(&conf.propBinFirst)->default_value(conf.propBinFirst)
         , "Propagated binary clauses strictly first")
+    ("trailsave", po::value<int>(&conf.doTrailSave)->default_value(conf.doTrailSave)
+        , "Save the trail undone by backjumps and re-set its implications without walking the watchlists")
+    ("card", po::value<int>(&conf.doCardFind)->default_value(conf.doCardFind)
+        , "Find at-most-one constraints among the binary clauses and propagate them natively during search")
+    ("cardmin", po::value<uint32_t>(&conf.cardMinSize)->default_value(conf.cardMinSize)
+        , "Smallest at-most-one constraint to propagate natively")
+    ("cardlimit", po::value<uint64_t>(&conf.cardFindLimitM)->default_value(conf.cardFindLimitM)
+        , "Time limit of finding at-most-one constraints, in millions of watchlist entries visited")
     ("otfhyper", po::value<int>(&conf.otfHyperbin)->default_value(conf.otfHyperbin)
         , "Perform hyper-binary resolution at dec. level 1 after every restart and during probing")
     ;
@@ -555,6 +619,8 @@ void Main::parseCommandLine()
         , "SQL database name. Default is used by PHP system, so it's highly recommended")
     ("sqlserver", po::value<string>(&conf.sqlServer)->default_value(conf.sqlServer)
         , "SQL server hostname/IP")
+    ("sqlmaxqueue", po::value<uint64_t>(&conf.sqlMaxQueued)->default_value(conf.sqlMaxQueued)
+        , "Max. number of stats rows waiting to be written to SQL. Further rows are dropped")
     ;
 
     po::options_description printOptions("Printing options");
@@ -578,6 +644,12 @@ void Main::parseCommandLine()
     //("noparts", "Don't find&solve subproblems with subsolvers")
     ("vivif", po::value<int>(&conf.doClausVivif)->default_value(conf.doClausVivif)
         , "Regularly execute clause vivification")
+    ("bgsimp", po::value<int>(&conf.doBgSimp)->default_value(conf.doBgSimp)
+        , "Vivify and subsume the new low-glue learnt clauses on a background thread, merging the results at restarts")
+    ("bgsimpevery", po::value<uint64_t>(&conf.bgSimpEvery)->default_value(conf.bgSimpEvery)
+        , "Start a background vivification job every this many conflicts")
+    ("bgsimpbudget", po::value<uint64_t>(&conf.bgSimpBudgetM)->default_value(conf.bgSimpBudgetM)
+        , "Propagation budget of a background vivification job, in millions")
     ("sortwatched", po::value<int>(&conf.doSortWatched)->default_value(conf.doSortWatched)
         , "Sort watches according to size")
     ("renumber", po::value<int>(&conf.doRenumberVars)->default_value(conf.doRenumberVars)
@@ -586,6 +658,10 @@ void Main::parseCommandLine()
         , "Save memory by deallocating variable space after renumbering. Only works if renumbering is active.")
     ("implicitmanip", po::value<int>(&conf.doStrSubImplicit)->default_value(conf.doStrSubImplicit)
         , "Subsume and strengthen implicit clauses with each other")
+    ("maxmem", po::value<uint64_t>(&conf.maxMemMB)->default_value(conf.maxMemMB)
+        , "Memory budget of the process in MB. When approaching it, the solver sheds load: drops the implication cache, the stamps, cleans learnt clauses aggressively, limits occurrence lists and stops making component sub-solvers. 0 = no budget")
+    ("memshedratio", po::value<double>(&conf.memShedRatio)->default_value(conf.memShedRatio)
+        , "Start shedding load when this ratio of the memory budget ('maxmem') is used")
     ;
 
     po::options_description componentOptions("Component options");
@@ -630,9 +706,7 @@ void Main::parseCommandLine()
     //Currently unimplemented
     //.add(gateOptions)
 
-    #ifdef USE_GAUSS
     .add(gaussOptions)
-    #endif
     #ifdef USE_MYSQL
     .add(sqlOptions)
     #endif
@@ -740,6 +814,15 @@ void Main::parseCommandLine()
         else throw WrongParam(mode, "unknown polarity-mode");
     }
 
+    if (vm.count("branch")) {
+        string type = vm["branch"].as<string>();
+
+        if (type == "vsids") conf.branchType = Branch::vsids;
+        else if (type == "vmtf") conf.branchType = Branch::vmtf;
+        else if (type == "auto") conf.branchType = Branch::automatic;
+        else throw WrongParam(type, "unknown branching heuristic");
+    }
+
     if (conf.random_var_freq < 0 || conf.random_var_freq > 1) {
         WrongParam(lexical_cast<string>(conf.random_var_freq), "Illegal random var frequency ");
     }
@@ -767,6 +850,8 @@ void Main::parseCommandLine()
         conf.clauseCleaningType = CLEAN_CLAUSES_PROPCONFL_BASED;
     } else if (typeclean == "activity") {
         conf.clauseCleaningType = CLEAN_CLAUSES_ACTIVITY_BASED;
+    } else if (typeclean == "tiered") {
+        conf.clauseCleaningType = CLEAN_CLAUSES_TIERED;
     } else {
         std::cerr
         << "ERROR: Cannot parse option given to '--clean'. It's '"
@@ -776,52 +861,6 @@ void Main::parseCommandLine()
         exit(-1);
     }
 
-    //XOR finding
-
-    #ifdef USE_GAUSS
-    if (vm.count("gaussuntil")) {
-        gaussconfig.decision_until = vm["gaussuntil"].as<uint32_t>();
-    }
-
-    if (vm.count("nodisablegauss")) {
-        gaussconfig.dontDisable = true;
-    }
-
-    if (vm.count("maxnummatrixes")) {
-        gaussconfig.maxNumMatrixes = vm["maxnummatrixes"].as<uint32_t>();
-    }
-
-    if (vm.count("nosepmatrix")) {
-        gaussconfig.doSeparateMatrixFind = false;
-    }
-
-    if (vm.count("noiterreduce")) {
-        gaussconfig.iterativeReduce = false;
-    }
-
-    if (vm.count("noiterreduce")) {
-        gaussconfig.iterativeReduce = false;
-    }
-
-    if (vm.count("noordercol")) {
-        gaussconfig.orderCols = false;
-    }
-
-    if (vm.count("maxmatrixrows")) {
-        gaussconfig.maxMatrixRows = vm["maxmatrixrows"].as<uint32_t>();
-    }
-
-
-    if (vm.count("minmatrixrows")) {
-        gaussconfig.minMatrixRows = vm["minmatrixrows"].as<uint32_t>();
-    }
-
-
-    if (vm.count("savematrix")) {
-        gaussconfig.only_nth_gauss_save = vm["savematrix"].as<uint32_t>();
-    }
-    #endif //USE_GAUSS
-
     if (vm.count("restart")) {
         string type = vm["restart"].as<string>();
         if (type == "geom")
@@ -832,6 +871,8 @@ void Main::parseCommandLine()
             conf.restartType = Restart::agility;
         else if (type == "glueagility")
             conf.restartType = Restart::glue_agility;
+        else if (type == "bandit")
+            conf.restartType = Restart::bandit;
         else throw WrongParam("restart", "unknown restart type");
     }
 
@@ -841,6 +882,12 @@ void Main::parseCommandLine()
     if (numThreads > 1)
         throw WrongParam("threads", "Currently, more than 1 thread is not supported. Sorry!");
 
+    if (conf.numSimpThreads < 1)
+        throw WrongParam("simpthreads", "Num threads must be at least 1");
+
+    if (conf.inprocStarvedEvery < 1)
+        throw WrongParam("inprocstarve", "Must be at least 1");
+
 
     //If the number of solutions requested is more than 1, we need to disable blocking
     if (max_nr_of_solutions > 1) {
@@ -861,8 +908,17 @@ void Main::parseCommandLine()
 
     #ifdef DRUP
     if (vm.count("drup")) {
+        if (drupFormat != "binary" && drupFormat != "text") {
+            cout
+            << "ERROR: DRUP format '" << drupFormat << "' not recognised."
+            << " Use 'binary' or 'text'"
+            << endl;
+            exit(-1);
+        }
+
         if (drupDebug) {
-            drupf = &std::cout;
+            drupf = new DrupWriter(DrupWriter::Format::text, 0);
+            drupf->openStdout();
         } else {
             if (drupExistsCheck && fileExists(drupfilname)) {
                 cout
@@ -874,9 +930,11 @@ void Main::parseCommandLine()
                 << endl;
                 exit(-1);
             }
-            std::ofstream* drupfTmp = new std::ofstream;
-            drupfTmp->open(drupfilname.c_str(), std::ofstream::out);
-            if (!*drupfTmp) {
+            drupf = new DrupWriter(
+                drupFormat == "binary" ? DrupWriter::Format::binary : DrupWriter::Format::text
+                , drupCompress
+            );
+            if (!drupf->open(drupfilname)) {
                 cout
                 << "ERROR: Could not open DRUP file "
                 << drupfilname
@@ -885,7 +943,6 @@ void Main::parseCommandLine()
 
                 exit(-1);
             }
-            drupf = drupfTmp;
         }
     }
 
@@ -897,33 +954,6 @@ void Main::parseCommandLine()
         }
         conf.otfHyperbin = true;
     }
-
-    if (conf.doFindXors && drupf) {
-        if (conf.verbosity >= 2) {
-            cout
-            << "c XOR manipulation is not supported in DRUP, turning it off"
-            << endl;
-        }
-        conf.doFindXors = false;
-    }
-
-    if (conf.doRenumberVars && drupf) {
-        if (conf.verbosity >= 2) {
-            cout
-            << "c Variable renumbering is not supported during DRUP, turning it off"
-            << endl;
-        }
-        conf.doRenumberVars = false;
-    }
-
-    if (conf.doCompHandler && drupf) {
-        if (conf.verbosity >= 2) {
-            cout
-            << "c Component finding & solving is not supported during DRUP, turning it off"
-            << endl;
-        }
-        conf.doCompHandler = false;
-    }
     #endif
 
     if (conf.verbosity >= 1) {
@@ -933,6 +963,9 @@ void Main::parseCommandLine()
     if (debugLib) {
         //In case we are debugging the library, blocking must be disabled
         conf.doBlockClauses = false;
+
+        //New variables may be added after solving
+        conf.doBVA = false;
     }
 }
 
@@ -951,7 +984,7 @@ int Main::solve()
     solver = new Solver(conf);
     solverToInterrupt = solver;
     #ifdef DRUP
-    solver->drup = drupf;
+    solver->setDrup(drupf);
     #endif
 
     std::ofstream resultfile;
@@ -1007,7 +1040,7 @@ int Main::solve()
 
             //Banning found solution
             vector<Lit> lits;
-            for (Var var = 0; var < solver->nVars(); var++) {
+            for (Var var = 0; var < solver->nVarsOutside(); var++) {
                 if (solver->model[var] != l_Undef) {
                     lits.push_back( Lit(var, (solver->model[var] == l_True)? true : false) );
                 }
@@ -1039,12 +1072,18 @@ int Main::solve()
 
     #ifdef DRUP
     if (drupf) {
-        //flush DRUP
-        *drupf << std::flush;
+        //Write out everything and stop the I/O thread
+        drupf->close();
+        const bool drupFailed = drupf->hasFailed();
+        delete drupf;
+        drupf = NULL;
+
+        if (drupFailed) {
+            cout
+            << "ERROR: could not write the DRUP proof, it is incomplete"
+            << endl;
 
-        //If it's not stdout, we have to delete the ofstream
-        if (drupf != &std::cout) {
-            delete drupf;
+            return -1;
         }
     }
     #endif
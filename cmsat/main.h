@@ -35,6 +35,7 @@ using std::vector;
 
 namespace CMSat {
     class Solver;
+    class DrupWriter;
 }
 
 class Main
@@ -85,7 +86,7 @@ class Main
 
         #ifdef DRUP
         //Drup checker
-        std::ostream* drupf;
+        CMSat::DrupWriter* drupf;
         bool drupDebug;
         #endif
 };
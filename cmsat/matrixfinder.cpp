@@ -0,0 +1,250 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos and collaborators. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+
+#include "matrixfinder.h"
+#include "solver.h"
+#include "time_mem.h"
+#include <iomanip>
+#include <algorithm>
+#include <limits>
+
+using namespace CMSat;
+using std::cout;
+using std::endl;
+
+MatrixFinder::MatrixFinder(Solver* _solver) :
+    solver(_solver)
+    , origOtfHyperbin(false)
+{
+}
+
+MatrixFinder::~MatrixFinder()
+{
+    clearMatrixes();
+}
+
+Var MatrixFinder::findRoot(Var var)
+{
+    while(root[var] != var) {
+        root[var] = root[root[var]];
+        var = root[var];
+    }
+
+    return var;
+}
+
+bool MatrixFinder::findMatrixes()
+{
+    assert(solver->gaussMatrices.empty());
+    assert(solver->decisionLevel() == 0);
+    inMatrix.clear();
+    if (!solver->conf.doGauss
+        || solver->xors.empty()
+        || !solver->okay()
+    ) {
+        return solver->okay();
+    }
+
+    const double myTime = cpuTime();
+    runStats.clear();
+    runStats.numCalls = 1;
+
+    //Connect the variables of each XOR
+    root.resize(solver->nVars());
+    for(Var var = 0; var < solver->nVars(); var++) {
+        root[var] = var;
+    }
+    for(vector<Xor>::const_iterator
+        it = solver->xors.begin(), end = solver->xors.end()
+        ; it != end
+        ; it++
+    ) {
+        const Var first = findRoot(it->vars[0]);
+        for(size_t i = 1; i < it->vars.size(); i++) {
+            root[findRoot(it->vars[i])] = first;
+        }
+    }
+
+    //Split the XORs into the connected sets
+    vector<uint32_t> setNum(solver->nVars(), std::numeric_limits<uint32_t>::max());
+    sets.clear();
+    for(size_t i = 0; i < solver->xors.size(); i++) {
+        const Var r = findRoot(solver->xors[i].vars[0]);
+        if (setNum[r] == std::numeric_limits<uint32_t>::max()) {
+            setNum[r] = sets.size();
+            sets.push_back(vector<uint32_t>());
+        }
+        sets[setNum[r]].push_back(i);
+    }
+    std::sort(sets.begin(), sets.end(), SizeSorter());
+
+    inMatrix.resize(solver->xors.size(), 0);
+    for(vector<vector<uint32_t> >::const_iterator
+        it = sets.begin(), end = sets.end()
+        ; it != end && solver->gaussMatrices.size() < solver->conf.gaussMaxNumMatrixes
+        ; it++
+    ) {
+        if (it->size() < solver->conf.gaussMinMatrixRows
+            || it->size() > solver->conf.gaussMaxMatrixRows
+        ) {
+            continue;
+        }
+
+        if (solver->gaussMatrices.empty()) {
+            //Hyper-binary resolution at level 1 does not know about matrices
+            origOtfHyperbin = solver->conf.otfHyperbin;
+            solver->conf.otfHyperbin = false;
+            if (origOtfHyperbin && solver->conf.verbosity >= 1) {
+                cout
+                << "c [matrix] OTF hyper-binary resolution off while matrices are used"
+                << endl;
+            }
+            solver->needToAddBinClause.clear();
+            solver->uselessBin.clear();
+            solver->gaussReasons.resize(solver->nVars());
+            solver->gqhead = solver->trail.size();
+        }
+
+        matrixXors.clear();
+        for(vector<uint32_t>::const_iterator
+            it2 = it->begin(), end2 = it->end()
+            ; it2 != end2
+            ; it2++
+        ) {
+            matrixXors.push_back(solver->xors[*it2]);
+            inMatrix[*it2] = 1;
+        }
+        runStats.xorsInMatrix += matrixXors.size();
+
+        Gaussian* gauss = new Gaussian(solver, matrixXors, solver->gaussMatrices.size());
+        solver->gaussMatrices.push_back(gauss);
+        if (!gauss->init()) {
+            clearMatrixes();
+            inMatrix.clear();
+            return false;
+        }
+        runStats.gauss += gauss->getStats();
+    }
+
+    runStats.cpu_time = cpuTime() - myTime;
+    if (solver->conf.verbosity >= 1) {
+        runStats.printShort();
+    }
+
+    //The stats of the matrices are added when they are deleted
+    runStats.gauss = Gaussian::Stats();
+    globalStats += runStats;
+
+    return true;
+}
+
+void MatrixFinder::clearMatrixes()
+{
+    if (solver->gaussMatrices.empty())
+        return;
+
+    for(vector<Gaussian*>::const_iterator
+        it = solver->gaussMatrices.begin(), end = solver->gaussMatrices.end()
+        ; it != end
+        ; it++
+    ) {
+        globalStats.gauss += (*it)->getStats();
+        delete *it;
+    }
+    solver->gaussMatrices.clear();
+    solver->conf.otfHyperbin = origOtfHyperbin;
+}
+
+MatrixFinder::Stats& MatrixFinder::Stats::operator+=(const Stats& other)
+{
+    numCalls += other.numCalls;
+    xorsInMatrix += other.xorsInMatrix;
+    cpu_time += other.cpu_time;
+    gauss += other.gauss;
+
+    return *this;
+}
+
+void MatrixFinder::Stats::printShort() const
+{
+    cout
+    << "c [gauss]"
+    << " matrices: " << gauss.numMatrices
+    << " xors: " << xorsInMatrix
+    << " rows: " << gauss.rows
+    << " cols: " << gauss.cols
+    << " units: " << gauss.units
+    << " simd: " << rowSimdName(getRowSimd())
+    << " T: " << std::fixed << std::setprecision(2) << cpu_time
+    << endl;
+}
+
+void MatrixFinder::Stats::print() const
+{
+    cout << "c -------- GAUSS STATS ----------" << endl;
+    printStatsLine("c time"
+        , cpu_time
+        , cpu_time/(double)numCalls
+        , "per call"
+    );
+
+    printStatsLine("c matrices"
+        , gauss.numMatrices
+        , (double)gauss.numMatrices/(double)numCalls
+        , "per call"
+    );
+
+    printStatsLine("c xors in matrices"
+        , xorsInMatrix
+        , (double)gauss.rows/(double)xorsInMatrix*100.0
+        , "% independent"
+    );
+
+    printStatsLine("c rows x cols"
+        , (double)gauss.rows/(double)gauss.numMatrices
+        , (double)gauss.cols/(double)gauss.numMatrices
+        , "avg per matrix"
+    );
+
+    printStatsLine("c units at build"
+        , gauss.units
+    );
+
+    printStatsLine("c rows visited"
+        , gauss.visited
+    );
+
+    printStatsLine("c pivots"
+        , gauss.pivots
+        , (double)gauss.rowXors/(double)gauss.pivots
+        , "row xors/pivot"
+    );
+
+    printStatsLine("c propagations"
+        , gauss.propagations
+    );
+
+    printStatsLine("c conflicts"
+        , gauss.conflicts
+    );
+    cout << "c -------- GAUSS STATS END ----------" << endl;
+}
@@ -0,0 +1,125 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos and collaborators. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+
+#ifndef __MATRIXFINDER_H__
+#define __MATRIXFINDER_H__
+
+#include <vector>
+#include "solvertypes.h"
+#include "gaussian.h"
+
+namespace CMSat {
+using std::vector;
+
+class Solver;
+
+/**
+@brief Puts the XOR constraints that share variables into Gauss-Jordan matrices
+
+The XORs are split into the sets connected through their variables. The
+largest sets with enough, but not too many, XORs each become a Gaussian
+matrix, the other XORs are propagated one by one as before.
+
+Like the XORs themselves, the matrices are only there during the search: they
+are built from the cleaned XORs when those are attached, and deleted when they
+are detached. On-the-fly hyper-binary resolution is switched off while they
+exist, as propagateFull() does not know about them.
+*/
+class MatrixFinder
+{
+    public:
+        MatrixFinder(Solver* solver);
+        ~MatrixFinder();
+
+        ///Build the matrices. Must be at decision level 0. Returns FALSE if UNSAT
+        bool findMatrixes();
+
+        ///Delete the matrices, if any
+        void clearMatrixes();
+
+        ///Whether XOR 'num' is in one of the matrices
+        bool isInMatrix(const size_t num) const;
+
+        struct Stats
+        {
+            Stats() :
+                numCalls(0)
+                , xorsInMatrix(0)
+                , cpu_time(0)
+            {}
+
+            void clear()
+            {
+                Stats tmp;
+                *this = tmp;
+            }
+
+            Stats& operator+=(const Stats& other);
+            void print() const;
+            void printShort() const;
+
+            uint64_t numCalls;
+            uint64_t xorsInMatrix;
+            double   cpu_time;
+            Gaussian::Stats gauss; ///<Summed over the matrices, including the search
+        };
+
+        const Stats& getStats() const;
+
+    private:
+        Solver* solver;
+
+        Var findRoot(Var var);
+
+        ///Orders the sets of XORs by size, largest first
+        struct SizeSorter
+        {
+            bool operator()(const vector<uint32_t>& a, const vector<uint32_t>& b) const
+            {
+                return a.size() > b.size();
+            }
+        };
+
+        vector<Var> root; ///<Union-find over the variables
+        vector<vector<uint32_t> > sets; ///<XORs, by their root variable
+        vector<char> inMatrix; ///<Indexed by XOR
+        vector<Xor> matrixXors;
+        int origOtfHyperbin; ///<conf.otfHyperbin before the matrices were built
+
+        //Stats
+        Stats runStats;
+        Stats globalStats;
+};
+
+inline bool MatrixFinder::isInMatrix(const size_t num) const
+{
+    return num < inMatrix.size() && inMatrix[num];
+}
+
+inline const MatrixFinder::Stats& MatrixFinder::getStats() const
+{
+    return globalStats;
+}
+
+} //end namespace
+
+#endif //__MATRIXFINDER_H__
@@ -0,0 +1,165 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos and collaborators. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#include "memtracker.h"
+#include "solvertypes.h"
+#include <atomic>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+using namespace CMSat;
+
+static std::atomic<uint64_t> liveBytes[(int)MemTag::num_tags];
+static std::atomic<uint64_t> peakBytes[(int)MemTag::num_tags];
+static std::atomic<uint64_t> allocCount[(int)MemTag::num_tags];
+
+size_t MemTracker::realSize(void* ptr, const size_t requested)
+{
+    if (ptr == NULL)
+        return 0;
+
+    //Without glibc, the size asked for is all we know. The callers pass the
+    //same size when freeing the block, so live bytes still add up
+    size_t bytes = requested;
+    #if defined(__GLIBC__)
+    //Usable size plus the chunk header malloc keeps in front of the block
+    bytes = malloc_usable_size(ptr) + sizeof(size_t);
+    #endif
+
+    return bytes;
+}
+
+void MemTracker::alloced(const MemTag tag, const size_t bytes)
+{
+    const int at = (int)tag;
+    allocCount[at].fetch_add(1, std::memory_order_relaxed);
+    const uint64_t now =
+        liveBytes[at].fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+    uint64_t old = peakBytes[at].load(std::memory_order_relaxed);
+    while (now > old
+        && !peakBytes[at].compare_exchange_weak(old, now, std::memory_order_relaxed)
+    ) {
+        //'old' got updated, try again
+    }
+}
+
+void MemTracker::freed(const MemTag tag, const size_t bytes)
+{
+    liveBytes[(int)tag].fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void* MemTracker::trackedRealloc(
+    const MemTag tag
+    , void* ptr
+    , const size_t oldBytes
+    , const size_t bytes
+) {
+    const size_t before = realSize(ptr, oldBytes);
+    void* mem = realloc(ptr, bytes);
+    if (mem == NULL) {
+        //Original block is untouched
+        return NULL;
+    }
+
+    freed(tag, before);
+    alloced(tag, realSize(mem, bytes));
+
+    return mem;
+}
+
+void MemTracker::trackedFree(const MemTag tag, void* ptr, const size_t bytes)
+{
+    if (ptr == NULL)
+        return;
+
+    freed(tag, realSize(ptr, bytes));
+    free(ptr);
+}
+
+uint64_t MemTracker::live(const MemTag tag)
+{
+    return liveBytes[(int)tag].load(std::memory_order_relaxed);
+}
+
+uint64_t MemTracker::peak(const MemTag tag)
+{
+    return peakBytes[(int)tag].load(std::memory_order_relaxed);
+}
+
+uint64_t MemTracker::numAllocs(const MemTag tag)
+{
+    return allocCount[(int)tag].load(std::memory_order_relaxed);
+}
+
+uint64_t MemTracker::totalLive()
+{
+    uint64_t total = 0;
+    for(int i = 0; i < (int)MemTag::num_tags; i++) {
+        total += liveBytes[i].load(std::memory_order_relaxed);
+    }
+
+    return total;
+}
+
+const char* MemTracker::name(const MemTag tag)
+{
+    switch(tag) {
+        case MemTag::clauses:
+            return "clauses";
+
+        case MemTag::watches:
+            return "watches";
+
+        case MemTag::implcache:
+            return "impl cache";
+
+        case MemTag::stamp:
+            return "stamps";
+
+        case MemTag::other_vec:
+            return "other vec";
+
+        case MemTag::num_tags:
+            break;
+    }
+
+    return "unknown";
+}
+
+void MemTracker::print()
+{
+    for(int i = 0; i < (int)MemTag::num_tags; i++) {
+        const MemTag tag = (MemTag)i;
+        printStatsLine(string("c Mem tracked ") + name(tag)
+            , live(tag)/(1024UL*1024UL)
+            , "MB live"
+            , peak(tag)/(1024UL*1024UL)
+            , "MB peak"
+        );
+    }
+    printStatsLine("c Mem tracked total"
+        , totalLive()/(1024UL*1024UL)
+        , "MB"
+    );
+}
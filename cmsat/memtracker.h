@@ -0,0 +1,151 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos and collaborators. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#ifndef __MEMTRACKER_H__
+#define __MEMTRACKER_H__
+
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+#include "constants.h"
+
+namespace CMSat {
+
+/**
+@brief Subsystems whose heap allocations are accounted for separately
+*/
+enum class MemTag {
+    clauses = 0     ///<ClauseAllocator's arena and its bookkeeping
+    , watches       ///<vec<Watched>, i.e. watchlists and occurrence lists
+    , implcache     ///<Implication cache
+    , stamp         ///<Time stamps
+    , other_vec     ///<Any other vec<T>: heaps, queues
+    , num_tags      ///<Must be last
+};
+
+/**
+@brief Process-wide, thread-safe accounting of live&peak bytes per MemTag
+
+The numbers are the real sizes handed out by malloc(), including the rounding
+and chunk header, so they are larger than the capacity()-based estimates.
+Since the counters are global, they add up all Solver instances, including
+the sub-solvers of CompHandler.
+*/
+class MemTracker
+{
+    public:
+        static void alloced(const MemTag tag, const size_t bytes);
+        static void freed(const MemTag tag, const size_t bytes);
+
+        ///Number of bytes malloc() really uses for the block at "ptr",
+        ///allocated with "requested" bytes
+        static size_t realSize(void* ptr, const size_t requested);
+
+        static uint64_t live(const MemTag tag);
+        static uint64_t peak(const MemTag tag);
+        static uint64_t numAllocs(const MemTag tag);
+        static uint64_t totalLive();
+        static const char* name(const MemTag tag);
+        static void print();
+
+        ///malloc()/realloc()/free() wrappers that update the counters.
+        ///'oldBytes' and the size given to trackedFree() must be the size
+        ///the block was last (re)allocated with
+        static void* trackedRealloc(
+            const MemTag tag
+            , void* ptr
+            , const size_t oldBytes
+            , const size_t bytes
+        );
+        static void trackedFree(const MemTag tag, void* ptr, const size_t bytes);
+};
+
+/**
+@brief The tag under which vec<T> accounts its memory
+
+Specialise this next to the element type to give it its own tag
+*/
+template<class T>
+struct MemTagOf
+{
+    static const MemTag tag = MemTag::other_vec;
+};
+
+/**
+@brief STL allocator that reports its allocations to MemTracker
+
+Use as the allocator of the std containers of the large subsystems
+*/
+template<class T, MemTag tag>
+class TrackedAlloc
+{
+    public:
+        typedef T value_type;
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        template<class U>
+        struct rebind
+        {
+            typedef TrackedAlloc<U, tag> other;
+        };
+
+        TrackedAlloc()
+        {}
+
+        template<class U>
+        TrackedAlloc(const TrackedAlloc<U, tag>&)
+        {}
+
+        T* allocate(const size_t n)
+        {
+            void* mem = MemTracker::trackedRealloc(tag, NULL, 0, n*sizeof(T));
+            if (mem == NULL && n > 0)
+                throw std::bad_alloc();
+
+            return static_cast<T*>(mem);
+        }
+
+        void deallocate(T* p, size_t n)
+        {
+            MemTracker::trackedFree(tag, p, n*sizeof(T));
+        }
+
+        template<class U>
+        bool operator==(const TrackedAlloc<U, tag>&) const
+        {
+            return true;
+        }
+
+        template<class U>
+        bool operator!=(const TrackedAlloc<U, tag>&) const
+        {
+            return false;
+        }
+};
+
+} //end namespace
+
+#endif //__MEMTRACKER_H__
@@ -7,6 +7,7 @@
 #include "simplifier.h"
 #include <string>
 #include <time.h>
+#include <chrono>
 
 using namespace CMSat;
 using std::cout;
@@ -15,11 +16,45 @@ using std::string;
 
 MySQLStats::MySQLStats() :
     bindAt(0)
+    , maxQueued(0)
+    , numDropped(0)
+    , numBatches(0)
+    , verbosity(0)
+    , finishing(false)
+    , writerFailed(false)
+    , writerThread(NULL)
 {
 }
 
 MySQLStats::~MySQLStats()
 {
+    //Write out whatever is still queued
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        finishing = true;
+    }
+    queueCond.notify_one();
+    if (writerThread != NULL) {
+        writerThread->join();
+        delete writerThread;
+        writerThread = NULL;
+    }
+    if (writerFailed)
+        exitOnWriterError();
+
+    if (verbosity >= 1) {
+        cout
+        << "c SQL stats written in " << numBatches << " transactions"
+        << endl;
+    }
+    if (numDropped > 0) {
+        cout
+        << "c WARNING: dropped " << numDropped
+        << " SQL stats rows, the database could not keep up"
+        << " (see --sqlmaxqueue)"
+        << endl;
+    }
+
 	//Free all the prepared statements
     my_bool ret = mysql_stmt_close(stmtRst.stmt);
 	if (ret) {
@@ -78,6 +113,11 @@ void MySQLStats::setup(const Solver* solver)
         solver
         , solver->getConf().preparedDumpSizeScatter
     );
+
+    //From now on, only the writer thread uses the connection
+    maxQueued = solver->getConf().sqlMaxQueued;
+    verbosity = solver->getConf().verbosity;
+    writerThread = new std::thread(&MySQLStats::writerThreadMain, this);
 }
 
 void MySQLStats::connectServer(const Solver* solver)
@@ -898,6 +938,7 @@ void MySQLStats::initVarSTMT(
     }
 }
 
+
 void MySQLStats::varDataDump(
     const Solver* solver
     , const Searcher* search
@@ -906,93 +947,58 @@ void MySQLStats::varDataDump(
 ) {
     double myTime = cpuTime();
 
-    //Get ID for varDataInit
-    std::stringstream ss;
-    ss
-    << "INSERT INTO varDataInit (`runID`, `simplifications`, `restarts`, `conflicts`, `time`)"
-    << " values ("
-    << runID
-    << ", " << solver->getSolveStats().numSimplify
-    << ", " << search->sumRestarts()
-    << ", " << search->sumConflicts()
-    << ", " << cpuTime()
-    << ");";
-
-    if (mysql_query(serverConn, ss.str().c_str())) {
-        if (solver->getConf().verbosity >= 6) {
-            cout << "c Couldn't insert into table `varDataInit`" << endl;
-            cout << "c " << mysql_error(serverConn) << endl;
-        }
-        exit(-1);
-    }
-    my_ulonglong id = mysql_insert_id(serverConn);
-
-    //Do bulk insert by defult
-    StmtVar* stmtVar = &stmtVarBulk;
+    VarDump dump;
+    dump.numSimplify = solver->getSolveStats().numSimplify;
+    dump.sumRestarts = search->sumRestarts();
+    dump.sumConflicts = search->sumConflicts();
+    dump.cpuTime = cpuTime();
+    dump.data.resize(varsToDump.size());
 
     //Go through top N variables
-
     size_t at = 0;
-    size_t i = 0;
-    size_t numToDump = varsToDump.size();
-
     for(vector<Var>::const_iterator
         it = varsToDump.begin(), end = varsToDump.end()
         ; it != end
-        ; it++, i++
+        ; it++, at++
     ) {
         size_t var = *it;
+        StmtVar::Data& data = dump.data[at];
 
-        //If we are at beginning of bulk, but not enough is left, do one-by-one
-        if ((at == 0 && numToDump-i < stmtVarBulk.data.size())) {
-            stmtVar = &stmtVarSingle;
-            at = 0;
-        }
-
-        stmtVar->varInitID = id;
         //Back-number variables
-        stmtVar->data[at].var = solver->getInterToOuterMain()[var];
+        data.var = solver->getInterToOuterMain()[var];
 
         //Overall stats
-        stmtVar->data[at].posPolarSet = varData[var].stats.posPolarSet;
-        stmtVar->data[at].negPolarSet = varData[var].stats.negPolarSet;
-        stmtVar->data[at].flippedPolarity  = varData[var].stats.flippedPolarity;
-        stmtVar->data[at].posDecided  = varData[var].stats.posDecided;
-        stmtVar->data[at].negDecided  = varData[var].stats.negDecided;
+        data.posPolarSet = varData[var].stats.posPolarSet;
+        data.negPolarSet = varData[var].stats.negPolarSet;
+        data.flippedPolarity  = varData[var].stats.flippedPolarity;
+        data.posDecided  = varData[var].stats.posDecided;
+        data.negDecided  = varData[var].stats.negDecided;
 
         //Dec level history stats
-        stmtVar->data[at].decLevelAvg  = varData[var].stats.decLevelHist.avg();
-        stmtVar->data[at].decLevelSD   = sqrt(varData[var].stats.decLevelHist.var());
-        stmtVar->data[at].decLevelMin  = varData[var].stats.decLevelHist.getMin();
-        stmtVar->data[at].decLevelMax  = varData[var].stats.decLevelHist.getMax();
+        data.decLevelAvg  = varData[var].stats.decLevelHist.avg();
+        data.decLevelSD   = sqrt(varData[var].stats.decLevelHist.var());
+        data.decLevelMin  = varData[var].stats.decLevelHist.getMin();
+        data.decLevelMax  = varData[var].stats.decLevelHist.getMax();
 
         //Trail level history stats
-        stmtVar->data[at].trailLevelAvg  = varData[var].stats.trailLevelHist.avg();
-        stmtVar->data[at].trailLevelSD   = sqrt(varData[var].stats.trailLevelHist.var());
-        stmtVar->data[at].trailLevelMin  = varData[var].stats.trailLevelHist.getMin();
-        stmtVar->data[at].trailLevelMax  = varData[var].stats.trailLevelHist.getMax();
-        at++;
-
-        if (at == stmtVar->data.size()) {
-            if (mysql_stmt_execute(stmtVar->stmt)) {
-                cout
-                << "ERROR: while executing restart insertion MySQL prepared statement"
-                << endl;
+        data.trailLevelAvg  = varData[var].stats.trailLevelHist.avg();
+        data.trailLevelSD   = sqrt(varData[var].stats.trailLevelHist.var());
+        data.trailLevelMin  = varData[var].stats.trailLevelHist.getMin();
+        data.trailLevelMax  = varData[var].stats.trailLevelHist.getMax();
+    }
 
-                cout << "Error from mysql: "
-                << mysql_stmt_error(stmtVar->stmt)
-                << endl;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (!roomInQueue())
+            return;
 
-                exit(-1);
-            }
-            at = 0;
-        }
+        pending.varDump.push_back(dump);
+        queued();
     }
-    assert(at == 0 && "numInserts must be divisible");
 
     if (solver->getConf().verbosity >= 6) {
         cout
-        << "c Time to insert variables' stats into DB: "
+        << "c Time to queue variables' stats for DB: "
         << std::fixed << std::setprecision(2) << std::setw(3)
         << cpuTime() - myTime
         << " s"
@@ -1007,23 +1013,14 @@ void MySQLStats::clauseSizeDistrib(
     assert(sizes.size() == stmtClsDistribSize.value.size());
     assert(sizes.size() == stmtClsDistribSize.num.size());
 
-    stmtClsDistribSize.sumConflicts = sumConflicts;
-    for(size_t i = 0; i < sizes.size(); i++) {
-        stmtClsDistribSize.value[i] = i;
-        stmtClsDistribSize.num[i]  = sizes[i];
-    }
-
-    if (mysql_stmt_execute(stmtClsDistribSize.stmt)) {
-        cout
-        << "ERROR: while executing restart insertion MySQL prepared statement"
-        << endl;
-
-        cout << "Error from mysql: "
-        << mysql_stmt_error(stmtClsDistribSize.stmt)
-        << endl;
+    std::lock_guard<std::mutex> lock(queueMutex);
+    if (!roomInQueue())
+        return;
 
-        exit(-1);
-    }
+    pending.sizeDistrib.push_back(Distrib());
+    pending.sizeDistrib.back().sumConflicts = sumConflicts;
+    pending.sizeDistrib.back().num = sizes;
+    queued();
 }
 
 void MySQLStats::clauseGlueDistrib(
@@ -1033,61 +1030,33 @@ void MySQLStats::clauseGlueDistrib(
     assert(glues.size() == stmtClsDistribGlue.value.size());
     assert(glues.size() == stmtClsDistribGlue.num.size());
 
-    stmtClsDistribGlue.sumConflicts = sumConflicts;
-    for(size_t i = 0; i < glues.size(); i++) {
-        stmtClsDistribGlue.value[i] = i;
-        stmtClsDistribGlue.num[i]  = glues[i];
-    }
-
-    if (mysql_stmt_execute(stmtClsDistribGlue.stmt)) {
-        cout
-        << "ERROR: while executing restart insertion MySQL prepared statement"
-        << endl;
+    std::lock_guard<std::mutex> lock(queueMutex);
+    if (!roomInQueue())
+        return;
 
-        cout << "Error from mysql: "
-        << mysql_stmt_error(stmtClsDistribGlue.stmt)
-        << endl;
-
-        exit(-1);
-    }
+    pending.glueDistrib.push_back(Distrib());
+    pending.glueDistrib.back().sumConflicts = sumConflicts;
+    pending.glueDistrib.back().num = glues;
+    queued();
 }
 
 void MySQLStats::clauseSizeGlueScatter(
     uint64_t sumConflicts
     , boost::multi_array<uint32_t, 2>& sizeAndGlue
 ) {
-    //assert(glues.size() == stmtClsDistrib.value.size());
-    //assert(glues.size() == stmtClsDistrib.num.size());
-
-    const size_t numInserts = stmtSizeGlueScatter.size.size();
-
-    stmtSizeGlueScatter.sumConflicts = sumConflicts;
-
-    size_t at = 0;
-    for(size_t i = 0; i < sizeAndGlue.shape()[0]; i++) {
-        for(size_t i2 = 0; i2 < sizeAndGlue.shape()[1]; i2++) {
-            stmtSizeGlueScatter.size[at] = i;
-            stmtSizeGlueScatter.glue[at] = i2;
-            stmtSizeGlueScatter.num[at]  = sizeAndGlue[i][i2];
-            at++;
-
-            if (at == numInserts) {
-                if (mysql_stmt_execute(stmtSizeGlueScatter.stmt)) {
-                    cout
-                    << "ERROR: while executing restart insertion MySQL prepared statement"
-                    << endl;
-
-                    cout << "Error from mysql: "
-                    << mysql_stmt_error(stmtSizeGlueScatter.stmt)
-                    << endl;
-
-                    exit(-1);
-                }
-                at = 0;
-            }
-        }
-    }
-    assert(at == 0 && "numInserts must be divisible");
+    std::lock_guard<std::mutex> lock(queueMutex);
+    if (!roomInQueue())
+        return;
+
+    pending.scatter.push_back(SizeGlueScatter());
+    SizeGlueScatter& scatter = pending.scatter.back();
+    scatter.sumConflicts = sumConflicts;
+    scatter.numGlues = sizeAndGlue.shape()[1];
+    scatter.num.assign(
+        sizeAndGlue.data()
+        , sizeAndGlue.data() + sizeAndGlue.num_elements()
+    );
+    queued();
 }
 
 void MySQLStats::reduceDB(
@@ -1097,35 +1066,32 @@ void MySQLStats::reduceDB(
 
     , const Solver* solver
 ) {
+    ReduceDBData reduce;
+
     //Position of solving
-    stmtReduceDB.numSimplify     = solver->getSolveStats().numSimplify;
-    stmtReduceDB.sumRestarts     = solver->sumRestarts();
-    stmtReduceDB.sumConflicts    = solver->sumConflicts();
-    stmtReduceDB.cpuTime         = cpuTime();
-    stmtReduceDB.reduceDBs       = solver->getSolveStats().nbReduceDB;
+    reduce.numSimplify     = solver->getSolveStats().numSimplify;
+    reduce.sumRestarts     = solver->sumRestarts();
+    reduce.sumConflicts    = solver->sumConflicts();
+    reduce.cpuTime         = cpuTime();
+    reduce.reduceDBs       = solver->getSolveStats().nbReduceDB;
 
     //Clause data for IRRED
-    stmtReduceDB.irredLitsVisited   = irredStats.sumLitVisited;
-    stmtReduceDB.irredClsVisited    = irredStats.sumLookedAt;
+    reduce.irredLitsVisited   = irredStats.sumLitVisited;
+    reduce.irredClsVisited    = irredStats.sumLookedAt;
 
     //Clause data for RED
-    stmtReduceDB.redLitsVisited     = redStats.sumLitVisited;
-    stmtReduceDB.redClsVisited      = redStats.sumLookedAt;
+    reduce.redLitsVisited     = redStats.sumLitVisited;
+    reduce.redClsVisited      = redStats.sumLookedAt;
 
     //Clean data
-    stmtReduceDB.clean              = clean;
-
-    if (mysql_stmt_execute(stmtReduceDB.stmt)) {
-        cout
-        << "ERROR: while executing clause DB cleaning MySQL prepared statement"
-        << endl;
+    reduce.clean              = clean;
 
-        cout << "Error from mysql: "
-        << mysql_stmt_error(stmtReduceDB.stmt)
-        << endl;
+    std::lock_guard<std::mutex> lock(queueMutex);
+    if (!roomInQueue())
+        return;
 
-        exit(-1);
-    }
+    pending.reduceDB.push_back(reduce);
+    queued();
 }
 
 
@@ -1138,128 +1104,389 @@ void MySQLStats::restart(
 ) {
     const Searcher::Hist& searchHist = search->getHistory();
     const Solver::BinTriStats& binTri = solver->getBinTriStats();
+    RstData rst;
 
     //Position of solving
-    stmtRst.numSimplify     = solver->getSolveStats().numSimplify;
-    stmtRst.sumRestarts     = search->sumRestarts();
-    stmtRst.sumConflicts    = search->sumConflicts();
-    stmtRst.cpuTime         = cpuTime();
+    rst.numSimplify     = solver->getSolveStats().numSimplify;
+    rst.sumRestarts     = search->sumRestarts();
+    rst.sumConflicts    = search->sumConflicts();
+    rst.cpuTime         = cpuTime();
 
     //Clause stats
-    stmtRst.numIrredBins  = binTri.irredBins;
-    stmtRst.numIrredTris  = binTri.irredTris;
-    stmtRst.numIrredLongs = solver->getNumLongIrredCls();
-    stmtRst.numIrredLits  = binTri.irredLits;
-    stmtRst.numRedBins    = binTri.redBins;
-    stmtRst.numRedTris    = binTri.redTris;
-    stmtRst.numRedLongs   = solver->getNumLongRedCls();
-    stmtRst.numRedLits    = binTri.redLits;
+    rst.numIrredBins  = binTri.irredBins;
+    rst.numIrredTris  = binTri.irredTris;
+    rst.numIrredLongs = solver->getNumLongIrredCls();
+    rst.numIrredLits  = binTri.irredLits;
+    rst.numRedBins    = binTri.redBins;
+    rst.numRedTris    = binTri.redTris;
+    rst.numRedLongs   = solver->getNumLongRedCls();
+    rst.numRedLits    = binTri.redLits;
 
     //Conflict stats
-    stmtRst.glueHist        = searchHist.glueHist.getLongtTerm().avg();
-    stmtRst.glueHistSD      = sqrt(searchHist.glueHist.getLongtTerm().var());
-    stmtRst.glueHistMin      = searchHist.glueHist.getLongtTerm().getMin();
-    stmtRst.glueHistMax      = searchHist.glueHist.getLongtTerm().getMax();
+    rst.glueHist        = searchHist.glueHist.getLongtTerm().avg();
+    rst.glueHistSD      = sqrt(searchHist.glueHist.getLongtTerm().var());
+    rst.glueHistMin      = searchHist.glueHist.getLongtTerm().getMin();
+    rst.glueHistMax      = searchHist.glueHist.getLongtTerm().getMax();
 
-    stmtRst.conflSizeHist   = searchHist.conflSizeHist.avg();
-    stmtRst.conflSizeHistSD = sqrt(searchHist.conflSizeHist.var());
-    stmtRst.conflSizeHistMin = searchHist.conflSizeHist.getMin();
-    stmtRst.conflSizeHistMax = searchHist.conflSizeHist.getMax();
+    rst.conflSizeHist   = searchHist.conflSizeHist.avg();
+    rst.conflSizeHistSD = sqrt(searchHist.conflSizeHist.var());
+    rst.conflSizeHistMin = searchHist.conflSizeHist.getMin();
+    rst.conflSizeHistMax = searchHist.conflSizeHist.getMax();
 
-    stmtRst.numResolutionsHist =
+    rst.numResolutionsHist =
         searchHist.numResolutionsHist.avg();
-    stmtRst.numResolutionsHistSD =
+    rst.numResolutionsHistSD =
         sqrt(searchHist.numResolutionsHist.var());
-    stmtRst.numResolutionsHistMin =
+    rst.numResolutionsHistMin =
         searchHist.numResolutionsHist.getMin();
-    stmtRst.numResolutionsHistMax =
+    rst.numResolutionsHistMax =
         searchHist.numResolutionsHist.getMax();
 
-    stmtRst.conflictAfterConflict =
+    rst.conflictAfterConflict =
         searchHist.conflictAfterConflict.avg()*100.0;
 
     //Search stats
-    stmtRst.branchDepthHist         = searchHist.branchDepthHist.avg();
-    stmtRst.branchDepthHistSD       = sqrt(searchHist.branchDepthHist.var());
-    stmtRst.branchDepthHistMin      = searchHist.branchDepthHist.getMin();
-    stmtRst.branchDepthHistMax      = searchHist.branchDepthHist.getMax();
+    rst.branchDepthHist         = searchHist.branchDepthHist.avg();
+    rst.branchDepthHistSD       = sqrt(searchHist.branchDepthHist.var());
+    rst.branchDepthHistMin      = searchHist.branchDepthHist.getMin();
+    rst.branchDepthHistMax      = searchHist.branchDepthHist.getMax();
 
 
-    stmtRst.branchDepthDeltaHist    = searchHist.branchDepthDeltaHist.avg();
-    stmtRst.branchDepthDeltaHistSD  = sqrt(searchHist.branchDepthDeltaHist.var());
-    stmtRst.branchDepthDeltaHistMin  = searchHist.branchDepthDeltaHist.getMin();
-    stmtRst.branchDepthDeltaHistMax  = searchHist.branchDepthDeltaHist.getMax();
+    rst.branchDepthDeltaHist    = searchHist.branchDepthDeltaHist.avg();
+    rst.branchDepthDeltaHistSD  = sqrt(searchHist.branchDepthDeltaHist.var());
+    rst.branchDepthDeltaHistMin  = searchHist.branchDepthDeltaHist.getMin();
+    rst.branchDepthDeltaHistMax  = searchHist.branchDepthDeltaHist.getMax();
 
-    stmtRst.trailDepthHist          = searchHist.trailDepthHist.getLongtTerm().avg();
-    stmtRst.trailDepthHistSD        = sqrt(searchHist.trailDepthHist.getLongtTerm().var());
-    stmtRst.trailDepthHistMin       = searchHist.trailDepthHist.getLongtTerm().getMin();
-    stmtRst.trailDepthHistMax       = searchHist.trailDepthHist.getLongtTerm().getMax();
+    rst.trailDepthHist          = searchHist.trailDepthHist.getLongtTerm().avg();
+    rst.trailDepthHistSD        = sqrt(searchHist.trailDepthHist.getLongtTerm().var());
+    rst.trailDepthHistMin       = searchHist.trailDepthHist.getLongtTerm().getMin();
+    rst.trailDepthHistMax       = searchHist.trailDepthHist.getLongtTerm().getMax();
 
-    stmtRst.trailDepthDeltaHist     = searchHist.trailDepthDeltaHist.avg();
-    stmtRst.trailDepthDeltaHistSD   = sqrt(searchHist.trailDepthDeltaHist.var());
-    stmtRst.trailDepthDeltaHistMin  = searchHist.trailDepthDeltaHist.getMin();
-    stmtRst.trailDepthDeltaHistMax  = searchHist.trailDepthDeltaHist.getMax();
+    rst.trailDepthDeltaHist     = searchHist.trailDepthDeltaHist.avg();
+    rst.trailDepthDeltaHistSD   = sqrt(searchHist.trailDepthDeltaHist.var());
+    rst.trailDepthDeltaHistMin  = searchHist.trailDepthDeltaHist.getMin();
+    rst.trailDepthDeltaHistMax  = searchHist.trailDepthDeltaHist.getMax();
 
-    stmtRst.agilityHist             = searchHist.agilityHist.avg();
+    rst.agilityHist             = searchHist.agilityHist.avg();
 
     //Prop
-    stmtRst.propsBinIrred    = thisPropStats.propsBinIrred;
-    stmtRst.propsBinRed      = thisPropStats.propsBinRed;
-    stmtRst.propsTriIrred    = thisPropStats.propsTriIrred;
-    stmtRst.propsTriRed      = thisPropStats.propsTriRed;
-    stmtRst.propsLongIrred   = thisPropStats.propsLongIrred;
-    stmtRst.propsLongRed     = thisPropStats.propsLongRed;
+    rst.propsBinIrred    = thisPropStats.propsBinIrred;
+    rst.propsBinRed      = thisPropStats.propsBinRed;
+    rst.propsTriIrred    = thisPropStats.propsTriIrred;
+    rst.propsTriRed      = thisPropStats.propsTriRed;
+    rst.propsLongIrred   = thisPropStats.propsLongIrred;
+    rst.propsLongRed     = thisPropStats.propsLongRed;
 
     //Confl
-    stmtRst.conflsBinIrred  =  thisStats.conflStats.conflsBinIrred;
-    stmtRst.conflsBinRed    = thisStats.conflStats.conflsBinRed;
-    stmtRst.conflsTriIrred  = thisStats.conflStats.conflsTriIrred;
-    stmtRst.conflsTriRed    = thisStats.conflStats.conflsTriRed;
-    stmtRst.conflsLongIrred = thisStats.conflStats.conflsLongIrred;
-    stmtRst.conflsLongRed   = thisStats.conflStats.conflsLongRed;
+    rst.conflsBinIrred  =  thisStats.conflStats.conflsBinIrred;
+    rst.conflsBinRed    = thisStats.conflStats.conflsBinRed;
+    rst.conflsTriIrred  = thisStats.conflStats.conflsTriIrred;
+    rst.conflsTriRed    = thisStats.conflStats.conflsTriRed;
+    rst.conflsLongIrred = thisStats.conflStats.conflsLongIrred;
+    rst.conflsLongRed   = thisStats.conflStats.conflsLongRed;
 
     //Learnt
-    stmtRst.learntUnits = thisStats.learntUnits;
-    stmtRst.learntBins  = thisStats.learntBins;
-    stmtRst.learntTris  = thisStats.learntTris;
-    stmtRst.learntLongs = thisStats.learntLongs;
+    rst.learntUnits = thisStats.learntUnits;
+    rst.learntBins  = thisStats.learntBins;
+    rst.learntTris  = thisStats.learntTris;
+    rst.learntLongs = thisStats.learntLongs;
 
     //Misc
-    stmtRst.watchListSizeTraversed   = searchHist.watchListSizeTraversed.avg();
-    stmtRst.watchListSizeTraversedSD = sqrt(searchHist.watchListSizeTraversed.var());
-    stmtRst.watchListSizeTraversedMin= searchHist.watchListSizeTraversed.getMin();
-    stmtRst.watchListSizeTraversedMax= searchHist.watchListSizeTraversed.getMax();
+    rst.watchListSizeTraversed   = searchHist.watchListSizeTraversed.avg();
+    rst.watchListSizeTraversedSD = sqrt(searchHist.watchListSizeTraversed.var());
+    rst.watchListSizeTraversedMin= searchHist.watchListSizeTraversed.getMin();
+    rst.watchListSizeTraversedMax= searchHist.watchListSizeTraversed.getMax();
 
 
-    stmtRst.litPropagatedSomething   = searchHist.litPropagatedSomething.avg()*100.0;
-    stmtRst.litPropagatedSomethingSD = sqrt(searchHist.litPropagatedSomething.var())*100.0;
+    rst.litPropagatedSomething   = searchHist.litPropagatedSomething.avg()*100.0;
+    rst.litPropagatedSomethingSD = sqrt(searchHist.litPropagatedSomething.var())*100.0;
 
     //Resolv stats
-    stmtRst.resolv          = thisStats.resolvs;
+    rst.resolv          = thisStats.resolvs;
 
     //Var stats
-    stmtRst.decisions       = thisStats.decisions;
-    stmtRst.propagations    = thisPropStats.propagations;
-    stmtRst.varVarStats     = varVarStats;
-
-    stmtRst.varFlipped      = thisPropStats.varFlipped;
-    stmtRst.varSetPos       = thisPropStats.varSetPos;
-    stmtRst.varSetNeg       = thisPropStats.varSetNeg;
-    stmtRst.numFreeVars     = solver->getNumFreeVars();
-    stmtRst.numReplacedVars = solver->getNumVarsReplaced();
-    stmtRst.numVarsElimed   = solver->getNumVarsElimed();
-    stmtRst.trailSize       = search->getTrailSize();
-
-    if (mysql_stmt_execute(stmtRst.stmt)) {
-        cout
-        << "ERROR: while executing restart insertion MySQL prepared statement"
-        << endl;
+    rst.decisions       = thisStats.decisions;
+    rst.propagations    = thisPropStats.propagations;
+    rst.varVarStats     = varVarStats;
+
+    rst.varFlipped      = thisPropStats.varFlipped;
+    rst.varSetPos       = thisPropStats.varSetPos;
+    rst.varSetNeg       = thisPropStats.varSetNeg;
+    rst.numFreeVars     = solver->getNumFreeVars();
+    rst.numReplacedVars = solver->getNumVarsReplaced();
+    rst.numVarsElimed   = solver->getNumVarsElimed();
+    rst.trailSize       = search->getTrailSize();
+
+    std::lock_guard<std::mutex> lock(queueMutex);
+    if (!roomInQueue())
+        return;
+
+    pending.rst.push_back(rst);
+    queued();
+}
 
-        cout << "Error from mysql: "
-        << mysql_stmt_error(stmtRst.stmt)
-        << endl;
+bool MySQLStats::roomInQueue()
+{
+    if (writerFailed)
+        exitOnWriterError();
 
-        exit(-1);
+    if (pending.size() >= maxQueued) {
+        numDropped++;
+        return false;
+    }
+
+    return true;
+}
+
+void MySQLStats::queued()
+{
+    //Let rows accumulate so they are written in larger transactions
+    if (pending.size() >= flushEvery)
+        queueCond.notify_one();
+}
+
+void MySQLStats::Batch::swap(Batch& other)
+{
+    rst.swap(other.rst);
+    reduceDB.swap(other.reduceDB);
+    varDump.swap(other.varDump);
+    sizeDistrib.swap(other.sizeDistrib);
+    glueDistrib.swap(other.glueDistrib);
+    scatter.swap(other.scatter);
+}
+
+void MySQLStats::Batch::clear()
+{
+    rst.clear();
+    reduceDB.clear();
+    varDump.clear();
+    sizeDistrib.clear();
+    glueDistrib.clear();
+    scatter.clear();
+}
+
+void MySQLStats::writerThreadMain()
+{
+    mysql_thread_init();
+
+    Batch batch;
+    while(true) {
+        bool done;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            if (!finishing && pending.size() < flushEvery) {
+                //Rarely written tables still get flushed every second
+                queueCond.wait_for(lock, std::chrono::seconds(1));
+            }
+            batch.swap(pending);
+            done = finishing;
+        }
+
+        if (!writeBatch(batch)) {
+            //The main thread reports it and exits, not this one
+            std::lock_guard<std::mutex> lock(queueMutex);
+            writerFailed = true;
+            break;
+        }
+        batch.clear();
+
+        if (done) {
+            //Nothing can be queued after "finishing" is set
+            break;
+        }
+    }
+
+    mysql_thread_end();
+}
+
+void MySQLStats::exitOnWriterError()
+{
+    //The writer thread does not touch the queue after setting writerFailed
+    if (writerThread != NULL) {
+        writerThread->join();
+        delete writerThread;
+        writerThread = NULL;
+    }
+
+    cout << writerError << endl;
+    exit(-1);
+}
+
+bool MySQLStats::query(const string& sql)
+{
+    if (mysql_query(serverConn, sql.c_str())) {
+        std::stringstream ss;
+        ss
+        << "ERROR: while executing MySQL query '" << sql << "'"
+        << endl
+        << "Error from mysql: "
+        << mysql_error(serverConn);
+        writerError = ss.str();
+
+        return false;
+    }
+
+    return true;
+}
+
+bool MySQLStats::execute(MYSQL_STMT* stmt, const char* what)
+{
+    if (mysql_stmt_execute(stmt)) {
+        std::stringstream ss;
+        ss
+        << "ERROR: while executing " << what << " MySQL prepared statement"
+        << endl
+        << "Error from mysql: "
+        << mysql_stmt_error(stmt);
+        writerError = ss.str();
+
+        return false;
+    }
+
+    return true;
+}
+
+bool MySQLStats::writeBatch(Batch& batch)
+{
+    if (batch.size() == 0)
+        return true;
+
+    if (!query("START TRANSACTION"))
+        return false;
+
+    if (!writeBatchRows(batch)) {
+        //Keep the error of the failed statement, not of this one
+        mysql_query(serverConn, "ROLLBACK");
+        return false;
+    }
+
+    if (!query("COMMIT"))
+        return false;
+
+    numBatches++;
+    return true;
+}
+
+bool MySQLStats::writeBatchRows(const Batch& batch)
+{
+    for(vector<RstData>::const_iterator
+        it = batch.rst.begin(), end = batch.rst.end()
+        ; it != end
+        ; it++
+    ) {
+        static_cast<RstData&>(stmtRst) = *it;
+        if (!execute(stmtRst.stmt, "restart insertion"))
+            return false;
+    }
+
+    for(vector<ReduceDBData>::const_iterator
+        it = batch.reduceDB.begin(), end = batch.reduceDB.end()
+        ; it != end
+        ; it++
+    ) {
+        static_cast<ReduceDBData&>(stmtReduceDB) = *it;
+        if (!execute(stmtReduceDB.stmt, "clause DB cleaning"))
+            return false;
+    }
+
+    for(size_t i = 0; i < batch.varDump.size(); i++) {
+        if (!writeVarDump(batch.varDump[i]))
+            return false;
+    }
+
+    for(size_t i = 0; i < batch.sizeDistrib.size(); i++) {
+        if (!writeDistrib(stmtClsDistribSize, batch.sizeDistrib[i]))
+            return false;
+    }
+
+    for(size_t i = 0; i < batch.glueDistrib.size(); i++) {
+        if (!writeDistrib(stmtClsDistribGlue, batch.glueDistrib[i]))
+            return false;
     }
+
+    for(size_t i = 0; i < batch.scatter.size(); i++) {
+        if (!writeScatter(batch.scatter[i]))
+            return false;
+    }
+
+    return true;
+}
+
+bool MySQLStats::writeVarDump(const VarDump& dump)
+{
+    //Get ID for varDataInit
+    std::stringstream ss;
+    ss
+    << "INSERT INTO varDataInit (`runID`, `simplifications`, `restarts`, `conflicts`, `time`)"
+    << " values ("
+    << runID
+    << ", " << dump.numSimplify
+    << ", " << dump.sumRestarts
+    << ", " << dump.sumConflicts
+    << ", " << dump.cpuTime
+    << ");";
+    if (!query(ss.str()))
+        return false;
+    my_ulonglong id = mysql_insert_id(serverConn);
+
+    //Do bulk insert by defult
+    StmtVar* stmtVar = &stmtVarBulk;
+
+    size_t at = 0;
+    const size_t numToDump = dump.data.size();
+    for(size_t i = 0; i < numToDump; i++) {
+        //If we are at beginning of bulk, but not enough is left, do one-by-one
+        if ((at == 0 && numToDump-i < stmtVarBulk.data.size())) {
+            stmtVar = &stmtVarSingle;
+            at = 0;
+        }
+
+        stmtVar->varInitID = id;
+        stmtVar->data[at] = dump.data[i];
+        at++;
+
+        if (at == stmtVar->data.size()) {
+            if (!execute(stmtVar->stmt, "variable data insertion"))
+                return false;
+            at = 0;
+        }
+    }
+    assert(at == 0 && "numInserts must be divisible");
+
+    return true;
+}
+
+bool MySQLStats::writeDistrib(StmtClsDistrib& stmt, const Distrib& distrib)
+{
+    stmt.sumConflicts = distrib.sumConflicts;
+    for(size_t i = 0; i < distrib.num.size(); i++) {
+        stmt.value[i] = i;
+        stmt.num[i]  = distrib.num[i];
+    }
+
+    return execute(stmt.stmt, "clause distribution insertion");
 }
 
+bool MySQLStats::writeScatter(const SizeGlueScatter& scatter)
+{
+    const size_t numInserts = stmtSizeGlueScatter.size.size();
+
+    stmtSizeGlueScatter.sumConflicts = scatter.sumConflicts;
+
+    size_t at = 0;
+    for(size_t i = 0; i < scatter.num.size(); i++) {
+        stmtSizeGlueScatter.size[at] = i / scatter.numGlues;
+        stmtSizeGlueScatter.glue[at] = i % scatter.numGlues;
+        stmtSizeGlueScatter.num[at]  = scatter.num[i];
+        at++;
+
+        if (at == numInserts) {
+            if (!execute(stmtSizeGlueScatter.stmt, "size-glue scatter insertion"))
+                return false;
+            at = 0;
+        }
+    }
+    assert(at == 0 && "numInserts must be divisible");
+
+    return true;
+}
@@ -1,4 +1,7 @@
 #include "sqlstats.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #ifdef _MSC_VER
 #define NOMINMAX
@@ -11,6 +14,15 @@
 using namespace CMSat;
 
 
+/**
+@brief Writes the statistics into a MySQL database
+
+The solver thread only copies the data of every row into an in-memory queue.
+A background thread takes the queued rows in batches and writes each batch
+inside a single transaction, using the multi-row prepared statements set up in
+setup(). If the queue holds more than conf.sqlMaxQueued items, new rows are
+dropped and counted rather than stalling the search.
+*/
 class MySQLStats: public SQLStats
 {
 public:
@@ -119,14 +131,7 @@ private:
         bindAt++;
     }
 
-    struct StmtReduceDB {
-        StmtReduceDB() :
-            stmt(NULL)
-        {};
-
-        MYSQL_BIND  bind[10 + 13*3];
-        MYSQL_STMT  *stmt;
-
+    struct ReduceDBData {
         //Position
         uint64_t numSimplify;
         uint64_t sumRestarts;
@@ -145,6 +150,15 @@ private:
         //Cleaning stats
         CleaningStats clean;
     };
+
+    struct StmtReduceDB : public ReduceDBData {
+        StmtReduceDB() :
+            stmt(NULL)
+        {};
+
+        MYSQL_BIND  bind[10 + 13*3];
+        MYSQL_STMT  *stmt;
+    };
     StmtReduceDB stmtReduceDB;
     void initReduceDBSTMT(uint64_t verbosity);
 
@@ -190,14 +204,7 @@ private:
     );
 
     size_t bindAt;
-    struct StmtRst {
-        StmtRst() :
-            stmt(NULL)
-        {};
-
-        MYSQL_BIND  bind[81+1]; //+1 == runID
-        MYSQL_STMT  *stmt;
-
+    struct RstData {
         //Position
         uint64_t numSimplify;
         uint64_t sumRestarts;
@@ -302,6 +309,15 @@ private:
         uint64_t trailSize;
     };
 
+    struct StmtRst : public RstData {
+        StmtRst() :
+            stmt(NULL)
+        {};
+
+        MYSQL_BIND  bind[81+1]; //+1 == runID
+        MYSQL_STMT  *stmt;
+    };
+
     struct StmtSizeGlueScatter {
         StmtSizeGlueScatter() :
             stmt(NULL)
@@ -322,4 +338,72 @@ private:
     StmtClsDistrib stmtClsDistribGlue;
 
     MYSQL *serverConn;
+
+    //Rows waiting to be written by the writer thread
+    struct VarDump {
+        uint64_t numSimplify;
+        uint64_t sumRestarts;
+        uint64_t sumConflicts;
+        double cpuTime;
+        vector<StmtVar::Data> data;
+    };
+
+    struct Distrib {
+        uint64_t sumConflicts;
+        vector<uint32_t> num;
+    };
+
+    struct SizeGlueScatter {
+        uint64_t sumConflicts;
+        size_t numGlues;
+        vector<uint32_t> num; ///<Row-major, size*numGlues + glue
+    };
+
+    struct Batch {
+        vector<RstData> rst;
+        vector<ReduceDBData> reduceDB;
+        vector<VarDump> varDump;
+        vector<Distrib> sizeDistrib;
+        vector<Distrib> glueDistrib;
+        vector<SizeGlueScatter> scatter;
+
+        size_t size() const
+        {
+            return rst.size() + reduceDB.size() + varDump.size()
+                + sizeDistrib.size() + glueDistrib.size() + scatter.size();
+        }
+
+        void swap(Batch& other);
+        void clear();
+    };
+
+    ///Must hold queueMutex. Returns false (and counts the drop) if full.
+    ///Exits if the writer thread has failed
+    bool roomInQueue();
+    void queued(); ///<Must hold queueMutex
+
+    //The writer thread does not call exit(): on an error it stops, and
+    //leaves the message in 'writerError' for the main thread to report
+    void writerThreadMain();
+    void exitOnWriterError(); ///<Main thread only
+    bool writeBatch(Batch& batch);
+    bool writeBatchRows(const Batch& batch);
+    bool execute(MYSQL_STMT* stmt, const char* what);
+    bool query(const string& sql);
+    bool writeVarDump(const VarDump& dump);
+    bool writeDistrib(StmtClsDistrib& stmt, const Distrib& distrib);
+    bool writeScatter(const SizeGlueScatter& scatter);
+
+    static const size_t flushEvery = 64; ///<Wake writer at this many items
+    Batch pending;
+    size_t maxQueued;
+    uint64_t numDropped;
+    uint64_t numBatches;
+    uint64_t verbosity;
+    bool finishing;
+    bool writerFailed; ///<Set under queueMutex by the writer thread
+    string writerError;
+    std::mutex queueMutex;
+    std::condition_variable queueCond;
+    std::thread* writerThread;
 };
\ No newline at end of file
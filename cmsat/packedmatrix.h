@@ -23,11 +23,24 @@
 #define PACKEDMATRIX_H
 
 #include <algorithm>
+#include <new>
+#include <stdlib.h>
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
 #include "constants.h"
 #include "packedrow.h"
 
 //#define DEBUG_MATRIX
 
+namespace CMSat {
+
+/**
+@brief Rows of bits, each with a matrix and a varset part
+
+Both parts of a row start with their is_true word, and their bits start at a
+64-byte boundary, so that the row operations can use aligned vector loads.
+*/
 class PackedMatrix
 {
 public:
@@ -46,21 +59,21 @@ public:
         assert(b.numRows > 0 && b.numCols > 0);
         #endif
 
-        mp = new uint64_t[numRows*2*(numCols+1)];
-        memcpy(mp, b.mp, sizeof(uint64_t)*numRows*2*(numCols+1));
+        mp = allocWords(numRows*rowWords(numCols));
+        memcpy(mp, b.mp, sizeof(uint64_t)*numRows*rowWords(numCols));
     }
 
     ~PackedMatrix()
     {
-        delete[] mp;
+        freeWords(mp);
     }
 
     void resize(const uint32_t num_rows, uint32_t num_cols)
     {
         num_cols = num_cols / 64 + (bool)(num_cols % 64);
-        if (numRows*2*(numCols+1) < num_rows*2*(num_cols+1)) {
-            delete[] mp;
-            mp = new uint64_t[num_rows*2*(num_cols+1)];
+        if (numRows*rowWords(numCols) < num_rows*rowWords(num_cols)) {
+            freeWords(mp);
+            mp = allocWords(num_rows*rowWords(num_cols));
         }
         numRows = num_rows;
         numCols = num_cols;
@@ -81,14 +94,14 @@ public:
         //assert(b.numRows > 0 && b.numCols > 0);
         #endif
 
-        if (numRows*2*(numCols+1) < b.numRows*2*(b.numCols+1)) {
-            delete[] mp;
-            mp = new uint64_t[b.numRows*2*(b.numCols+1)];
+        if (numRows*rowWords(numCols) < b.numRows*rowWords(b.numCols)) {
+            freeWords(mp);
+            mp = allocWords(b.numRows*rowWords(b.numCols));
         }
 
         numRows = b.numRows;
         numCols = b.numCols;
-        memcpy(mp, b.mp, sizeof(uint64_t)*numRows*2*(numCols+1));
+        memcpy(mp, b.mp, sizeof(uint64_t)*numRows*rowWords(numCols));
 
         return *this;
     }
@@ -99,7 +112,7 @@ public:
         assert(i <= numRows);
         #endif
 
-        return PackedRow(numCols, mp+i*2*(numCols+1));
+        return PackedRow(numCols, mp+i*rowWords(numCols)+7);
     }
     inline PackedRow getVarsetAt(const uint32_t i)
     {
@@ -107,7 +120,7 @@ public:
         assert(i <= numRows);
         #endif
 
-        return PackedRow(numCols, mp+i*2*(numCols+1)+(numCols+1));
+        return PackedRow(numCols, mp+i*rowWords(numCols)+PackedRow::halfWords(numCols)+7);
     }
 
     inline const PackedRow getMatrixAt(const uint32_t i) const
@@ -116,7 +129,7 @@ public:
         assert(i <= numRows);
         #endif
 
-        return PackedRow(numCols, mp+i*2*(numCols+1));
+        return PackedRow(numCols, mp+i*rowWords(numCols)+7);
     }
 
     inline const PackedRow getVarsetAt(const uint32_t i) const
@@ -125,7 +138,7 @@ public:
         assert(i <= numRows);
         #endif
 
-        return PackedRow(numCols, mp+i*2*(numCols+1)+(numCols+1));
+        return PackedRow(numCols, mp+i*rowWords(numCols)+PackedRow::halfWords(numCols)+7);
     }
 
     class iterator
@@ -138,33 +151,33 @@ public:
 
         iterator& operator++()
         {
-            mp += 2*(numCols+1);
+            mp += rowWords(numCols);
             return *this;
         }
 
         iterator operator+(const uint32_t num) const
         {
             iterator ret(*this);
-            ret.mp += 2*(numCols+1)*num;
+            ret.mp += rowWords(numCols)*num;
             return ret;
         }
 
-        const uint32_t operator-(const iterator& b) const
+        uint32_t operator-(const iterator& b) const
         {
-            return (mp - b.mp)/(2*(numCols+1));
+            return (mp - b.mp)/rowWords(numCols);
         }
 
         void operator+=(const uint32_t num)
         {
-            mp += 2*(numCols+1)*num;
+            mp += rowWords(numCols)*num;
         }
 
-        const bool operator!=(const iterator& it) const
+        bool operator!=(const iterator& it) const
         {
             return mp != it.mp;
         }
 
-        const bool operator==(const iterator& it) const
+        bool operator==(const iterator& it) const
         {
             return mp == it.mp;
         }
@@ -183,35 +196,65 @@ public:
 
     inline iterator beginMatrix()
     {
-        return iterator(mp, numCols);
+        return iterator(mp+7, numCols);
     }
 
     inline iterator endMatrix()
     {
-        return iterator(mp+numRows*2*(numCols+1), numCols);
+        return iterator(mp+numRows*rowWords(numCols)+7, numCols);
     }
 
     inline iterator beginVarset()
     {
-        return iterator(mp+(numCols+1), numCols);
+        return iterator(mp+PackedRow::halfWords(numCols)+7, numCols);
     }
 
     inline iterator endVarset()
     {
-        return iterator(mp+(numCols+1)+numRows*2*(numCols+1), numCols);
+        return iterator(mp+PackedRow::halfWords(numCols)+numRows*rowWords(numCols)+7, numCols);
     }
 
-    inline const uint32_t getSize() const
+    inline uint32_t getSize() const
     {
         return numRows;
     }
 
 private:
+    static uint32_t rowWords(const uint32_t numCols)
+    {
+        return 2*PackedRow::halfWords(numCols);
+    }
+
+    static uint64_t* allocWords(const size_t num)
+    {
+        void* mem = NULL;
+        #ifdef _MSC_VER
+        mem = _aligned_malloc(num*sizeof(uint64_t), 64);
+        #else
+        if (posix_memalign(&mem, 64, num*sizeof(uint64_t)) != 0)
+            mem = NULL;
+        #endif
+        if (mem == NULL && num > 0)
+            throw std::bad_alloc();
+
+        return (uint64_t*)mem;
+    }
+
+    static void freeWords(uint64_t* words)
+    {
+        #ifdef _MSC_VER
+        _aligned_free(words);
+        #else
+        free(words);
+        #endif
+    }
 
     uint64_t* mp;
     uint32_t numRows;
     uint32_t numCols;
 };
 
+} //end namespace
+
 #endif //PACKEDMATRIX_H
 
@@ -32,6 +32,291 @@
 
 using namespace CMSat;
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define USE_ROW_SIMD
+#include <immintrin.h>
+#endif
+
+//Portable versions
+
+static void xorWordsGeneric(uint64_t* __restrict a, const uint64_t* __restrict b, const uint32_t num)
+{
+    for (uint32_t i = 0; i != num; i++) {
+        a[i] ^= b[i];
+    }
+}
+
+static uint32_t popcntGeneric(const uint64_t* a, const uint32_t num)
+{
+    uint32_t ret = 0;
+    for (uint32_t i = 0; i != num; i++) {
+        ret += __builtin_popcount(a[i] & 0xffffffff);
+        ret += __builtin_popcount(a[i] >> 32);
+    }
+    return ret;
+}
+
+static bool popcntIsOneGeneric(const uint64_t* a, const uint32_t num)
+{
+    uint32_t ret = 0;
+    for (uint32_t i = 0; i != num; i++) {
+        ret += __builtin_popcount(a[i] & 0xffffffff);
+        ret += __builtin_popcount(a[i] >> 32);
+        if (ret > 1)
+            return false;
+    }
+    return ret == 1;
+}
+
+#ifdef USE_ROW_SIMD
+
+//Hardware popcount. The XOR is left to the compiler, SSE2 is always there
+
+__attribute__((target("popcnt")))
+static uint32_t popcntSSE42(const uint64_t* a, const uint32_t num)
+{
+    uint64_t ret = 0;
+    for (uint32_t i = 0; i != num; i++) {
+        ret += __builtin_popcountll(a[i]);
+    }
+    return ret;
+}
+
+__attribute__((target("popcnt")))
+static bool popcntIsOneSSE42(const uint64_t* a, const uint32_t num)
+{
+    uint64_t ret = 0;
+    for (uint32_t i = 0; i != num; i++) {
+        ret += __builtin_popcountll(a[i]);
+        if (ret > 1)
+            return false;
+    }
+    return ret == 1;
+}
+
+//AVX2: 4 words at a time. It has no popcount instruction, the bytes are
+//counted through a nibble lookup table with vpshufb, as per Mula et al.
+
+__attribute__((target("avx2")))
+static void xorWordsAVX2(uint64_t* __restrict a, const uint64_t* __restrict b, const uint32_t num)
+{
+    uint32_t i = 0;
+    for (; i + 4 <= num; i += 4) {
+        const __m256i x = _mm256_load_si256((const __m256i*)(a + i));
+        const __m256i y = _mm256_load_si256((const __m256i*)(b + i));
+        _mm256_store_si256((__m256i*)(a + i), _mm256_xor_si256(x, y));
+    }
+    for (; i != num; i++) {
+        a[i] ^= b[i];
+    }
+}
+
+__attribute__((target("avx2,popcnt")))
+static uint32_t popcntAVX2(const uint64_t* a, const uint32_t num)
+{
+    const __m256i lookup = _mm256_setr_epi8(
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+        , 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+    );
+    const __m256i lowMask = _mm256_set1_epi8(0x0f);
+
+    __m256i acc = _mm256_setzero_si256();
+    uint32_t i = 0;
+    for (; i + 4 <= num; i += 4) {
+        const __m256i x = _mm256_load_si256((const __m256i*)(a + i));
+        const __m256i lo = _mm256_and_si256(x, lowMask);
+        const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(x, 4), lowMask);
+        const __m256i cnt = _mm256_add_epi8(
+            _mm256_shuffle_epi8(lookup, lo)
+            , _mm256_shuffle_epi8(lookup, hi)
+        );
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(cnt, _mm256_setzero_si256()));
+    }
+
+    uint64_t ret = _mm256_extract_epi64(acc, 0) + _mm256_extract_epi64(acc, 1)
+        + _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3);
+    for (; i != num; i++) {
+        ret += __builtin_popcountll(a[i]);
+    }
+    return ret;
+}
+
+__attribute__((target("avx2,popcnt")))
+static bool popcntIsOneAVX2(const uint64_t* a, const uint32_t num)
+{
+    uint64_t ret = 0;
+    uint32_t i = 0;
+    for (; i + 4 <= num; i += 4) {
+        const __m256i x = _mm256_load_si256((const __m256i*)(a + i));
+        if (_mm256_testz_si256(x, x))
+            continue;
+
+        ret += __builtin_popcountll(a[i]) + __builtin_popcountll(a[i+1])
+            + __builtin_popcountll(a[i+2]) + __builtin_popcountll(a[i+3]);
+        if (ret > 1)
+            return false;
+    }
+    for (; i != num; i++) {
+        ret += __builtin_popcountll(a[i]);
+    }
+    return ret == 1;
+}
+
+//AVX-512: 8 words at a time, the rest through a mask
+
+__attribute__((target("avx512f")))
+static uint64_t sumLanesAVX512(const __m512i x)
+{
+    uint64_t lanes[8];
+    _mm512_storeu_si512(lanes, x);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3]
+        + lanes[4] + lanes[5] + lanes[6] + lanes[7];
+}
+
+__attribute__((target("avx512f")))
+static void xorWordsAVX512(uint64_t* __restrict a, const uint64_t* __restrict b, const uint32_t num)
+{
+    uint32_t i = 0;
+    for (; i + 8 <= num; i += 8) {
+        const __m512i x = _mm512_load_si512(a + i);
+        const __m512i y = _mm512_load_si512(b + i);
+        _mm512_store_si512(a + i, _mm512_xor_si512(x, y));
+    }
+    if (i != num) {
+        const __mmask8 mask = (__mmask8)((1U << (num - i)) - 1);
+        const __m512i x = _mm512_maskz_load_epi64(mask, a + i);
+        const __m512i y = _mm512_maskz_load_epi64(mask, b + i);
+        _mm512_mask_store_epi64(a + i, mask, _mm512_xor_si512(x, y));
+    }
+}
+
+__attribute__((target("avx512f,avx512vpopcntdq")))
+static uint32_t popcntAVX512(const uint64_t* a, const uint32_t num)
+{
+    __m512i acc = _mm512_setzero_si512();
+    uint32_t i = 0;
+    for (; i + 8 <= num; i += 8) {
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_load_si512(a + i)));
+    }
+    if (i != num) {
+        const __mmask8 mask = (__mmask8)((1U << (num - i)) - 1);
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_maskz_load_epi64(mask, a + i)));
+    }
+    return sumLanesAVX512(acc);
+}
+
+__attribute__((target("avx512f,avx512vpopcntdq")))
+static bool popcntIsOneAVX512(const uint64_t* a, const uint32_t num)
+{
+    uint64_t ret = 0;
+    uint32_t i = 0;
+    for (; i < num; i += 8) {
+        const __mmask8 mask = (num - i >= 8) ? 0xff : (__mmask8)((1U << (num - i)) - 1);
+        const __m512i x = _mm512_maskz_load_epi64(mask, a + i);
+        if (_mm512_test_epi64_mask(x, x) == 0)
+            continue;
+
+        ret += sumLanesAVX512(_mm512_popcnt_epi64(x));
+        if (ret > 1)
+            return false;
+    }
+    return ret == 1;
+}
+
+#endif //USE_ROW_SIMD
+
+static RowSimd detectRowSimd()
+{
+    #ifdef USE_ROW_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")
+        && __builtin_cpu_supports("avx512vpopcntdq")
+    ) {
+        return RowSimd::avx512;
+    }
+
+    if (__builtin_cpu_supports("avx2")
+        && __builtin_cpu_supports("popcnt")
+    ) {
+        return RowSimd::avx2;
+    }
+
+    if (__builtin_cpu_supports("popcnt"))
+        return RowSimd::sse42;
+    #endif //USE_ROW_SIMD
+
+    return RowSimd::generic;
+}
+
+static RowKernels getKernels(const RowSimd simd)
+{
+    RowKernels kernels;
+    kernels.xorWords = xorWordsGeneric;
+    kernels.popcnt = popcntGeneric;
+    kernels.popcntIsOne = popcntIsOneGeneric;
+
+    #ifdef USE_ROW_SIMD
+    switch(simd) {
+        case RowSimd::avx512:
+            kernels.xorWords = xorWordsAVX512;
+            kernels.popcnt = popcntAVX512;
+            kernels.popcntIsOne = popcntIsOneAVX512;
+            break;
+
+        case RowSimd::avx2:
+            kernels.xorWords = xorWordsAVX2;
+            kernels.popcnt = popcntAVX2;
+            kernels.popcntIsOne = popcntIsOneAVX2;
+            break;
+
+        case RowSimd::sse42:
+            kernels.popcnt = popcntSSE42;
+            kernels.popcntIsOne = popcntIsOneSSE42;
+            break;
+
+        case RowSimd::generic:
+            break;
+    }
+    #endif //USE_ROW_SIMD
+
+    return kernels;
+}
+
+static const RowSimd cpuRowSimd = detectRowSimd();
+static RowSimd currRowSimd = cpuRowSimd;
+RowKernels CMSat::rowKernels = getKernels(cpuRowSimd);
+
+RowSimd CMSat::getRowSimd()
+{
+    return currRowSimd;
+}
+
+RowSimd CMSat::setRowSimd(const RowSimd simd)
+{
+    currRowSimd = std::min(simd, cpuRowSimd);
+    rowKernels = getKernels(currRowSimd);
+    return currRowSimd;
+}
+
+const char* CMSat::rowSimdName(const RowSimd simd)
+{
+    switch(simd) {
+        case RowSimd::avx512:
+            return "avx512";
+
+        case RowSimd::avx2:
+            return "avx2";
+
+        case RowSimd::sse42:
+            return "sse4.2";
+
+        case RowSimd::generic:
+            return "generic";
+    }
+
+    return "unknown";
+}
+
 bool PackedRow::operator ==(const PackedRow& b) const
 {
     #ifdef DEBUG_ROW
@@ -54,36 +339,24 @@ bool PackedRow::operator !=(const PackedRow& b) const
     return (!std::equal(b.mp-1, b.mp+size, mp-1));
 }
 
-uint32_t PackedRow::popcnt() const
-{
-    uint32_t popcnt = 0;
-    for (uint32_t i = 0; i < size; i++) if (mp[i]) {
-        uint64_t tmp = mp[i];
-        for (uint32_t i2 = 0; i2 < 64; i2++) {
-            popcnt += (tmp & 1);
-            tmp >>= 1;
-        }
-    }
-    return popcnt;
-}
-
 uint32_t PackedRow::popcnt(const uint32_t from) const
 {
-    uint32_t popcnt = 0;
-    for (uint32_t i = from/64; i != size; i++) if (mp[i]) {
-        uint64_t tmp = mp[i];
-        uint32_t i2;
-        if (i == from/64) {
-            i2 = from%64;
-            tmp >>= i2;
-        } else
-            i2 = 0;
-        for (; i2 < 64; i2++) {
-            popcnt += (tmp & 1);
-            tmp >>= 1;
-        }
+    const uint32_t at = from/64;
+    if (at >= size)
+        return 0;
+
+    const uint64_t first = mp[at] >> (from%64);
+    uint32_t ret = __builtin_popcount(first & 0xffffffff)
+        + __builtin_popcount(first >> 32);
+
+    //The kernels need aligned words, the ones before are counted here
+    const uint32_t aligned = std::min(size, (at + 8) & ~7U);
+    for (uint32_t i = at + 1; i < aligned; i++) {
+        ret += __builtin_popcount(mp[i] & 0xffffffff);
+        ret += __builtin_popcount(mp[i] >> 32);
     }
-    return popcnt;
+
+    return ret + rowKernels.popcnt(mp + aligned, size - aligned);
 }
 
 bool PackedRow::fill(vector<Lit>& tmp_clause, const vector<lbool>& assigns, const vector<Var>& col_to_var_original) const
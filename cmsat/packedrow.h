@@ -28,6 +28,7 @@
 #include "constants.h"
 #include "solvertypes.h"
 #include "vec.h"
+#include "xor.h"
 #include <string.h>
 #include <iostream>
 #include <algorithm>
@@ -38,6 +39,33 @@ using std::vector;
 
 class PackedMatrix;
 
+///Instruction sets the row operations can use
+enum class RowSimd {
+    generic = 0
+    , sse42 = 1 ///<Hardware popcount
+    , avx2 = 2
+    , avx512 = 3 ///<AVX-512F with VPOPCNTDQ
+};
+
+/**
+@brief The operations on the words of the rows, for the best instruction set the CPU has
+
+The words must start at a 64-byte boundary, as the bits of the rows of a
+PackedMatrix do, since the vector kernels use aligned loads.
+*/
+struct RowKernels
+{
+    void (*xorWords)(uint64_t* a, const uint64_t* b, uint32_t num);
+    uint32_t (*popcnt)(const uint64_t* a, uint32_t num);
+    bool (*popcntIsOne)(const uint64_t* a, uint32_t num);
+};
+extern RowKernels rowKernels;
+
+RowSimd getRowSimd();
+///Use a lower instruction set than the CPU has, e.g. to compare them. Returns the one used
+RowSimd setRowSimd(const RowSimd simd);
+const char* rowSimdName(const RowSimd simd);
+
 class PackedRow
 {
 public:
@@ -52,7 +80,7 @@ public:
         assert(size == b.size);
         #endif
 
-        memcpy(mp-1, b.mp-1, size+1);
+        memcpy(mp-1, b.mp-1, sizeof(uint64_t)*(size+1));
         return *this;
     }
 
@@ -64,8 +92,13 @@ public:
         assert(b.size == size);
         #endif
 
-        for (uint32_t i = 0; i != size; i++) {
-            *(mp + i) ^= *(b.mp + i);
+        //Rows this short are not worth the call
+        if (size < 4) {
+            for (uint32_t i = 0; i != size; i++) {
+                mp[i] ^= b.mp[i];
+            }
+        } else {
+            rowKernels.xorWords(mp, b.mp, size);
         }
 
         is_true_internal ^= b.is_true_internal;
@@ -80,38 +113,33 @@ public:
         assert(b.size == size);
         #endif
 
-        for (uint32_t i = 0; i != 2*size+1; i++) {
-            *(mp + i) ^= *(b.mp + i);
+        //The varset part starts with its is_true, its bits are aligned
+        const uint32_t half = halfWords(size);
+        if (size < 4) {
+            for (uint32_t i = 0; i != size; i++) {
+                mp[i] ^= b.mp[i];
+            }
+            for (uint32_t i = half - 1; i != half + size; i++) {
+                mp[i] ^= b.mp[i];
+            }
+        } else {
+            rowKernels.xorWords(mp, b.mp, size);
+            mp[half - 1] ^= b.mp[half - 1];
+            rowKernels.xorWords(mp + half, b.mp + half, size);
         }
 
         is_true_internal ^= b.is_true_internal;
     }
 
-
-    uint32_t popcnt() const;
+    uint32_t popcnt() const
+    {
+        return rowKernels.popcnt(mp, size);
+    }
     uint32_t popcnt(uint32_t from) const;
 
     bool popcnt_is_one() const
     {
-        #if __GNUC__ >= 4
-        int ret = 0;
-        for (uint32_t i = 0; i != size; i++) {
-            ret += __builtin_popcount(mp[i]&0xffffffff);
-            ret += __builtin_popcount(mp[i]>>32);
-            if (ret > 1) return false;
-        }
-        return ret == 1;
-        #else
-        uint32_t popcount = 0;
-        for (uint32_t i = 0; i != size; i++) {
-            uint64_t tmp = mp[i];
-            while(tmp) {
-                popcount += tmp & 1;
-                tmp >>= 1;
-            }
-        }
-        return popcount == 1;
-        #endif
+        return rowKernels.popcntIsOne(mp, size);
     }
 
     bool popcnt_is_one(uint32_t from) const
@@ -171,7 +199,8 @@ public:
         uint64_t * __restrict mp1 = mp-1;
         uint64_t * __restrict mp2 = b.mp-1;
 
-        uint32_t i = 2*(size+1);
+        //Both parts, with the padding between them
+        uint32_t i = halfWords(size) + size + 1;
 
         while(i != 0) {
             std::swap(*mp1, *mp2);
@@ -206,6 +235,17 @@ public:
         is_true_internal = !v.xorEqualFalse();
     }
 
+    ///Set to the XOR 'x', whose variables are in the columns given by var_to_col
+    void set(const Xor& x, const vector<uint32_t>& var_to_col)
+    {
+        setZero();
+        for (uint32_t i = 0; i != x.vars.size(); i++) {
+            setBit(var_to_col[x.vars[i]]);
+        }
+
+        is_true_internal = x.rhs;
+    }
+
     bool fill(vector<Lit>& tmp_clause, const vector<lbool>& assigns, const vector<Var>& col_to_var_original) const;
 
     unsigned long int scan(const unsigned long int var) const
@@ -221,12 +261,40 @@ public:
         return std::numeric_limits<unsigned long int>::max();
     }
 
+    ///The first set bit at or after 'from', or getSize()*64 if there is none
+    uint32_t nextBit(const uint32_t from) const
+    {
+        uint32_t at = from/64;
+        if (at >= size)
+            return size*64;
+
+        uint64_t tmp = mp[at] & ((~(uint64_t)0) << (from%64));
+        while(tmp == 0) {
+            at++;
+            if (at == size)
+                return size*64;
+            tmp = mp[at];
+        }
+        return at*64 + __builtin_ctzll(tmp);
+    }
+
     //friend ::std::ostream& operator << (std::ostream& os, const PackedRow& m);
     uint32_t getSize() const
     {
         return size;
     }
 
+    /**
+    @brief Words taken by the matrix or the varset part of a row of 'size' words
+
+    The part is padded so that its words start at a 64-byte boundary, after
+    its is_true, and is a multiple of 64 bytes long.
+    */
+    static uint32_t halfWords(const uint32_t size)
+    {
+        return 8 + ((size + 7) & ~7U);
+    }
+
 private:
     friend class PackedMatrix;
     PackedRow(const uint32_t _size, uint64_t*  const _mp) :
@@ -32,6 +32,7 @@
 #include "time_mem.h"
 #include "clausecleaner.h"
 #include "completedetachreattacher.h"
+#include "inprocsched.h"
 
 using namespace CMSat;
 using std::make_pair;
@@ -192,6 +193,7 @@ bool Prober::probe()
     }
 
     numPropsTodo = (uint64_t) ((double)numPropsTodo * numPropsMultiplier * solver->conf.probeMultiplier);
+    numPropsTodo = (double)numPropsTodo * solver->inprocSched->budget(Inproc::probe);
     const size_t numPropsTodoAftPerf = numPropsTodo;
     numPropsTodo = (double)numPropsTodo * std::pow((double)(globalStats.numCalls+1), 0.2);
 
@@ -602,7 +604,7 @@ bool Prober::tryThis(const Lit lit, const bool first)
                     }
                     (*solver->drup)
                     << litToEnq
-                    << " 0\n";
+                    << DrupFlag::fin;
                 }
                 #endif
             }
@@ -685,7 +687,7 @@ bool Prober::tryThis(const Lit lit, const bool first)
             if (solver->drup) {
                 (*solver->drup)
                 << (~lit)
-                << " 0\n";
+                << DrupFlag::fin;
             }
             #endif
         }
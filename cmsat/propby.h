@@ -32,18 +32,19 @@
 
 namespace CMSat {
 
-enum PropByType {null_clause_t = 0, clause_t = 1, binary_t = 2, tertiary_t = 3};
+enum PropByType {null_clause_t = 0, clause_t = 1, binary_t = 2, tertiary_t = 3, xor_t = 4};
 
 class PropBy
 {
     private:
         uint32_t data1;
-        uint32_t type:2;
+        uint32_t type:3;
         //0: clause, NULL
         //1: clause, non-null
         //2: binary
         //3: tertiary
-        uint32_t data2:30;
+        //4: XOR constraint, or row of a Gauss-Jordan matrix
+        uint32_t data2:29;
 
     public:
         PropBy() :
@@ -94,6 +95,16 @@ class PropBy
         {
         }
 
+        //The literals are calculated when needed, see PropEngine::getXorReason().
+        //Those of a Gauss-Jordan matrix are stored, and 'num' is the variable
+        //set, or var_Undef for a conflict
+        PropBy(const uint32_t num, const PropByType, const bool gauss = false) :
+            data1(num)
+            , type(xor_t)
+            , data2(gauss)
+        {
+        }
+
         bool getLearntStep() const
         {
             return data2 & 1U;
@@ -155,6 +166,19 @@ class PropBy
             return Lit::toLit(data2);
         }
 
+        uint32_t getXor() const
+        {
+            #ifdef DEBUG_PROPAGATEFROM
+            assert(type == xor_t);
+            #endif
+            return data1;
+        }
+
+        bool isGauss() const
+        {
+            return type == xor_t && data2 == 1;
+        }
+
         ClOffset getClause() const
         {
             #ifdef DEBUG_PROPAGATEFROM
@@ -196,6 +220,13 @@ inline std::ostream& operator<<(std::ostream& os, const PropBy& pb)
             os << " clause, num= " << pb.getClause();
             break;
 
+        case xor_t :
+            if (pb.isGauss())
+                os << " gauss, var= " << pb.getXor();
+            else
+                os << " xor, num= " << pb.getXor();
+            break;
+
         case null_clause_t :
             os << " NULL";
             break;
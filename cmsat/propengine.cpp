@@ -50,6 +50,7 @@ PropEngine::PropEngine(
     , const AgilityData& agilityData
     , const bool _updateGlues
     , const bool _doLHBR
+    , const bool _doTrailSave
 ) :
         // Stats
         #ifdef DRUP
@@ -57,10 +58,13 @@ PropEngine::PropEngine(
         #endif
         updateGlues(_updateGlues)
         , doLHBR (_doLHBR)
+        , doTrailSave(_doTrailSave)
 
         , clAllocator(_clAllocator)
         , ok(true)
+        , xorsAttached(false)
         , qhead(0)
+        , outOfOrderTrail(false)
         , minNumVars(0)
         , agility(agilityData)
         , stampingTime(0)
@@ -86,6 +90,7 @@ Var PropEngine::newVar(const bool)
     watches.resize(watches.size() + 2);  // (list for positive&negative literals)
     assigns.push_back(l_Undef);
     varData.push_back(VarData());
+    savedTrailAt.push_back(0);
 
     #ifdef STATS_NEEDED
     varDataLT.push_back(VarData::Stats());
@@ -262,6 +267,159 @@ inline bool PropEngine::propBinaryClause(
     return true;
 }
 
+/**
+@brief Propagates an at-most-one constraint
+
+'p' is one of its literals: all the others are set to FALSE. Each of these is
+explained by the binary clause (~p V ~other) of the pairwise encoding, so the
+reasons and the conflicts are those of binary clauses, and analysis needs no
+explanation clause from the constraint
+*/
+inline bool PropEngine::propCard(
+    const vec<Watched>::const_iterator i
+    , const Lit p
+    , PropBy& confl
+) {
+    const vector<Lit>& card = cards[i->getCard()];
+    for(vector<Lit>::const_iterator
+        it = card.begin(), end = card.end()
+        ; it != end
+        ; it++
+    ) {
+        if (*it == p)
+            continue;
+
+        const lbool val = value(*it);
+        if (val == l_Undef) {
+            #ifdef STATS_NEEDED
+            propStats.propsBinIrred++;
+            #endif
+
+            enqueue(~*it, PropBy(~p));
+        } else if (val == l_True) {
+            lastConflictCausedBy = ConflCausedBy::binirred;
+            confl = PropBy(~p);
+            failBinLit = ~*it;
+            qhead = trail.size();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+@brief Propagates an XOR constraint
+
+Its two watched variables are vars[0] and vars[1], and it is in the
+watchlists of both literals of each. If another unset variable is found, it
+is watched instead of the variable of 'p'. Otherwise vars[0] must make the
+parity right. The reason is not stored, getXorReason() calculates it.
+*/
+template<bool simple>
+PropResult PropEngine::propXor(
+    const vec<Watched>::iterator i
+    , vec<Watched>::iterator &j
+    , const Lit p
+    , PropBy& confl
+) {
+    propStats.bogoProps += 4;
+    const uint32_t num = i->getXor();
+    Xor& x = xors[num];
+
+    //Make sure the var of 'p' is vars[1]
+    if (x.vars[0] == p.var()) {
+        std::swap(x.vars[0], x.vars[1]);
+    }
+    assert(x.vars[1] == p.var());
+
+    //Look for new watch, calculating the parity of the rest meanwhile
+    bool rhs = x.rhs ^ (value(p.var()) == l_True);
+    for(vector<Var>::iterator
+        k = x.vars.begin() + 2, end = x.vars.end()
+        ; k != end
+        ; k++
+    ) {
+        const lbool val = value(*k);
+        if (val == l_Undef) {
+            std::swap(x.vars[1], *k);
+            removeWXor(watches[p.toInt()], num);
+            watches[Lit(x.vars[1], false).toInt()].push(Watched(num, watch_xor_t));
+            watches[Lit(x.vars[1], true).toInt()].push(Watched(num, watch_xor_t));
+            return PROP_NOTHING;
+        }
+        rhs ^= (val == l_True);
+    }
+    propStats.bogoProps += x.vars.size()/4;
+
+    // Did not find watch -- vars[0] must be 'rhs'
+    *j++ = *i;
+    const Lit lit = Lit(x.vars[0], !rhs);
+    const lbool val = value(lit);
+    if (val == l_True)
+        return PROP_NOTHING;
+
+    if (val == l_False) {
+        confl = PropBy(num, xor_t);
+        lastConflictCausedBy = ConflCausedBy::longirred;
+        qhead = trail.size();
+        return PROP_FAIL;
+    }
+
+    #ifdef STATS_NEEDED
+    propStats.propsLongIrred++;
+    #endif
+    if (simple) {
+        enqueue(lit, PropBy(num, xor_t));
+    } else {
+        getXorReason(PropBy(num, xor_t), lit, xorReason);
+        addHyperBin(lit, xorReason);
+    }
+
+    return PROP_SOMETHING;
+}
+
+/**
+@brief The clause of an XOR constraint that is unit or false
+
+Every other variable of the XOR is set, their literals are the ones that are
+false under the current assignment. 'p', if not lit_Undef, is put first.
+The clauses of the rows of a Gauss-Jordan matrix are stored when they
+propagate or are in conflict, in the same form.
+*/
+void PropEngine::getXorReason(
+    const PropBy& reason
+    , const Lit p
+    , vector<Lit>& out
+) const {
+    if (reason.isGauss()) {
+        if (reason.getXor() == var_Undef) {
+            out = gaussConflict;
+        } else {
+            out = gaussReasons[reason.getXor()];
+            assert(p == lit_Undef || out[0] == p);
+        }
+        return;
+    }
+
+    out.clear();
+    if (p != lit_Undef)
+        out.push_back(p);
+
+    const Xor& x = xors[reason.getXor()];
+    for(vector<Var>::const_iterator
+        it = x.vars.begin(), end = x.vars.end()
+        ; it != end
+        ; it++
+    ) {
+        if (p != lit_Undef && *it == p.var())
+            continue;
+
+        assert(value(*it) != l_Undef);
+        out.push_back(Lit(*it, value(*it) == l_True));
+    }
+}
+
 
 /**
 @brief Propagates a normal (n-long where n > 3) clause
@@ -285,6 +443,11 @@ PropResult PropEngine::propNormalClause(
     propStats.bogoProps += 4;
     const ClOffset offset = i->getOffset();
     Clause& c = *clAllocator->getPointer(offset);
+
+    //Freed by reduceDB(), drop the watch
+    if (c.freed())
+        return PROP_NOTHING;
+
     #ifdef STATS_NEEDED
     c.stats.numLookedAt++;
     c.stats.numLitVisited++;
@@ -386,9 +549,9 @@ PropResult PropEngine::propNormalClause(
                     #ifdef DRUP
                     if (solver->drup) {
                         (*solver->drup)
-                        << other << " "
+                        << other
                         << c[0]
-                        << " 0\n";
+                        << DrupFlag::fin;
                     }
                     #endif
                     enqueue(c[0], PropBy(other));
@@ -434,6 +597,11 @@ bool PropEngine::propNormalClauseAnyOrder(
     propStats.bogoProps += 4;
     const ClOffset offset = i->getOffset();
     Clause& c = *clAllocator->getPointer(offset);
+
+    //Freed by reduceDB(), drop the watch
+    if (c.freed())
+        return true;
+
     #ifdef STATS_NEEDED
     c.stats.numLookedAt++;
     c.stats.numLitVisited++;
@@ -688,9 +856,9 @@ void PropEngine::propTriHelper(
             #ifdef DRUP
             if (solver->drup) {
                 (*solver->drup)
-                << lit << " "
+                << lit
                 << lit2
-                << " 0\n";
+                << DrupFlag::fin;
             }
             #endif
         } else {
@@ -722,6 +890,85 @@ inline void PropEngine::propTriHelperAnyOrder(
     enqueue(lit2, PropBy(~lit1, lit3));
 }
 
+/**
+@brief Re-sets the implications that followed "p" on the saved trail
+
+The implications are enqueued straight away, with their old reasons, instead
+of being found again through the watchlists. They are still propagated
+normally, but by the time the watchlists are walked the clauses that implied
+them are already satisfied, which is cheap. Stops at the next decision, or at
+the first implication whose reason doesn't hold anymore. Every entry is
+looked at only once.
+*/
+void PropEngine::reimplySaved(const Lit p)
+{
+    uint32_t at = savedTrailAt[p.var()];
+    if (at >= savedTrail.size() || savedTrail[at].lit != p)
+        return;
+
+    savedTrail[at].lit = lit_Undef;
+    for (at++; at < savedTrail.size(); at++) {
+        SavedImpl& saved = savedTrail[at];
+
+        //Decision, or already looked at
+        if (saved.reason.isNULL() || saved.lit == lit_Undef)
+            return;
+
+        const lbool val = value(saved.lit);
+        if (val == l_False || (val == l_Undef && !savedReasonHolds(saved)))
+            return;
+
+        if (val == l_Undef) {
+            enqueue(saved.lit, saved.reason);
+            propStats.reimplied++;
+            propStats.bogoProps += 1;
+        }
+        saved.lit = lit_Undef;
+    }
+}
+
+bool PropEngine::savedReasonHolds(const SavedImpl& saved)
+{
+    switch(saved.reason.getType()) {
+        case binary_t:
+            return value(saved.reason.lit1()) == l_False;
+
+        case tertiary_t:
+            return value(saved.reason.lit1()) == l_False
+                && value(saved.reason.lit2()) == l_False;
+
+        case clause_t: {
+            Clause& cl = *clAllocator->getPointer(saved.reason.getClause());
+            if (cl.freed())
+                return false;
+
+            //Propagated literal must be cl[0], and cl[0] and cl[1] are watched
+            if (cl[1] == saved.lit) {
+                std::swap(cl[0], cl[1]);
+            }
+            if (cl[0] != saved.lit)
+                return false;
+
+            propStats.bogoProps += cl.size()/4;
+            for(const Lit *l = cl.begin() + 1, *end = cl.end(); l != end; l++) {
+                if (value(*l) != l_False)
+                    return false;
+            }
+            return true;
+        }
+
+        case xor_t:
+            //Only propXor() may set a literal through an XOR, it has to be
+            //vars[0] of it, see implicationLevel()
+            break;
+
+        case null_clause_t:
+            break;
+    }
+
+    return false;
+}
+
 PropBy PropEngine::propagateAnyOrder()
 {
     PropBy confl;
@@ -732,6 +979,9 @@ PropBy PropEngine::propagateAnyOrder()
 
     while (qhead < trail.size() && confl.isNULL()) {
         const Lit p = trail[qhead];     // 'p' is enqueued fact to propagate.
+        if (!savedTrail.empty())
+            reimplySaved(p);
+
         vec<Watched>& ws = watches[(~p).toInt()];
         vec<Watched>::iterator i = ws.begin();
         vec<Watched>::iterator j = ws.begin();
@@ -748,6 +998,16 @@ PropBy PropEngine::propagateAnyOrder()
                 continue;
             }
 
+            //Propagate at-most-one constraint
+            if (i->isCard()) {
+                *j++ = *i;
+                if (!propCard(i, p, confl)) {
+                    i++;
+                    break;
+                }
+                continue;
+            }
+
             //Propagate tri clause
             if (i->isTri()) {
                 *j++ = *i;
@@ -766,6 +1026,15 @@ PropBy PropEngine::propagateAnyOrder()
                 }
                 continue;
             }
+
+            //Propagate XOR constraint
+            if (i->isXor()) {
+                if (propXor<true>(i, j, p, confl) == PROP_FAIL) {
+                    i++;
+                    break;
+                }
+                continue;
+            }
         }
         while (i != end) {
             *j++ = *i++;
@@ -801,6 +1070,9 @@ PropBy PropEngine::propagateBinFirst(
     //Propagate binary clauses first
     while (qhead < trail.size() && confl.isNULL()) {
         const Lit p = trail[qhead++];     // 'p' is enqueued fact to propagate.
+        if (!savedTrail.empty())
+            reimplySaved(p);
+
         const vec<Watched>& ws = watches[(~p).toInt()];
         #ifdef STATS_NEEDED
         if (watchListSizeTraversed)
@@ -821,6 +1093,15 @@ PropBy PropEngine::propagateBinFirst(
                 continue;
             }
 
+            //At-most-one constraints only imply binary clauses
+            if (i->isCard()) {
+                if (!propCard(i, p, confl)) {
+                    break;
+                }
+
+                continue;
+            }
+
             //Pre-fetch long clause
             if (i->isClause()) {
                 if (value(i->getBlockedLit()) != l_True) {
@@ -844,8 +1125,8 @@ PropBy PropEngine::propagateBinFirst(
         const vec<Watched>::iterator end = ws.end();
         propStats.bogoProps += ws.size()/4 + 1;
         for (; i != end; i++) {
-            //Skip binary clauses
-            if (i->isBinary()) {
+            //Skip binary clauses and at-most-one constraints
+            if (i->isBinary() || i->isCard()) {
                 *j++ = *i;
                 continue;
             }
@@ -877,6 +1158,19 @@ PropBy PropEngine::propagateBinFirst(
                     continue;
                 }
             } //end CLAUSE
+
+            if (i->isXor()) {
+                ret = propXor<true>(i, j, p, confl);
+                 if (ret == PROP_SOMETHING || ret == PROP_FAIL) {
+                    //Conflict or propagated something
+                    i++;
+                    break;
+                } else {
+                    //Didn't propagate anything, continue
+                    assert(ret == PROP_NOTHING);
+                    continue;
+                }
+            } //end XOR
         }
         while (i != end) {
             *j++ = *i++;
@@ -933,6 +1227,10 @@ Lit PropEngine::propagateFullBFS(const uint64_t timeout)
     assert(uselessBin.empty());
     assert(decisionLevel() == 1);
 
+    //At-most-one constraints are not propagated here, OTF hyper-binary
+    //resolution is off while they are attached
+    assert(cards.empty());
+
     //The toplevel decision has to be set specifically
     //If we came here as part of a backtrack to decision level 1, then
     //this is already set, and there is no need to set it
@@ -1039,6 +1337,17 @@ Lit PropEngine::propagateFullBFS(const uint64_t timeout)
                     continue;
                 }
             }
+
+            if (i->isXor()) {
+                ret = propXor<false>(i, j, p, confl);
+                if (ret == PROP_SOMETHING || ret == PROP_FAIL) {
+                    i++;
+                    break;
+                } else {
+                    assert(ret == PROP_NOTHING);
+                    continue;
+                }
+            }
         }
         propStats.bogoProps += ws.size()*4;
         while(i != end)
@@ -1076,6 +1385,10 @@ Lit PropEngine::propagateFullDFS(
     assert(uselessBin.empty());
     assert(decisionLevel() == 1);
 
+    //At-most-one constraints are not propagated here, OTF hyper-binary
+    //resolution is off while they are attached
+    assert(cards.empty());
+
     //The toplevel decision has to be set specifically
     //If we came here as part of a backtrack to decision level 1, then
     //this is already set, and there is no need to set it
@@ -1293,6 +1606,13 @@ Lit PropEngine::propagateFullDFS(
                     continue;
                 }
             }
+
+            //XOR constraints are only attached for the search, stamping
+            //does not propagate them
+            if (i->isXor()) {
+                *j++ = *i;
+                continue;
+            }
         }
         while(i != end)
             *j++ = *i++;
@@ -1572,6 +1892,13 @@ void PropEngine::updateVars(
     updateArray(assigns, interToOuter);
     updateLitsMap(trail, outerToInter);
     updateBySwap(watches, seen, interToOuter2);
+    for(vector<Xor>::iterator
+        it = xors.begin(), end = xors.end()
+        ; it != end
+        ; it++
+    ) {
+        updateArrayMapCopy(it->vars, outerToInter);
+    }
 
     for(size_t i = 0; i < watches.size(); i++) {
         if (i+10 < watches.size())
@@ -1638,8 +1965,8 @@ void PropEngine::addHyperBin(const Lit p)
         #ifdef DRUP
         if (drup) {
             (*drup)
-            << p << " " << (~deepestAncestor)
-            << " 0\n";
+            << p << (~deepestAncestor)
+            << DrupFlag::fin;
         }
         #endif
         hyperBinNotAdded = false;
@@ -43,6 +43,8 @@
 #include "solverconf.h"
 #include "clauseallocator.h"
 #include "stamp.h"
+#include "drup.h"
+#include "xor.h"
 
 namespace CMSat {
 
@@ -232,6 +234,7 @@ public:
         , const AgilityData& agilityData
         , const bool _updateGlues
         , const bool _doLHBR
+        , const bool _doTrailSave
     );
     ~PropEngine();
 
@@ -260,7 +263,7 @@ public:
     void        resetClauseDataStats(size_t clause_num);
 
     #ifdef DRUP
-    std::ostream* drup;
+    DrupWriter* drup;
     #endif
 
 protected:
@@ -270,6 +273,7 @@ protected:
     template<class T> uint16_t calcGlue(const T& ps); ///<Calculates the glue of a clause
     bool updateGlues;
     bool doLHBR;
+    bool doTrailSave;
     friend class SQLStats;
     PropStats propStats;
 
@@ -282,10 +286,33 @@ protected:
     ClauseAllocator*    clAllocator;
     bool                ok;               ///< If FALSE, the constraints are already unsatisfiable. No part of the solver state may be used!
     vector<vec<Watched> > watches;        ///< 'watches[lit]' is a list of constraints watching 'lit'
+    vector<vector<Lit> > cards;           ///< At-most-one constraints, watched in 'watches[~lit]' of each of their literals
+    vector<Xor>         xors;             ///< XOR constraints, watched in 'watches' through both literals of two of their variables
+    bool                xorsAttached;     ///< The XOR constraints are only in the watchlists during the search
+    vector<vector<Lit> > gaussReasons;    ///< Reason of each var set by a Gauss-Jordan matrix, the var's literal first
+    vector<Lit>         gaussConflict;    ///< Row of a Gauss-Jordan matrix in conflict, as a false clause
     vector<lbool>       assigns;          ///< The current assignments
     vector<Lit>         trail;            ///< Assignment stack; stores all assigments made in the order they were made.
     vector<uint32_t>    trail_lim;        ///< Separator indices for different decision levels in 'trail'.
     uint32_t            qhead;            ///< Head of queue (as index into the trail)
+    bool                outOfOrderTrail;  ///< Chronological backtracking left literals on the trail above higher-level ones
+
+    ///A literal on the trail and why it was set
+    struct SavedImpl
+    {
+        SavedImpl(const Lit _lit, const PropBy _reason) :
+            lit(_lit)
+            , reason(_reason)
+        {}
+
+        Lit lit;
+        PropBy reason;
+    };
+    vector<SavedImpl>   savedTrail;       ///< Part of the trail undone by the last backjump
+    vector<uint32_t>    savedTrailAt;     ///< Index of the var in 'savedTrail', if it's there
+    void clearSavedTrail();
+    void reimplySaved(const Lit p);
+    bool savedReasonHolds(const SavedImpl& saved);
     Lit                 failBinLit;       ///< Used to store which watches[lit] we were looking through when conflict occured
     vector<VarData>     varData;          ///< Stores info about variable: polarity, whether it's eliminated, etc.
     Stamp stamp;
@@ -332,9 +359,10 @@ protected:
     );
 
     ///Add hyper-binary clause given this large clause
+    template<class T>
     void  addHyperBin(
         const Lit p
-        , const Clause& cl
+        , const T& cl
     );
 
     ///Find which literal should be set when we have failed
@@ -345,6 +373,7 @@ protected:
     // Propagating
     ////////////////
     void         newDecisionLevel();                       ///<Begins a new decision level.
+    uint32_t     implicationLevel(const PropBy from) const; ///<Level to set a literal propagated by "from" at
 
     ///Perform BCP
     PropBy  propagateBinFirst(
@@ -360,6 +389,26 @@ protected:
         , const Lit p
         , PropBy& confl
     ); ///<Propagate 2-long clause
+    bool propCard(
+        const vec<Watched>::const_iterator i
+        , const Lit p
+        , PropBy& confl
+    ); ///<Propagate at-most-one constraint
+
+    ///Propagate XOR constraint
+    template<bool simple>
+    PropResult propXor(
+        const vec<Watched>::iterator i
+        , vec<Watched>::iterator &j
+        , const Lit p
+        , PropBy& confl
+    );
+    void getXorReason(
+        const PropBy& reason
+        , const Lit p
+        , vector<Lit>& out
+    ) const; ///<Clause of the XOR or matrix row that implied 'p', or is in conflict if 'p' is lit_Undef
+    vector<Lit> xorReason;
 
     ///Propagate 3-long clause
     template<bool simple>
@@ -506,6 +555,82 @@ inline uint32_t PropEngine::decisionLevel() const
     return trail_lim.size();
 }
 
+inline void PropEngine::clearSavedTrail()
+{
+    savedTrail.clear();
+}
+
+/**
+@brief The level a literal implied by "from" belongs to
+
+Once chronological backtracking has left the trail out of order, an implied
+literal is set at the highest level among the literals of its reason, which
+can be lower than the current decision level. Levels 0 and 1 are always kept
+in order, since hyper-binary resolution and the implication cache at level 1
+rely on it.
+*/
+inline uint32_t PropEngine::implicationLevel(const PropBy from) const
+{
+    if (decisionLevel() <= 2)
+        return decisionLevel();
+
+    uint32_t level = 2;
+    switch (from.getType()) {
+        case binary_t:
+            level = std::max(level, varData[from.lit1().var()].level);
+            break;
+
+        case tertiary_t:
+            level = std::max(level, varData[from.lit1().var()].level);
+            level = std::max(level, varData[from.lit2().var()].level);
+            break;
+
+        case clause_t: {
+            //cl[0] is the literal being set
+            const Clause& cl = *clAllocator->getPointer(from.getClause());
+            for(const Lit *l = cl.begin() + 1, *end = cl.end()
+                ; l != end && level < decisionLevel()
+                ; l++
+            ) {
+                level = std::max(level, varData[l->var()].level);
+            }
+            break;
+        }
+
+        case xor_t: {
+            if (from.isGauss()) {
+                const vector<Lit>& reason = gaussReasons[from.getXor()];
+                for(vector<Lit>::const_iterator
+                    it = reason.begin() + 1, end = reason.end()
+                    ; it != end && level < decisionLevel()
+                    ; it++
+                ) {
+                    level = std::max(level, varData[it->var()].level);
+                }
+                break;
+            }
+
+            //vars[0] is the variable being set
+            const Xor& x = xors[from.getXor()];
+            for(vector<Var>::const_iterator
+                it = x.vars.begin() + 1, end = x.vars.end()
+                ; it != end && level < decisionLevel()
+                ; it++
+            ) {
+                level = std::max(level, varData[*it].level);
+            }
+            break;
+        }
+
+        case null_clause_t:
+            //Decision
+            level = decisionLevel();
+            break;
+    }
+
+    return level;
+}
+
 inline lbool PropEngine::value (const Var x) const
 {
     return assigns[x];
@@ -575,7 +700,7 @@ inline void PropEngine::enqueue(const Lit p, const PropBy from)
     varData[v].stats.decLevelHist.push(decisionLevel());
     #endif
     varData[v].reason = from;
-    varData[v].level = decisionLevel();
+    varData[v].level = outOfOrderTrail ? implicationLevel(from) : decisionLevel();
 
     trail.push_back(p);
     propStats.propagations++;
@@ -826,7 +951,8 @@ inline void PropEngine::addHyperBin(const Lit p, const Lit lit1, const Lit lit2)
     addHyperBin(p);
 }
 
-inline void PropEngine::addHyperBin(const Lit p, const Clause& cl)
+template<class T>
+inline void PropEngine::addHyperBin(const Lit p, const T& cl)
 {
     assert(value(p.var()) == l_Undef);
 
@@ -838,7 +964,7 @@ inline void PropEngine::addHyperBin(const Lit p, const Clause& cl)
 
     currAncestors.clear();
     size_t i = 0;
-    for (Clause::const_iterator
+    for (typename T::const_iterator
         it = cl.begin(), end = cl.end()
         ; it != end
         ; it++, i++
@@ -891,6 +1017,15 @@ inline Lit PropEngine::analyzeFail(const PropBy propBy)
             break;
         }
 
+        case xor_t: {
+            getXorReason(propBy, lit_Undef, xorReason);
+            for(size_t i = 0; i < xorReason.size(); i++) {
+                if (varData[xorReason[i].var()].level != 0)
+                    currAncestors.push_back(~xorReason[i]);
+            }
+            break;
+        }
+
         case null_clause_t:
             assert(false);
             break;
@@ -981,6 +1116,7 @@ inline void PropEngine::cancelZeroLight()
         Var var = trail[sublevel].var();
         assigns[var] = l_Undef;
     }
+    clearSavedTrail();
     qhead = trail_lim[0];
     trail.resize(trail_lim[0]);
     trail_lim.clear();
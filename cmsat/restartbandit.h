@@ -0,0 +1,129 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos and collaborators. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#ifndef __RESTARTBANDIT_H__
+#define __RESTARTBANDIT_H__
+
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cassert>
+#include "solvertypes.h"
+
+namespace CMSat {
+using std::vector;
+
+/**
+@brief UCB1 multi-armed bandit choosing the restart strategy for each window
+
+Every Searcher::solve() is a window: the strategy is chosen at its start with
+select(), and its outcome is given back at its end with reward(), which must be
+in [0,1]. Every arm is tried once, then the one with the highest upper
+confidence bound is chosen: avg + explore*sqrt(2*ln(pulls)/armPulls)
+*/
+class RestartBandit
+{
+    public:
+        RestartBandit() :
+            current(0)
+            , totalPulls(0)
+        {
+            addArm(Restart::glue);
+            addArm(Restart::geom);
+            addArm(Restart::glue_agility);
+            addArm(Restart::agility);
+        }
+
+        Restart select(const double explore)
+        {
+            current = 0;
+            double best = -1;
+            for(size_t i = 0; i < arms.size(); i++) {
+                if (arms[i].pulls == 0) {
+                    current = i;
+                    break;
+                }
+
+                const double bound = arms[i].avg()
+                    + explore*std::sqrt(2.0*std::log((double)totalPulls)/(double)arms[i].pulls);
+                if (bound > best) {
+                    best = bound;
+                    current = i;
+                }
+            }
+
+            return arms[current].type;
+        }
+
+        void reward(const double val)
+        {
+            assert(val >= 0 && val <= 1);
+            arms[current].pulls++;
+            arms[current].sumReward += val;
+            totalPulls++;
+        }
+
+        void print() const
+        {
+            for(size_t i = 0; i < arms.size(); i++) {
+                printStatsLine(string("c bandit ") + restart_type_to_string(arms[i].type)
+                    , arms[i].pulls
+                    , arms[i].avg()
+                    , "avg reward"
+                );
+            }
+        }
+
+    private:
+        struct Arm
+        {
+            Arm(const Restart _type) :
+                type(_type)
+                , pulls(0)
+                , sumReward(0)
+            {}
+
+            double avg() const
+            {
+                if (pulls == 0)
+                    return 0;
+
+                return sumReward/(double)pulls;
+            }
+
+            Restart type;
+            uint64_t pulls;
+            double sumReward;
+        };
+
+        void addArm(const Restart type)
+        {
+            arms.push_back(Arm(type));
+        }
+
+        vector<Arm> arms;
+        size_t current; ///<Arm chosen by the last select()
+        uint64_t totalPulls;
+};
+
+} //end namespace
+
+#endif //__RESTARTBANDIT_H__
@@ -93,7 +93,7 @@ void SCCFinder::tarjan(const uint32_t vertex)
     ) {
         Lit vertLit = Lit::toLit(vertex);
 
-        vector<LitExtra>* transCache = NULL;
+        LitExtraVec* transCache = NULL;
 
         if (solver->conf.doCache) {
             transCache = &(solver->implCache[(~vertLit).toInt()].lits);
@@ -125,7 +125,7 @@ void SCCFinder::tarjan(const uint32_t vertex)
         }
 
         if (transCache) {
-            for (vector<LitExtra>::iterator
+            for (LitExtraVec::iterator
                 it = transCache->begin(), end = transCache->end()
                 ; it != end
                 ; it++
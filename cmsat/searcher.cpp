@@ -22,6 +22,10 @@
 #include "searcher.h"
 #include "simplifier.h"
 #include "calcdefpolars.h"
+#include "sls.h"
+#include "bgsimplifier.h"
+#include "cardfinder.h"
+#include "gaussian.h"
 #include "time_mem.h"
 #include "solver.h"
 #include <iomanip>
@@ -59,13 +63,22 @@ Searcher::Searcher(const SolverConf& _conf, Solver* _solver) :
             , AgilityData(_conf.agilityG, _conf.agilityLimit)
             , _conf.updateGlues
             , _conf.doLHBR
+            , _conf.doTrailSave
         )
 
         //variables
         , solver(_solver)
         , conf(_conf)
         , needToInterrupt(false)
+        , gqhead(0)
         , var_inc(_conf.var_inc_start)
+        , banditWindowConfl(0)
+        , banditWindowGood(0)
+        , targetTrailSize(0)
+        , bestTrailSize(0)
+        , nextRephase(_conf.rephaseInterval)
+        , numRephases(0)
+        , followSavedPolarities(false)
         , order_heap(VarOrderLt(activities))
         , clauseActivityIncrease(1)
 {
@@ -82,6 +95,9 @@ Var Searcher::newVar(const bool dvar)
     const Var var = PropEngine::newVar(dvar);
     assert(var == activities.size());
     activities.push_back(0);
+    vmtfQueue.newVar(var);
+    targetPolarity.push_back(l_Undef);
+    bestPolarity.push_back(l_Undef);
     if (dvar) {
         insertVarOrder(var);
     }
@@ -100,7 +116,44 @@ void Searcher::cancelUntil(uint32_t level)
     cout << endl;
     #endif
 
-    if (decisionLevel() > level) {
+    if (decisionLevel() > level && outOfOrderTrail) {
+        //Literals implied at or below "level" may be above trail_lim[level].
+        //Keep them, in trail order, and propagate them again
+        size_t kept = trail_lim[level];
+        for (size_t sublevel = trail_lim[level]; sublevel < trail.size(); sublevel++) {
+            const Lit lit = trail[sublevel];
+            if (varData[lit.var()].level <= level) {
+                trail[kept++] = lit;
+                continue;
+            }
+
+            assert(value(lit.var()) != l_Undef);
+            assigns[lit.var()] = l_Undef;
+            insertVarOrder(lit.var());
+        }
+        qhead = trail_lim[level];
+        gqhead = std::min(gqhead, qhead);
+        trail.resize(kept);
+        trail_lim.resize(level);
+        clearSavedTrail();
+
+        //Levels 0 and 1 are never out of order
+        if (level <= 1)
+            outOfOrderTrail = false;
+    } else if (decisionLevel() > level) {
+
+        //Save what is undone, in case the search takes the same decisions
+        //again. Levels 0 and 1 are simplified (clauses are removed) so
+        //nothing is saved when going back there.
+        clearSavedTrail();
+        if (doTrailSave && level >= 2) {
+            for (size_t sublevel = trail_lim[level]; sublevel < trail.size(); sublevel++) {
+                const Lit lit = trail[sublevel];
+                savedTrailAt[lit.var()] = savedTrail.size();
+                savedTrail.push_back(SavedImpl(lit, varData[lit.var()].reason));
+            }
+            propStats.savedTrailLits += savedTrail.size();
+        }
 
         //Go through in reverse order, unassign & insert then
         //back to the vars to be branched upon
@@ -125,6 +178,7 @@ void Searcher::cancelUntil(uint32_t level)
             insertVarOrder(var);
         }
         qhead = trail_lim[level];
+        gqhead = std::min(gqhead, qhead);
         trail.resize(trail_lim[level]);
         trail_lim.resize(level);
     }
@@ -137,6 +191,63 @@ void Searcher::cancelUntil(uint32_t level)
     #endif
 }
 
+/**
+@brief Highest level among the literals of the conflict
+
+Only differs from the decision level if the trail is out of order
+*/
+uint32_t Searcher::conflictLevel(const PropBy confl) const
+{
+    uint32_t level = 0;
+    switch (confl.getType()) {
+        case tertiary_t:
+            level = std::max(level, varData[confl.lit2().var()].level);
+            //fallthrough - tertiary is like binary, just one more lit
+
+        case binary_t:
+            level = std::max(level, varData[confl.lit1().var()].level);
+            level = std::max(level, varData[failBinLit.var()].level);
+            break;
+
+        case clause_t: {
+            const Clause& cl = *clAllocator->getPointer(confl.getClause());
+            for(const Lit *l = cl.begin(), *end = cl.end(); l != end; l++) {
+                level = std::max(level, varData[l->var()].level);
+            }
+            break;
+        }
+
+        case xor_t: {
+            if (confl.isGauss()) {
+                for(vector<Lit>::const_iterator
+                    it = gaussConflict.begin(), end = gaussConflict.end()
+                    ; it != end
+                    ; it++
+                ) {
+                    level = std::max(level, varData[it->var()].level);
+                }
+                break;
+            }
+
+            const Xor& x = xors[confl.getXor()];
+            for(vector<Var>::const_iterator
+                it = x.vars.begin(), end = x.vars.end()
+                ; it != end
+                ; it++
+            ) {
+                level = std::max(level, varData[*it].level);
+            }
+            break;
+        }
+
+        case null_clause_t:
+            assert(false && "Conflict without a clause");
+            break;
+    }
+
+    return level;
+}
+
 void Searcher::analyzeHelper(
     const Lit lit
     , int& pathC
@@ -267,9 +378,9 @@ void Searcher::doOTFSubsume(PropBy confl)
         if (drup) {
             for(unsigned  i = 0; i < newCl.size; i++) {
                 *(drup)
-                << newCl.lits[i] << " ";
+                << newCl.lits[i];
             }
-            (*drup) << " 0\n";
+            (*drup) << DrupFlag::fin;
         }
         #endif //DRUP
 
@@ -307,8 +418,8 @@ void Searcher::doOTFSubsume(PropBy confl)
         }
         if (drup) {
             (*drup)
-            << cl << " 0\n"
-            << "d " << origCl << " 0\n"
+            << cl << DrupFlag::fin
+            << DrupFlag::del << origCl << DrupFlag::fin
             ;
         }
         #endif
@@ -322,7 +433,7 @@ void Searcher::normalClMinim()
     size_t i,j;
     for (i = j = 1; i < learnt_clause.size(); i++) {
         const PropBy& reason = varData[learnt_clause[i].var()].reason;
-        size_t size;
+        size_t size = 0;
         Clause* cl = NULL;
         PropByType type = reason.getType();
         if (type == null_clause_t) {
@@ -344,6 +455,11 @@ void Searcher::normalClMinim()
                 size = 2;
                 break;
 
+            case xor_t:
+                getXorReason(reason, ~learnt_clause[i], xorReason);
+                size = xorReason.size()-1;
+                break;
+
             case null_clause_t:
                 release_assert(false);
                 exit(-1);
@@ -357,6 +473,10 @@ void Searcher::normalClMinim()
                     p = (*cl)[k+1];
                     break;
 
+                case xor_t:
+                    p = xorReason[k+1];
+                    break;
+
                 case binary_t:
                     p = reason.lit1();
                     break;
@@ -496,6 +616,21 @@ Clause* Searcher::analyze(
                 break;
             }
 
+            case xor_t : {
+                resolutions.irredL++;
+                stats.resolvs.irredL++;
+
+                //'p' is put first, it will be resolved out anyway
+                getXorReason(confl, p, xorReason);
+                #ifdef DEBUG_RESOLV
+                cout << "resolv (xor): " << xorReason << endl;
+                #endif
+                for (size_t j = (p == lit_Undef ? 0 : 1); j < xorReason.size(); j++) {
+                    analyzeHelper(xorReason[j], pathC, fromProber);
+                }
+                break;
+            }
+
             case null_clause_t:
             default:
                 //otherwise should be UIP
@@ -503,10 +638,11 @@ Clause* Searcher::analyze(
                 break;
         }
 
-        // Select next implication to look at
-        while (!seen[trail[index--].var()]);
-
-        p = trail[index+1];
+        // Select next implication to look at. Seen lits of lower levels
+        // can be above it if the trail is out of order
+        do {
+            p = trail[index--];
+        } while (!seen[p.var()] || varData[p.var()].level != decisionLevel());
 
         if (!fromProber
             && conf.doOTFSubsume
@@ -614,6 +750,8 @@ Clause* Searcher::analyze(
         }
     }
     lastDecisionLevel.clear();
+    if (!vmtfToBump.empty())
+        bumpVmtfQueue();
 
     //We can only on-the-fly subsume with clauses that are not 2- or 3-long
     //furthermore, we cannot subsume a clause that is marked for deletion
@@ -657,14 +795,15 @@ bool Searcher::litRedundant(const Lit p, uint32_t abstract_levels)
         cout << "At point in litRedundant: " << analyze_stack.top() << endl;
         #endif
 
-        const PropBy reason = varData[analyze_stack.top().var()].reason;
+        const Lit stackTop = analyze_stack.top();
+        const PropBy reason = varData[stackTop.var()].reason;
         PropByType type = reason.getType();
         analyze_stack.pop();
 
         //Must have a reason
         assert(!reason.isNULL());
 
-        size_t size;
+        size_t size = 0;
         Clause* cl = NULL;
         switch (type) {
             case clause_t:
@@ -680,6 +819,11 @@ bool Searcher::litRedundant(const Lit p, uint32_t abstract_levels)
                 size = 2;
                 break;
 
+            case xor_t:
+                getXorReason(reason, ~stackTop, xorReason);
+                size = xorReason.size()-1;
+                break;
+
             case null_clause_t:
                 release_assert(false);
                 exit(-1);
@@ -696,6 +840,10 @@ bool Searcher::litRedundant(const Lit p, uint32_t abstract_levels)
                     p = (*cl)[i+1];
                     break;
 
+                case xor_t:
+                    p = xorReason[i+1];
+                    break;
+
                 case binary_t:
                     p = reason.lit1();
                     break;
@@ -810,6 +958,24 @@ void Searcher::analyzeFinal(const Lit p, vector<Lit>& out_conflict)
                     break;
                 }
 
+                case xor_t : {
+                    if (confl.isGauss()) {
+                        const vector<Lit>& reason = gaussReasons[x];
+                        for (uint32_t j = 1, size = reason.size(); j < size; j++) {
+                            if (varData[reason[j].var()].level > 0)
+                                seen[reason[j].var()] = 1;
+                        }
+                        break;
+                    }
+
+                    const Xor& xr = xors[confl.getXor()];
+                    for (uint32_t j = 0, size = xr.vars.size(); j < size; j++) {
+                        if (xr.vars[j] != x && varData[xr.vars[j]].level > 0)
+                            seen[xr.vars[j]] = 1;
+                    }
+                    break;
+                }
+
                 case null_clause_t :
                     assert(false && "Incorrect analyzeFinal");
                     break;
@@ -869,7 +1035,7 @@ lbool Searcher::search(uint64_t* geom_max)
                 if (drup) {
                     (*drup)
                     << (~failed)
-                    << " 0\n";
+                    << DrupFlag::fin;
                 }
                 #endif
 
@@ -931,7 +1097,7 @@ lbool Searcher::search(uint64_t* geom_max)
                         #ifdef DRUP
                         if (drup) {
                             (*drup)
-                            << (~ancestor) << " 0\n";
+                            << (~ancestor) << DrupFlag::fin;
                         }
                         #endif
                     }
@@ -994,6 +1160,9 @@ lbool Searcher::search(uint64_t* geom_max)
             if (params.needToStopSearch
                 || sumConflicts() > solver->getNextCleanLimit()
             ) {
+                //Whole trail is conflict-free. Target is per-restart
+                updateTargetBest(trail.size());
+                targetTrailSize = 0;
                 cancelUntil(0);
                 return l_Undef;
             }
@@ -1177,6 +1346,28 @@ bool Searcher::handle_conflict(PropBy confl)
         return false;
     }
 
+    //Conflict may be entirely below the current level -- analyse it there
+    if (outOfOrderTrail) {
+        const uint32_t conflLevel = conflictLevel(confl);
+        if (conflLevel < decisionLevel()) {
+            cancelUntil(conflLevel);
+        }
+
+        if (decisionLevel() == 0) {
+            #ifdef DRUP
+            if (drup) {
+                (*drup) << DrupFlag::fin;
+            }
+            #endif
+            return false;
+        }
+    }
+
+    followSavedPolarities = false;
+
+    //Everything below the conflicting level is conflict-free
+    updateTargetBest(trail_lim[decisionLevel()-1]);
+
     Clause* cl = analyze(
         confl
         , backtrack_level  //return backtrack level here
@@ -1194,7 +1385,7 @@ bool Searcher::handle_conflict(PropBy confl)
     }
     if (drup) {
         (*drup)
-        << learnt_clause << " 0\n";
+        << learnt_clause << DrupFlag::fin;
     }
     #endif
 
@@ -1212,6 +1403,9 @@ bool Searcher::handle_conflict(PropBy confl)
 
         hist.glueHist.push(glue);
         hist.glueHistLT.push(glue);
+        banditWindowConfl++;
+        if (glue <= conf.tierMidGlue)
+            banditWindowGood++;
 
         hist.conflSizeHist.push(learnt_clause.size());
         hist.conflSizeHistLT.push(learnt_clause.size());
@@ -1246,7 +1440,19 @@ bool Searcher::handle_conflict(PropBy confl)
         }
         #endif
     }
-    cancelUntil(backtrack_level);
+
+    //Chronological backtracking: don't throw away a large part of the trail
+    //only to re-propagate it. Levels 0 and 1 must stay in order.
+    if (conf.doChronoBT
+        && backtrack_level >= 2
+        && decisionLevel() - backtrack_level > conf.chronoBTThreshold
+    ) {
+        stats.chronoBacktracks++;
+        cancelUntil(decisionLevel() - 1);
+        outOfOrderTrail = true;
+    } else {
+        cancelUntil(backtrack_level);
+    }
     if (params.update) {
         hist.trailDepthDeltaHist.push(orig_trail_size - trail.size());
     }
@@ -1290,7 +1496,7 @@ bool Searcher::handle_conflict(PropBy confl)
                 if (drup && decisionLevel() == 0) {
                     *(drup)
                     << cl[0]
-                    << " 0\n";
+                    << DrupFlag::fin;
                 }
                 #endif
             }
@@ -1364,7 +1570,7 @@ bool Searcher::handle_conflict(PropBy confl)
                 #ifdef DRUP
                 if (drup && decisionLevel() == 0) {
                     *(drup)
-                    << it->lits[0] << " 0\n";
+                    << it->lits[0] << DrupFlag::fin;
                 }
                 #endif
             }
@@ -1589,6 +1795,12 @@ lbool Searcher::burstSearch()
     uint32_t backup_var_inc_divider = var_inc_divider;
     uint32_t backup_var_inc_multiplier = var_inc_multiplier;
 
+    //Random picks are taken from the heap, it must be up-to-date
+    if (params.branch_type != Branch::vsids) {
+        params.branch_type = Branch::vsids;
+        redoOrderHeap();
+    }
+
     //Set burst config
     conf.random_var_freq = 1;
     conf.polarity_mode = PolarityMode::rnd;
@@ -1902,10 +2114,21 @@ void Searcher::printClauseDistribSQL()
 }
 #endif
 
-Restart Searcher::decide_restart_type() const
+Restart Searcher::decide_restart_type()
 {
     Restart rest_type = conf.restartType;
-    if (rest_type == Restart::automatic) {
+    if (rest_type == Restart::bandit) {
+        rest_type = restartBandit.select(conf.restartBanditExplore);
+        banditWindowConfl = 0;
+        banditWindowGood = 0;
+
+        if (conf.verbosity >= 2) {
+            cout
+            << "c Bandit chose restart type "
+            << restart_type_to_string(rest_type)
+            << endl;
+        }
+    } else if (rest_type == Restart::automatic) {
         if (solver->sumPropStats.propagations == 0) {
 
             //If no data yet, default to Restart::glue
@@ -1942,6 +2165,56 @@ Restart Searcher::decide_restart_type() const
     return rest_type;
 }
 
+/**
+@brief Rewards the restart strategy of the window that just finished
+
+The reward is the ratio of learnt clauses whose glue is low enough for them to
+be kept in the mid tier by the clause cleaning
+*/
+void Searcher::rewardRestartBandit()
+{
+    if (banditWindowConfl == 0)
+        return;
+
+    const double reward = (double)banditWindowGood/(double)banditWindowConfl;
+    restartBandit.reward(reward);
+
+    if (conf.verbosity >= 2) {
+        cout
+        << "c Bandit reward for restart type "
+        << restart_type_to_string(params.rest_type)
+        << ": " << std::setprecision(3) << reward
+        << endl;
+    }
+}
+
+/**
+@brief VMTF goes with the fast, glue- or agility-based restarts, VSIDS with the
+rest, if the branching heuristic is automatic
+*/
+Branch Searcher::decide_branch_type() const
+{
+    Branch branch_type = conf.branchType;
+    if (branch_type == Branch::automatic) {
+        if (params.rest_type == Restart::geom
+            || params.rest_type == Restart::never
+        ) {
+            branch_type = Branch::vsids;
+        } else {
+            branch_type = Branch::vmtf;
+        }
+
+        if (conf.verbosity >= 2) {
+            cout
+            << "c Chose branching heuristic "
+            << branch_type_to_string(branch_type)
+            << endl;
+        }
+    }
+
+    return branch_type;
+}
+
 void Searcher::check_if_print_restart_stat(const lbool status)
 {
     //Print restart stat
@@ -2011,6 +2284,11 @@ lbool Searcher::solve(const vector<Lit>& assumps, const uint64_t maxConfls)
 
         //Set up data for search
         params.rest_type = decide_restart_type();
+        params.branch_type = decide_branch_type();
+        if (params.branch_type == Branch::vmtf) {
+            //Queue was not maintained while the heap was in use
+            vmtfQueue.resetSearch();
+        }
         genRandomVarActMultDiv();
 
         //Set up restart printing status
@@ -2048,6 +2326,13 @@ lbool Searcher::solve(const vector<Lit>& assumps, const uint64_t maxConfls)
         geom_max *= conf.restart_inc;
         check_if_print_restart_stat(status);
 
+        if (status == l_Undef
+            && conf.doRephase
+            && sumConflicts() >= nextRephase
+        ) {
+            rephase();
+        }
+
         if (status != l_Undef) {
             if (conf.verbosity >= 6) {
                 cout
@@ -2071,6 +2356,14 @@ lbool Searcher::solve(const vector<Lit>& assumps, const uint64_t maxConfls)
             break;
         }
 
+        //Merge the results of the background job, start the next one
+        if (conf.doBgSimp
+            && !solver->bgSimplifier->mergeAndStart()
+        ) {
+            status = l_False;
+            break;
+        }
+
         //Check if we should do DBcleaning
         if (sumConflicts() > solver->getNextCleanLimit()) {
             if (conf.verbosity >= 3) {
@@ -2088,6 +2381,7 @@ lbool Searcher::solve(const vector<Lit>& assumps, const uint64_t maxConfls)
                 << " maxConfls:" << maxConfls
                 << " Trail size: " << trail.size() << endl;
             }
+            solver->shedMemoryIfNeeded();
             solver->fullReduce();
 
             genRandomVarActMultDiv();
@@ -2134,8 +2428,13 @@ lbool Searcher::solve(const vector<Lit>& assumps, const uint64_t maxConfls)
 
             //If enough new variables have been found to be replaced, replace them
             if (solver->varReplacer->getNewToReplaceVars() > ((double)solver->getNumFreeVars()*0.001)) {
-                //Perform equivalent variable replacement
-                if (!solver->varReplacer->performReplace()) {
+                //Perform equivalent variable replacement. It needs all the
+                //binary clauses in the watchlists, and updates the XORs
+                solver->cardFinder->detach();
+                solver->detachXors();
+                if (!solver->varReplacer->performReplace()
+                    || !solver->attachXors()
+                ) {
                     status = l_False;
                     break;
                 }
@@ -2155,6 +2454,13 @@ lbool Searcher::solve(const vector<Lit>& assumps, const uint64_t maxConfls)
         #endif
     }
 
+    //Window is over, unless solved (or burst search did not finish)
+    if (conf.restartType == Restart::bandit
+        && status == l_Undef
+    ) {
+        rewardRestartBandit();
+    }
+
     #ifdef VERBOSE_DEBUG
     if (status == l_True)
         cout << "Solution  is SAT" << endl;
@@ -2218,6 +2524,9 @@ inline int64_t abs64(int64_t a)
 
 bool Searcher::pickPolarity(const Var var)
 {
+    if (followSavedPolarities)
+        return getStoredPolarity(var);
+
     switch(conf.polarity_mode) {
         case PolarityMode::neg:
             return false;
@@ -2229,6 +2538,11 @@ bool Searcher::pickPolarity(const Var var)
             return mtrand.randInt(1);
 
         case PolarityMode::automatic:
+            if (useTargetPhase()
+                && targetPolarity[var] != l_Undef
+            ) {
+                return targetPolarity[var] == l_True;
+            }
             return getStoredPolarity(var);
         default:
             assert(false);
@@ -2237,6 +2551,114 @@ bool Searcher::pickPolarity(const Var var)
     return true;
 }
 
+bool Searcher::useTargetPhase() const
+{
+    return conf.doTargetPhase == 2
+        || (conf.doTargetPhase == 1 && params.rest_type == Restart::geom);
+}
+
+/**
+@brief Saves the polarities of trail[0..conflictFree) if it's the longest so far
+
+The target polarities are for the longest conflict-free trail since the last
+restart, the best polarities since the last rephase. Only the vars on the trail
+are overwritten, the others keep the polarities from an earlier trail.
+*/
+void Searcher::updateTargetBest(const size_t conflictFree)
+{
+    if (conflictFree > targetTrailSize) {
+        for(size_t i = 0; i < conflictFree; i++) {
+            const Lit lit = trail[i];
+            targetPolarity[lit.var()] = boolToLBool(!lit.sign());
+        }
+        targetTrailSize = conflictFree;
+    }
+
+    if (conflictFree > bestTrailSize) {
+        for(size_t i = 0; i < conflictFree; i++) {
+            const Lit lit = trail[i];
+            bestPolarity[lit.var()] = boolToLBool(!lit.sign());
+        }
+        bestTrailSize = conflictFree;
+    }
+}
+
+/**
+@brief Resets the saved polarities according to a fixed schedule
+
+Best polarities are used every second (or third, with local search) time, and
+in between, the original (Jeroslow-Wang) polarities, their inverse, random ones
+or the best assignment of local search. Target and best polarities are
+restarted, since they belong to the old phases.
+*/
+void Searcher::rephase()
+{
+    assert(decisionLevel() == 0);
+    static const Rephase schedule[] = {
+        Rephase::best, Rephase::original
+        , Rephase::best, Rephase::inverted
+        , Rephase::best, Rephase::random
+    };
+    static const Rephase scheduleSLS[] = {
+        Rephase::walk, Rephase::best, Rephase::original
+        , Rephase::walk, Rephase::best, Rephase::inverted
+        , Rephase::walk, Rephase::best, Rephase::random
+    };
+    const Rephase type = conf.doSLS
+        ? scheduleSLS[numRephases % (sizeof(scheduleSLS)/sizeof(scheduleSLS[0]))]
+        : schedule[numRephases % (sizeof(schedule)/sizeof(schedule[0]))];
+
+    switch(type) {
+        case Rephase::best:
+            for(size_t var = 0; var < nVars(); var++) {
+                if (bestPolarity[var] != l_Undef)
+                    varData[var].polarity = (bestPolarity[var] == l_True);
+            }
+            break;
+
+        case Rephase::original:
+        case Rephase::inverted: {
+            //Votes are 1 where the negative literal is preferred
+            CalcDefPolars calculator(solver);
+            const vector<char> votes = calculator.calculate();
+            const bool invert = (type == Rephase::inverted);
+            for(size_t var = 0; var < votes.size(); var++) {
+                varData[var].polarity = !votes[var] ^ invert;
+            }
+            break;
+        }
+
+        case Rephase::random:
+            for(size_t var = 0; var < nVars(); var++) {
+                varData[var].polarity = mtrand.randInt(1);
+            }
+            break;
+
+        case Rephase::walk:
+            if (solver->sls->run()) {
+                //Saved polarities satisfy all irredundant clauses
+                followSavedPolarities = true;
+            }
+            break;
+    }
+
+    std::fill(targetPolarity.begin(), targetPolarity.end(), l_Undef);
+    std::fill(bestPolarity.begin(), bestPolarity.end(), l_Undef);
+    targetTrailSize = 0;
+    bestTrailSize = 0;
+
+    stats.rephases++;
+    numRephases++;
+    nextRephase = sumConflicts() + conf.rephaseInterval*(numRephases+1);
+
+    if (conf.verbosity >= 2) {
+        cout
+        << "c Rephased to " << rephase_type_to_string(type)
+        << " polarities, next rephase at " << nextRephase << " conflicts"
+        << endl;
+    }
+}
+
 /**
 @brief Picks a branching variable and its value (True/False)
 
@@ -2258,11 +2680,15 @@ Lit Searcher::pickBranchLit()
     Lit next = lit_Undef;
 
     // Random decision:
+    const bool vmtf = (params.branch_type == Branch::vmtf);
     double rand = mtrand.randDblExc();
     if (rand < conf.random_var_freq
-        && !order_heap.empty()
+        && !followSavedPolarities
+        && (vmtf ? nVars() > 0 : !order_heap.empty())
     ) {
-        const Var next_var = order_heap[mtrand.randInt(order_heap.size()-1)];
+        const Var next_var = vmtf
+            ? mtrand.randInt(nVars()-1)
+            : order_heap[mtrand.randInt(order_heap.size()-1)];
         if (value(next_var) == l_Undef
             && solver->decisionVar[next_var]
         ) {
@@ -2276,13 +2702,25 @@ Lit Searcher::pickBranchLit()
       || value(next.var()) != l_Undef
       || !solver->decisionVar[next.var()]
     ) {
-        //There is no more to branch on. Satisfying assignment found.
-        if (order_heap.empty()) {
-            next = lit_Undef;
-            break;
+        Var next_var;
+        if (vmtf) {
+            //Queue only skips vars, they stay in it
+            next_var = vmtfQueue.next(VarFilter(this, solver));
+            if (next_var == var_Undef) {
+                next = lit_Undef;
+                break;
+            }
+            stats.decisionsVmtf++;
+        } else {
+            //There is no more to branch on. Satisfying assignment found.
+            if (order_heap.empty()) {
+                next = lit_Undef;
+                break;
+            }
+
+            next_var = order_heap.removeMin();
         }
 
-        const Var next_var = order_heap.removeMin();
         bool oldPolar = getStoredPolarity(next_var);
         bool newPolar = pickPolarity(next_var);
         next = Lit(next_var, !newPolar);
@@ -2292,12 +2730,15 @@ Lit Searcher::pickBranchLit()
     }
 
     //Flip polaritiy if need be
-    if (next != lit_Undef) {
+    if (next != lit_Undef
+        && !followSavedPolarities
+    ) {
         next ^= (mtrand.randInt(conf.flipPolarFreq*hist.branchDepthDeltaHistLT.avg()) == 1);
     }
 
     //Try to update to dominator
     if (next != lit_Undef
+        && !followSavedPolarities
         && (mtrand.randInt(conf.dominPickFreq) == 1)
     ) {
         Lit lit2 = lit_Undef;
@@ -2373,7 +2814,7 @@ void Searcher::minimiseLearntFurther(vector<Lit>& cl)
         if (conf.doCache) {
             const TransCache& cache1 = solver->implCache[l->toInt()];
             timeSpent += cache1.lits.size()/2;
-            for (vector<LitExtra>::const_iterator
+            for (LitExtraVec::const_iterator
                 it = cache1.lits.begin(), end2 = cache1.lits.end()
                 ; it != end2
                 ; it++
@@ -2484,6 +2925,11 @@ void Searcher::stampBasedLearntMinim(vector<Lit>& cl)
 
 void Searcher::insertVarOrder(const Var x)
 {
+    if (params.branch_type == Branch::vmtf) {
+        vmtfQueue.unassigned(x);
+        return;
+    }
+
     if (!order_heap.inHeap(x)
         && solver->decisionVar[x]
     ) {
@@ -2491,6 +2937,12 @@ void Searcher::insertVarOrder(const Var x)
     }
 }
 
+void Searcher::bumpVmtfQueue()
+{
+    vmtfQueue.bumpAll(vmtfToBump, assigns);
+    vmtfToBump.clear();
+}
+
 bool Searcher::VarFilter::operator()(uint32_t var) const
 {
     return (cc->value(var) == l_Undef && solver->decisionVar[var]);
@@ -2592,15 +3044,17 @@ std::pair<size_t, size_t> Searcher::removeUselessBins()
             } else {
                 solver->binTri.irredLits -= 2;
                 solver->binTri.irredBins--;
+                solver->touchIrred(it->getLit1());
+                solver->touchIrred(it->getLit2());
                 removedIrred++;
             }
 
             #ifdef DRUP
             if (drup) {
                 (*drup)
-                << "d "
-                << it->getLit1() << " " << it->getLit2()
-                << " 0\n";
+                << DrupFlag::del
+                << it->getLit1() << it->getLit2()
+                << DrupFlag::fin;
             }
             #endif
 
@@ -2894,19 +3348,25 @@ PropBy Searcher::propagate(
     #endif
 
     PropBy ret;
-    if (solver2 != NULL
-        && conf.propBinFirst
-    ) {
-        ret = propagateBinFirst(
-            solver2
-            #ifdef STATS_NEEDED
-            , watchListSizeTraversed
-            //, AvgCalc<bool>* litPropagatedSomething
-            #endif
-        );
-    } else {
-        ret = propagateAnyOrder();
-    }
+    do {
+        if (solver2 != NULL
+            && conf.propBinFirst
+        ) {
+            ret = propagateBinFirst(
+                solver2
+                #ifdef STATS_NEEDED
+                , watchListSizeTraversed
+                //, AvgCalc<bool>* litPropagatedSomething
+                #endif
+            );
+        } else {
+            ret = propagateAnyOrder();
+        }
+
+        //The matrices may set more, which the clauses must see
+        if (ret.isNULL() && !gaussMatrices.empty())
+            ret = propagateGauss();
+    } while (ret.isNULL() && qhead < trail.size());
 
     #ifdef DRUP
     //If declevel 0 propagation, we have to add the unitaries
@@ -2923,11 +3383,11 @@ PropBy Searcher::propagate(
 
             (*drup)
             << trail[i]
-            << " 0\n";
+            << DrupFlag::fin;
         }
         if (!ret.isNULL()) {
             (*drup)
-            << "0\n";
+            << DrupFlag::fin;
         }
     }
     #endif
@@ -2935,6 +3395,33 @@ PropBy Searcher::propagate(
     return ret;
 }
 
+/**
+@brief Tells the Gauss-Jordan matrices about the assignments on the trail
+
+They are only told after the clauses have propagated everything, as they
+are slower to update
+*/
+PropBy Searcher::propagateGauss()
+{
+    PropBy confl;
+    for (; gqhead < trail.size(); gqhead++) {
+        const Var var = trail[gqhead].var();
+        for(vector<Gaussian*>::iterator
+            it = gaussMatrices.begin(), end = gaussMatrices.end()
+            ; it != end
+            ; it++
+        ) {
+            if (!(*it)->propagate(var, confl)) {
+                lastConflictCausedBy = ConflCausedBy::longirred;
+                qhead = trail.size();
+                return confl;
+            }
+        }
+    }
+
+    return confl;
+}
+
 uint64_t Searcher::memUsedSearch() const
 {
     uint64_t mem = 0;
@@ -2943,8 +3430,14 @@ uint64_t Searcher::memUsedSearch() const
     mem += toClear.capacity()*sizeof(Lit);
     mem += trail.capacity()*sizeof(Lit);
     mem += trail_lim.capacity()*sizeof(uint32_t);
+    mem += savedTrail.capacity()*sizeof(SavedImpl);
+    mem += savedTrailAt.capacity()*sizeof(uint32_t);
     mem += activities.capacity()*sizeof(uint32_t);
     mem += order_heap.memUsed();
+    mem += vmtfQueue.memUsed();
+    mem += vmtfToBump.capacity()*sizeof(Var);
+    mem += targetPolarity.capacity()*sizeof(lbool);
+    mem += bestPolarity.capacity()*sizeof(lbool);
     mem += learnt_clause.capacity()*sizeof(Lit);
     mem += hist.memUsed();
     mem += conflict.capacity()*sizeof(Lit);
@@ -27,9 +27,12 @@
 #include <boost/multi_array.hpp>
 #include "time_mem.h"
 #include "avgcalc.h"
+#include "vmtfqueue.h"
+#include "restartbandit.h"
 namespace CMSat {
 
 class Solver;
+class Gaussian;
 class SQLStats;
 class VarReplacer;
 
@@ -236,6 +239,8 @@ class Searcher : public PropEngine
                 , decisionsAssump(0)
                 , decisionsRand(0)
                 , decisionFlippedPolar(0)
+                , decisionsVmtf(0)
+                , rephases(0)
 
                 //Conflict generation
                 , litsLearntNonMin(0)
@@ -264,6 +269,9 @@ class Searcher : public PropEngine
                 , otfSubsumedLearnt(0)
                 , otfSubsumedLitsGained(0)
 
+                //Backtracking
+                , chronoBacktracks(0)
+
                 //Hyper-bin & transitive reduction
                 , advancedPropCalled(0)
                 , hyperBinAdded(0)
@@ -290,6 +298,8 @@ class Searcher : public PropEngine
                 decisionsAssump += other.decisionsAssump;
                 decisionsRand += other.decisionsRand;
                 decisionFlippedPolar += other.decisionFlippedPolar;
+                decisionsVmtf += other.decisionsVmtf;
+                rephases += other.rephases;
 
                 //Conflict minimisation stats
                 litsLearntNonMin += other.litsLearntNonMin;
@@ -321,6 +331,9 @@ class Searcher : public PropEngine
                 otfSubsumedLearnt += other.otfSubsumedLearnt;
                 otfSubsumedLitsGained += other.otfSubsumedLitsGained;
 
+                //Backtracking
+                chronoBacktracks += other.chronoBacktracks;
+
                 //Hyper-bin & transitive reduction
                 advancedPropCalled += other.advancedPropCalled;
                 hyperBinAdded += other.hyperBinAdded;
@@ -346,6 +359,8 @@ class Searcher : public PropEngine
                 decisionsAssump -= other.decisionsAssump;
                 decisionsRand -= other.decisionsRand;
                 decisionFlippedPolar -= other.decisionFlippedPolar;
+                decisionsVmtf -= other.decisionsVmtf;
+                rephases -= other.rephases;
 
                 //Conflict minimisation stats
                 litsLearntNonMin -= other.litsLearntNonMin;
@@ -376,6 +391,9 @@ class Searcher : public PropEngine
                 otfSubsumedLearnt -= other.otfSubsumedLearnt;
                 otfSubsumedLitsGained -= other.otfSubsumedLitsGained;
 
+                //Backtracking
+                chronoBacktracks -= other.chronoBacktracks;
+
                 //Hyper-bin & transitive reduction
                 advancedPropCalled -= other.advancedPropCalled;
                 hyperBinAdded -= other.hyperBinAdded;
@@ -412,6 +430,11 @@ class Searcher : public PropEngine
                     , (double)decisionsRand*100.0/(double)decisions
                     , "% random"
                 );
+                printStatsLine("c rephases", rephases);
+                printStatsLine("c decisions from VMTF", decisionsVmtf
+                    , (double)decisionsVmtf*100.0/(double)decisions
+                    , "% of decisions"
+                );
 
                 printStatsLine("c decisions/conflicts"
                     , (double)decisions/(double)conflStats.numConflicts
@@ -496,6 +519,12 @@ class Searcher : public PropEngine
                     , "lits/otf subsume"
                 );
 
+                printStatsLine("c chrono backtracks"
+                    , chronoBacktracks
+                    , (double)chronoBacktracks/(double)conflStats.numConflicts*100.0
+                    , "% of conflicts"
+                );
+
                 cout << "c SEAMLESS HYPERBIN&TRANS-RED stats" << endl;
                 printStatsLine("c advProp called"
                     , advancedPropCalled
@@ -585,6 +614,8 @@ class Searcher : public PropEngine
             uint64_t  decisionsAssump;
             uint64_t  decisionsRand;    ///<Numer of random decisions made
             uint64_t  decisionFlippedPolar; ///<While deciding, we flipped polarity
+            uint64_t  decisionsVmtf;    ///<Decisions taken from the VMTF queue
+            uint64_t  rephases;         ///<Times the saved polarities were reset
 
             uint64_t litsLearntNonMin;
             uint64_t litsLearntFinal;
@@ -612,6 +643,9 @@ class Searcher : public PropEngine
             uint64_t otfSubsumedLearnt;
             uint64_t otfSubsumedLitsGained;
 
+            //Backtracking
+            uint64_t chronoBacktracks;
+
             //Hyper-bin & transitive reduction
             uint64_t advancedPropCalled;
             uint64_t hyperBinAdded;
@@ -669,7 +703,7 @@ class Searcher : public PropEngine
         bool  handle_conflict(PropBy confl);// Handles the conflict clause
         lbool new_decision();  // Handles the case when decision must be made
         void  checkNeedRestart(uint64_t* geom_max);     // Helper function to decide if we need to restart during search
-        Restart decide_restart_type() const;
+        Restart decide_restart_type();
         Lit   pickBranchLit();                             // Return the next decision variable.
 
         ///////////////
@@ -678,6 +712,7 @@ class Searcher : public PropEngine
         {
             SearchParams() :
                 rest_type(Restart::never)
+                , branch_type(Branch::vsids)
             {
                 clear();
             }
@@ -696,9 +731,16 @@ class Searcher : public PropEngine
             uint64_t conflictsToDo;
             uint64_t numAgilityNeedRestart;
             Restart rest_type;
+            Branch branch_type; ///<Kept between restarts, only changed by solve()
         };
         SearchParams params;
         void     cancelUntil      (uint32_t level);                        ///<Backtrack until a certain level.
+
+        //Gauss-Jordan matrices of the XORs, built by MatrixFinder
+        vector<Gaussian*> gaussMatrices;
+        uint32_t gqhead; ///<The matrices have been told about the trail up to here
+        PropBy propagateGauss();
+        uint32_t conflictLevel(const PropBy confl) const;
         vector<Lit> learnt_clause;
         Clause* analyze(
             PropBy confl //The conflict that we are investigating
@@ -751,7 +793,31 @@ class Searcher : public PropEngine
         // Variable activity
         vector<uint32_t> activities;
         uint32_t var_inc;
-        void              insertVarOrder(const Var x);  ///< Insert a variable in heap
+        void              insertVarOrder(const Var x);  ///< Insert a variable in heap (or VMTF queue)
+        VMTFQueue vmtfQueue; ///<Decision order when branching with VMTF
+        vector<Var> vmtfToBump; ///<Vars bumped during analysis, bumped in the queue at the end
+        void bumpVmtfQueue();
+        Branch decide_branch_type() const;
+
+        /////////////////
+        // Restart strategy selection
+        RestartBandit restartBandit;
+        uint64_t banditWindowConfl; ///<Conflicts in the current window
+        uint64_t banditWindowGood; ///<Of which learnt clauses with a low glue
+        void rewardRestartBandit();
+
+        /////////////////
+        // Phases
+        vector<lbool> targetPolarity; ///<Polarities at the longest conflict-free trail since the last restart
+        vector<lbool> bestPolarity; ///<Polarities at the longest conflict-free trail since the last rephase
+        size_t targetTrailSize;
+        size_t bestTrailSize;
+        void updateTargetBest(const size_t conflictFree);
+        bool useTargetPhase() const;
+        uint64_t nextRephase; ///<Rephase at the first restart after this many conflicts
+        size_t numRephases;
+        void rephase();
+        bool followSavedPolarities; ///<Local search found a model: decide only on saved polarities until a conflict
         void  genRandomVarActMultDiv();
 
         ////////////
@@ -847,6 +913,11 @@ inline void Searcher::varDecayActivity()
 }
 inline void Searcher::varBumpActivity(Var var)
 {
+    if (params.branch_type == Branch::vmtf) {
+        vmtfToBump.push_back(var);
+        return;
+    }
+
     activities[var] += var_inc;
     if ( (activities[var]) > ((0x1U) << 24)
         || var_inc > ((0x1U) << 24)
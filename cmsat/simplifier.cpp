@@ -30,6 +30,7 @@
 #include <set>
 #include <iostream>
 #include <limits>
+#include <thread>
 
 
 #include "simplifier.h"
@@ -39,9 +40,10 @@
 #include "constants.h"
 #include "solutionextender.h"
 #include "gatefinder.h"
+#include "bva.h"
 #include "varreplacer.h"
 #include "varupdatehelper.h"
-#include "completedetachreattacher.h"
+#include "inprocsched.h"
 
 #ifdef USE_M4RI
 #include "xorfinder.h"
@@ -85,6 +87,7 @@ Simplifier::Simplifier(Solver* _solver):
     #endif
 
     gateFinder = new GateFinder(this, solver);
+    bva = new BVA(this, solver);
 }
 
 Simplifier::~Simplifier()
@@ -94,6 +97,7 @@ Simplifier::~Simplifier()
     #endif
 
     delete gateFinder;
+    delete bva;
 }
 
 /**
@@ -123,6 +127,15 @@ void Simplifier::updateVars(
     , const vector<uint32_t>& interToOuter
 ) {
     updateArray(var_elimed, interToOuter);
+
+    //Keep the elimination scores, unless vars have been added since
+    invalidateTouchedScores();
+    if (varElimScoreValid.size() == interToOuter.size()) {
+        updateArray(varElimScoreValid, interToOuter);
+        updateArray(varElimComplexity, interToOuter);
+    } else {
+        varElimScoreValid.clear();
+    }
 }
 
 void Simplifier::print_blocked_clauses_reverse() const
@@ -197,6 +210,7 @@ uint32_t Simplifier::subsume0(ClOffset offset)
         cl.makeNonLearnt();
         solver->binTri.redLits -= cl.size();
         solver->binTri.irredLits += cl.size();
+        solver->touchIrredLits(cl);
         if (!cl.getOccurLinked()) {
             linkInClause(cl);
         }
@@ -287,53 +301,73 @@ Simplifier::Sub1Ret Simplifier::subsume1(const ClOffset offset)
         , cl.abst
         , subs
         , subsLits
+        , *toDecrease
+        , runStats
     );
 
     for (size_t j = 0
         ; j < subs.size() && solver->okay()
         ; j++
     ) {
-        ClOffset offset2 = subs[j];
-        Clause& cl2 = *solver->clAllocator->getPointer(offset2);
-        if (subsLits[j] == lit_Undef) {  //Subsume
+        subsume1With(offset, subs[j], subsLits[j], ret);
+        if (!solver->ok)
+            return ret;
 
-            if (solver->conf.verbosity >= 6)
-                cout << "subsumed clause " << cl2 << endl;
+        //If we are waaay over time, just exit
+        if (subsLits[j] != lit_Undef
+            && *toDecrease < -20LL*1000LL*1000LL
+        ) {
+            break;
+        }
+    }
 
-            //If subsumes a non-learnt, and is learnt, make it non-learnt
-            if (cl.learnt()
-                && !cl2.learnt()
-            ) {
-                cl.makeNonLearnt();
-                solver->binTri.redLits -= cl.size();
-                solver->binTri.irredLits += cl.size();
-                if (!cl.getOccurLinked()) {
-                    linkInClause(cl);
-                }
-            }
+    return ret;
+}
 
-            //Update stats
-            cl.combineStats(cl2.stats);
+/**
+@brief Subsumes or strengthens offset2 with offset, as found by findStrengthened
 
-            unlinkClause(offset2);
-            ret.sub++;
-        } else { //Strengthen
-            if (solver->conf.verbosity >= 6) {
-                cout << "strenghtened clause " << cl2 << endl;
+@param litSub lit_Undef to subsume, the literal to remove to strengthen
+*/
+void Simplifier::subsume1With(
+    const ClOffset offset
+    , const ClOffset offset2
+    , const Lit litSub
+    , Sub1Ret& ret
+) {
+    Clause& cl = *solver->clAllocator->getPointer(offset);
+    Clause& cl2 = *solver->clAllocator->getPointer(offset2);
+    if (litSub == lit_Undef) {  //Subsume
+
+        if (solver->conf.verbosity >= 6)
+            cout << "subsumed clause " << cl2 << endl;
+
+        //If subsumes a non-learnt, and is learnt, make it non-learnt
+        if (cl.learnt()
+            && !cl2.learnt()
+        ) {
+            cl.makeNonLearnt();
+            solver->binTri.redLits -= cl.size();
+            solver->binTri.irredLits += cl.size();
+            solver->touchIrredLits(cl);
+            if (!cl.getOccurLinked()) {
+                linkInClause(cl);
             }
-            strengthen(offset2, subsLits[j]);
+        }
 
-            ret.str++;
-            if (!solver->ok)
-                return ret;
+        //Update stats
+        cl.combineStats(cl2.stats);
 
-            //If we are waaay over time, just exit
-            if (*toDecrease < -20LL*1000LL*1000LL)
-                break;
+        unlinkClause(offset2);
+        ret.sub++;
+    } else { //Strengthen
+        if (solver->conf.verbosity >= 6) {
+            cout << "strenghtened clause " << cl2 << endl;
         }
-    }
+        strengthen(offset2, litSub);
 
-    return ret;
+        ret.str++;
+    }
 }
 
 /**
@@ -345,8 +379,8 @@ void Simplifier::unlinkClause(const ClOffset offset, bool drup)
     #ifdef DRUP
     if (solver->drup && drup) {
        (*solver->drup)
-       << "d " << cl
-       << " 0\n";
+       << DrupFlag::del << cl
+       << DrupFlag::fin;
     }
     #endif
 
@@ -356,8 +390,10 @@ void Simplifier::unlinkClause(const ClOffset offset, bool drup)
 
         removeWCl(solver->watches[cl[i].toInt()], offset);
 
-        if (!cl.learnt())
+        if (!cl.learnt()) {
             touched.touch(cl[i]);
+            solver->touchIrred(cl[i]);
+        }
     }
 
     if (cl.learnt()) {
@@ -416,8 +452,8 @@ lbool Simplifier::cleanClause(ClOffset offset)
         #ifdef DRUP
         if (solver->drup) {
            *(solver->drup)
-           << "d " << origCl
-           << " 0\n";
+           << DrupFlag::del << origCl
+           << DrupFlag::fin;
         }
         #endif
 
@@ -426,10 +462,14 @@ lbool Simplifier::cleanClause(ClOffset offset)
     }
 
     //Update lits stat
-    if (cl.learnt())
+    if (cl.learnt()) {
         solver->binTri.redLits -= i-j;
-    else
+    } else {
         solver->binTri.irredLits -= i-j;
+        if (i != j) {
+            solver->touchIrredLits(cl);
+        }
+    }
 
     #ifdef DRUP
     if (solver->conf.verbosity >= 6) {
@@ -438,11 +478,11 @@ lbool Simplifier::cleanClause(ClOffset offset)
     if (solver->drup && ((i-j > 0))) {
         *(solver->drup)
         << cl
-        << " 0\n"
+        << DrupFlag::fin
 
         //Delete old one
-        << "d " << origCl
-        << " 0\n";
+        << DrupFlag::del << origCl
+        << DrupFlag::fin;
     }
     #endif
 
@@ -502,18 +542,21 @@ void Simplifier::strengthen(ClOffset offset, const Lit toRemoveLit)
     if (solver->drup) {
         *(solver->drup)
         << cl
-        << " 0\n"
-        << "d " << origCl
-        << " 0\n";
+        << DrupFlag::fin
+        << DrupFlag::del << origCl
+        << DrupFlag::fin;
     }
     #endif
 
     runStats.litsRemStrengthen++;
     removeWCl(solver->watches[toRemoveLit.toInt()], offset);
-    if (cl.learnt())
+    if (cl.learnt()) {
         solver->binTri.redLits--;
-    else
+    } else {
         solver->binTri.irredLits--;
+        solver->touchIrred(toRemoveLit);
+        solver->touchIrredLits(cl);
+    }
 
     cleanClause(offset);
 }
@@ -618,6 +661,133 @@ bool Simplifier::performStrengthening()
     return solver->ok;
 }
 
+/**
+@brief Finds the clauses clauses[start..end) could subsume or strengthen
+
+Runs on a worker thread: it only reads the occurrence lists and the clauses,
+and uses its own time limit and stats
+*/
+void Simplifier::findSub1Cands(
+    const size_t start
+    , const size_t end
+    , int64_t limit
+    , vector<Sub1Cand>* out
+    , Stats* stats
+) {
+    vector<ClOffset> mySubs;
+    vector<Lit> myLits;
+    for(size_t i = start; i < end && limit > 0; i++) {
+        const ClOffset offset = clauses[i];
+        const Clause& cl = *solver->clAllocator->getPointer(offset);
+        if (cl.getFreed())
+            continue;
+
+        mySubs.clear();
+        myLits.clear();
+        findStrengthened(offset, cl, cl.abst, mySubs, myLits, limit, *stats);
+        for(size_t j = 0; j < mySubs.size(); j++) {
+            out->push_back(Sub1Cand(offset, mySubs[j], myLits[j]));
+        }
+    }
+}
+
+/**
+@brief Subsumption and strengthening with every clause, on several threads
+
+Instead of trying random clauses, every clause is tried. The clauses are split
+into consecutive slices, and the worker threads find what the clauses in their
+slice could subsume or strengthen, without changing anything. Each worker has
+the time limit of the serial strengthening, so this takes about as long.
+
+The candidates are then applied serially, in the order of the clauses, so the
+result only depends on the number of threads. Since an earlier candidate may
+have removed or changed one of the clauses, each candidate is checked again
+before it is applied.
+*/
+bool Simplifier::performParallelSubsumption()
+{
+    assert(solver->ok);
+    if (clauses.empty())
+        return true;
+
+    double myTime = cpuTime();
+    const double myTimeAllThreads = cpuTimeTotal();
+    const size_t numThreads = std::min<size_t>(
+        solver->conf.numSimpThreads
+        , clauses.size()/1000 + 1
+    );
+
+    //Find
+    vector<vector<Sub1Cand> > cands(numThreads);
+    vector<Stats> threadStats(numThreads);
+    vector<std::thread> threads;
+    const size_t sliceSize = clauses.size()/numThreads + 1;
+    for(size_t i = 0; i < numThreads; i++) {
+        const size_t start = std::min(i*sliceSize, clauses.size());
+        const size_t end = std::min(start + sliceSize, clauses.size());
+        threads.push_back(std::thread(
+            &Simplifier::findSub1Cands, this
+            , start, end, numMaxSubsume1, &cands[i], &threadStats[i]
+        ));
+    }
+    for(size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+        runStats += threadStats[i];
+    }
+    const double findTime = cpuTimeTotal() - myTimeAllThreads;
+
+    //Apply
+    toDecrease = &numMaxSubsume1;
+    Sub1Ret ret;
+    size_t numCands = 0;
+    size_t numStale = 0;
+    for(size_t i = 0; i < cands.size() && solver->ok; i++) {
+        numCands += cands[i].size();
+        for(vector<Sub1Cand>::const_iterator
+            it = cands[i].begin(), end = cands[i].end()
+            ; it != end && solver->ok
+            ; it++
+        ) {
+            const Clause& cl = *solver->clAllocator->getPointer(it->subsumer);
+            const Clause& cl2 = *solver->clAllocator->getPointer(it->subsumed);
+            if (cl.getFreed()
+                || cl2.getFreed()
+                || cl.size() > cl2.size()
+            ) {
+                numStale++;
+                continue;
+            }
+
+            const Lit litSub = subset1(cl, cl2, *toDecrease);
+            if (litSub == lit_Error) {
+                numStale++;
+                continue;
+            }
+
+            subsume1With(it->subsumer, it->subsumed, litSub, ret);
+        }
+    }
+
+    if (solver->conf.verbosity >= 3) {
+        cout
+        << "c par-streng threads: " << numThreads
+        << " cands: " << numCands
+        << " stale: " << numStale
+        << " sub: " << ret.sub
+        << " str: " << ret.str
+        << " find T(all threads): " << std::fixed << std::setprecision(2) << findTime
+        << " T: " << cpuTime() - myTime
+        << endl;
+    }
+
+    //Update time used
+    runStats.subsumedByStr += ret.sub;
+    runStats.litsRemStrengthen += ret.str;
+    runStats.strengthenTime += cpuTime() - myTime;
+
+    return solver->ok;
+}
+
 void Simplifier::linkInClause(Clause& cl)
 {
     assert(cl.size() > 3);
@@ -630,9 +800,81 @@ void Simplifier::linkInClause(Clause& cl)
         ws.push(Watched(offset, cl.abst));
     }
     assert(cl.abst == calcAbstraction(cl));
+    assert(cl.abst2 == calcAbstraction2(cl));
     cl.setOccurLinked(true);
 }
 
+/**
+@brief Estimates how many MB the occur lists of the clauses in 'toAdd' would take
+*/
+uint64_t Simplifier::occurMemUsageMB(const vector<ClOffset>& toAdd) const
+{
+    uint64_t memUsage = 0;
+    for (vector<ClOffset>::const_iterator
+        it = toAdd.begin(), end = toAdd.end()
+        ; it !=  end
+        ; it++
+    ) {
+        const Clause* cl = solver->clAllocator->getPointer(*it);
+        //*2 because of the overhead of allocation
+        memUsage += cl->size()*sizeof(Watched)*2;
+    }
+
+    //Estimate malloc overhead
+    memUsage += solver->numActiveVars()*2*40;
+
+    return memUsage/(1024ULL*1024ULL);
+}
+
+bool Simplifier::shouldLinkIn(
+    const Clause& cl
+    , const bool irred
+    , const uint64_t linkedInLits
+) const {
+    //If irreduntant or (small enough AND link in limit not reached)
+    return irred
+        || (cl.size() < solver->conf.maxRedLinkInSize
+            && linkedInLits < (solver->conf.maxOccurRedLitLinkedM*1000ULL*1000ULL));
+}
+
+/**
+@brief Counts the occurrences of each literal, and reserves the occur lists
+
+The clauses to be linked in are decided the same way addFromSolver() does it.
+With the exact sizes reserved, every occur list is allocated once, instead of
+being grown step by step while the clauses are linked in one by one. The
+lists are still the watchlists, this only saves the re-allocations.
+*/
+void Simplifier::reserveOccur(const vector<ClOffset>& toAdd, const bool irred)
+{
+    occurCount.clear();
+    occurCount.resize(solver->nVars()*2, 0);
+
+    uint64_t linkedInLits = 0;
+    for (vector<ClOffset>::const_iterator
+        it = toAdd.begin(), end = toAdd.end()
+        ; it !=  end
+        ; it++
+    ) {
+        const Clause* cl = solver->clAllocator->getPointer(*it);
+        if (!shouldLinkIn(*cl, irred, linkedInLits))
+            continue;
+
+        for (const Lit *l = cl->begin(), *end2 = cl->end(); l != end2; l++) {
+            occurCount[l->toInt()]++;
+        }
+        linkedInLits += cl->size();
+    }
+
+    for(size_t i = 0; i < occurCount.size(); i++) {
+        if (occurCount[i] == 0)
+            continue;
+
+        vec<Watched>& ws = solver->watches[i];
+        ws.reserve(ws.size() + occurCount[i]);
+    }
+}
+
 /**
 @brief Adds clauses from the solver to the occur
 */
@@ -648,30 +890,17 @@ bool Simplifier::addFromSolver(
     //over + irred -> exit
     //over + red -> don't link
     if (alsoOccur) {
-        uint64_t memUsage = 0;
-        for (vector<ClOffset>::iterator
-            it = toAdd.begin(), end = toAdd.end()
-            ; it !=  end
-            ; it++
-        ) {
-            Clause* cl = solver->clAllocator->getPointer(*it);
-            //*2 because of the overhead of allocation
-            memUsage += cl->size()*sizeof(Watched)*2;
-        }
-
-        //Estimate malloc overhead
-        memUsage += solver->numActiveVars()*2*40;
-
+        const uint64_t memUsageMB = occurMemUsageMB(toAdd);
         if (solver->conf.verbosity >= 2) {
             cout
             << "c [simp] mem usage for occur of "
             << (irred ?  "irred" : "red  ")
-            << " " << std::setw(6) << memUsage/(1024ULL*1024ULL) << " MB"
+            << " " << std::setw(6) << memUsageMB << " MB"
             << endl;
         }
 
         if (irred
-            && memUsage/(1024ULL*1024ULL) > solver->conf.maxOccurIrredMB
+            && memUsageMB > solver->conf.maxOccurIrredMB
         ) {
             if (solver->conf.verbosity >= 2) {
                 cout
@@ -683,7 +912,7 @@ bool Simplifier::addFromSolver(
         }
 
         if (!irred
-            && memUsage/(1024ULL*1024ULL) > solver->conf.maxOccurRedMB
+            && memUsageMB > solver->conf.maxOccurRedMB
         ) {
             alsoOccur = false;
             if (solver->conf.verbosity >= 2) {
@@ -698,6 +927,10 @@ bool Simplifier::addFromSolver(
         std::sort(toAdd.begin(), toAdd.end(), MySorter(solver->clAllocator));
     }
 
+    if (alsoOccur) {
+        reserveOccur(toAdd, irred);
+    }
+
     uint64_t linkedInLits = 0;
     size_t numNotLinkedIn = 0;
     size_t numLinkedIn = 0;
@@ -715,11 +948,7 @@ bool Simplifier::addFromSolver(
         );
 
         if (alsoOccur
-            //If irreduntant or (small enough AND link in limit not reached)
-            && (irred
-                || (cl->size() < solver->conf.maxRedLinkInSize
-                    && linkedInLits < (solver->conf.maxOccurRedLitLinkedM*1000ULL*1000ULL))
-            )
+            && shouldLinkIn(*cl, irred, linkedInLits)
         ) {
             linkInClause(*cl);
             numLinkedIn++;
@@ -857,11 +1086,14 @@ bool Simplifier::completeCleanClause(Clause& cl)
     Lit *j = i;
     for (Lit *end = cl.end(); i != end; i++) {
         if (solver->value(*i) == l_True) {
+            if (!cl.learnt()) {
+                solver->touchIrredLits(cl);
+            }
             #ifdef DRUP
             if (solver->drup) {
                 *(solver->drup)
-                << "d " << origCl
-                << " 0\n";
+                << DrupFlag::del << origCl
+                << DrupFlag::fin;
             }
             #endif
             return false;
@@ -872,16 +1104,19 @@ bool Simplifier::completeCleanClause(Clause& cl)
         }
     }
     cl.shrink(i-j);
+    if (i != j && !cl.learnt()) {
+        solver->touchIrredLits(cl);
+    }
 
     #ifdef DRUP
     if (solver->drup && (i - j > 0)) {
         *(solver->drup)
         << cl
-        << " 0\n"
+        << DrupFlag::fin
 
         //Delete old one
-        << "d " << origCl
-        << " 0\n";
+        << DrupFlag::del << origCl
+        << DrupFlag::fin;
     }
     #endif
 
@@ -953,6 +1188,11 @@ bool Simplifier::eliminateVars()
         << endl;
     }
 
+    if (solver->conf.numSimpThreads > 1) {
+        eliminateVarsParallel(vars_elimed, wenThrough);
+        goto end;
+    }
+
     //Go through the ordered list of variables to eliminate
     while(!varElimOrder.empty()
         && *toDecrease > 0
@@ -1006,6 +1246,226 @@ end:
     return solver->ok;
 }
 
+/**
+@brief Marks the variables that share a clause with var, including var itself
+*/
+void Simplifier::markElimNeighbours(
+    const Var var
+    , vector<unsigned char>& varMark
+    , vector<Var>& marked
+) {
+    for(int sign = 0; sign < 2; sign++) {
+        const vec<Watched>& ws = solver->watches[Lit(var, sign).toInt()];
+        *toDecrease -= ws.size();
+        for(vec<Watched>::const_iterator
+            it = ws.begin(), end = ws.end()
+            ; it != end
+            ; it++
+        ) {
+            Lit tmp[2];
+            const Lit* begin = tmp;
+            const Lit* finish = tmp;
+            if (it->isBinary()) {
+                tmp[0] = it->lit1();
+                finish = tmp + 1;
+            } else if (it->isTri()) {
+                tmp[0] = it->lit1();
+                tmp[1] = it->lit2();
+                finish = tmp + 2;
+            } else if (it->isClause()) {
+                const Clause& cl = *solver->clAllocator->getPointer(it->getOffset());
+                *toDecrease -= cl.size();
+                begin = cl.begin();
+                finish = cl.end();
+            }
+
+            for(const Lit* l = begin; l != finish; l++) {
+                if (!varMark[l->var()]) {
+                    varMark[l->var()] = 1;
+                    marked.push_back(l->var());
+                }
+            }
+        }
+    }
+
+    if (!varMark[var]) {
+        varMark[var] = 1;
+        marked.push_back(var);
+    }
+}
+
+/**
+@brief Calculates the resolvents of batch[first], batch[first+step], ...
+
+Runs on a worker thread. The variables of the batch share no clauses, so
+testVarElim() of each only touches its own occurrence lists.
+*/
+void Simplifier::findResolvents(
+    const vector<Var>* batch
+    , const size_t first
+    , const size_t step
+    , ElimWork* work
+    , vector<ElimResult>* results
+) {
+    for(size_t i = first; i < batch->size(); i += step) {
+        const Var var = (*batch)[i];
+        ElimResult& res = (*results)[i];
+        res.cost = testVarElim(var, *work);
+        res.numPos = solver->watches[Lit(var, false).toInt()].size();
+        res.numNeg = solver->watches[Lit(var, true).toInt()].size();
+        res.resolvents.swap(work->resolvents);
+    }
+}
+
+/**
+@brief Variable elimination, calculating the resolvents on several threads
+
+Variables are taken from the top of the elimination order into a batch as long
+as they don't share a clause with a variable already in the batch; the others
+are put back. The resolvents of the batch are calculated on the worker threads,
+then the variables are eliminated serially, in the order they were taken.
+Eliminating a variable can only remove clauses of a later one in the batch
+(through subsumption by a resolvent), in which case the later one is tested
+again serially.
+
+Each worker has the current time limit, and the most any of them used is taken
+off it, so a batch takes about as long as eliminating its slowest variable.
+*/
+void Simplifier::eliminateVarsParallel(size_t& vars_elimed, size_t& wenThrough)
+{
+    const size_t numThreads = solver->conf.numSimpThreads;
+    const size_t maxBatch = numThreads*16;
+    vector<ElimWork> works(numThreads);
+    for(size_t i = 0; i < numThreads; i++) {
+        works[i].seen.resize(solver->nVars()*2, 0);
+    }
+    vector<unsigned char> varMark(solver->nVars(), 0);
+    vector<Var> marked;
+    vector<Var> batch;
+    vector<Var> putBack;
+    vector<ElimResult> results;
+    size_t numBatches = 0;
+    size_t numRetested = 0;
+
+    while(!varElimOrder.empty()
+        && *toDecrease > 0
+        && numMaxElimVars > 0
+    ) {
+        //Take the batch
+        batch.clear();
+        putBack.clear();
+        while(!varElimOrder.empty()
+            && batch.size() < maxBatch
+            && putBack.size() < maxBatch
+        ) {
+            const Var var = varElimOrder.removeMin();
+            *toDecrease -= 20;
+            if (solver->value(var) != l_Undef
+                || solver->varData[var].removed != Removed::none
+            ) {
+                continue;
+            }
+
+            if (varMark[var]) {
+                putBack.push_back(var);
+                continue;
+            }
+
+            batch.push_back(var);
+            markElimNeighbours(var, varMark, marked);
+        }
+        for(vector<Var>::const_iterator
+            it = marked.begin(), end = marked.end()
+            ; it != end
+            ; it++
+        ) {
+            varMark[*it] = 0;
+        }
+        marked.clear();
+        for(vector<Var>::const_iterator
+            it = putBack.begin(), end = putBack.end()
+            ; it != end
+            ; it++
+        ) {
+            varElimOrder.insert(*it);
+        }
+        if (batch.empty())
+            break;
+
+        numBatches++;
+        wenThrough += batch.size();
+
+        //Calculate resolvents
+        results.clear();
+        results.resize(batch.size());
+        const size_t threadsNeeded = std::min(numThreads, batch.size());
+        vector<std::thread> threads;
+        for(size_t i = 0; i < threadsNeeded; i++) {
+            works[i].limit = *toDecrease;
+            works[i].aggressiveLimit = numMaxVarElimAgressiveCheck;
+            works[i].usedAgressive = 0;
+            threads.push_back(std::thread(
+                &Simplifier::findResolvents, this
+                , &batch, i, threadsNeeded, &works[i], &results
+            ));
+        }
+        int64_t maxUsed = 0;
+        int64_t maxAggressiveUsed = 0;
+        for(size_t i = 0; i < threadsNeeded; i++) {
+            threads[i].join();
+            maxUsed = std::max(maxUsed, *toDecrease - works[i].limit);
+            maxAggressiveUsed = std::max(
+                maxAggressiveUsed
+                , numMaxVarElimAgressiveCheck - works[i].aggressiveLimit
+            );
+            runStats.usedAgressiveCheckToELim += works[i].usedAgressive;
+        }
+        *toDecrease -= maxUsed;
+        numMaxVarElimAgressiveCheck -= maxAggressiveUsed;
+
+        //Eliminate in order
+        for(size_t i = 0; i < batch.size() && numMaxElimVars > 0; i++) {
+            const Var var = batch[i];
+            const ElimResult& res = results[i];
+            if (solver->value(var) != l_Undef
+                || solver->varData[var].removed != Removed::none
+            ) {
+                continue;
+            }
+
+            bool elimed;
+            if (solver->watches[Lit(var, false).toInt()].size() != res.numPos
+                || solver->watches[Lit(var, true).toInt()].size() != res.numNeg
+            ) {
+                numRetested++;
+                elimed = maybeEliminate(var);
+            } else {
+                runStats.testedToElimVars++;
+                elimed = (res.cost != 1000 && eliminate(var, res.resolvents));
+            }
+
+            if (elimed) {
+                vars_elimed++;
+                numMaxElimVars--;
+            }
+
+            //During elimination, we reached UNSAT, finish
+            if (!solver->ok)
+                return;
+        }
+    }
+
+    if (solver->conf.verbosity >= 2) {
+        cout
+        << "c  #par-elim threads: " << numThreads
+        << " batches: " << numBatches
+        << " avg batch: " << std::fixed << std::setprecision(1)
+        << (double)wenThrough/(double)std::max<size_t>(numBatches, 1)
+        << " retested: " << numRetested
+        << endl;
+    }
+}
+
 bool Simplifier::propagate()
 {
     assert(solver->ok);
@@ -1331,25 +1791,32 @@ bool Simplifier::simplify()
     toDecrease = &numMaxSubsume1;
     size_t origTrailSize = solver->trail.size();
 
-    //Remove all long clauses from watches
+    //Memory limit would be reached, irreduntant clauses cannot
+    //be added to occur, so exit, we can't do most of the good stuff
+    //like var-elim. Checked before the clauses are removed from the
+    //watches, so there is nothing to re-attach
+    if (occurMemUsageMB(solver->longIrredCls) > solver->conf.maxOccurIrredMB) {
+        if (solver->conf.verbosity >= 2) {
+            cout
+            << "c [simp] Not linking in irred due to excessive expected memory usage"
+            << endl;
+        }
+        return solver->okay();
+    }
+
+    //Remove all long clauses from watches. The occur lists are the
+    //watchlists, so every simplify() still takes them apart here, and
+    //addBackToSolver() builds them again
     removeAllLongsFromWatches();
 
-    //Try to add irreducible to occur
+    //Add irreducible to occur
     runStats.origNumIrredLongClauses = solver->longIrredCls.size();
     bool ret = addFromSolver(solver->longIrredCls
         , true //try to add to occur list
         , true //it is irred
         , addedClauseLits
     );
-
-    //Memory limit would have been reached, irreduntant clauses cannot
-    //be added to occur, so exit, we can't do most of the good stuff
-    //like var-elim
-    if (!ret) {
-        CompleteDetachReatacher detRet(solver);;
-        detRet.reattachLongs(true);
-        return solver->okay();
-    }
+    assert(ret);
 
     //Add learnt to occur
     runStats.origNumRedLongClauses = solver->longRedCls.size();
@@ -1375,6 +1842,7 @@ bool Simplifier::simplify()
 
     //Checking
     checkForElimedVars();
+    markXorVars();
 
     //Gate-finding
     if (solver->conf.doCache && solver->conf.doGateFind) {
@@ -1391,12 +1859,15 @@ bool Simplifier::simplify()
 
 //     subsumeWithTris();
 
-    //Carry out subsume0
-    performSubsumption();
-
-    //Carry out strengthening
-    if (!performStrengthening())
-        goto end;
+    //Carry out subsume0&strengthening
+    if (solver->conf.numSimpThreads > 1) {
+        if (!performParallelSubsumption())
+            goto end;
+    } else {
+        performSubsumption();
+        if (!performStrengthening())
+            goto end;
+    }
 
     //XOR-finding
     #ifdef USE_M4RI
@@ -1427,6 +1898,11 @@ bool Simplifier::simplify()
         goto end;
     }
 
+    //Replace clause grids with new variables, on what var-elim has left
+    if (solver->conf.doBVA && !bva->bva()) {
+        goto end;
+    }
+
     assert(solver->ok);
 
 end:
@@ -1450,15 +1926,15 @@ end:
             }
 
             (*solver->drup)
-            << "d ";
+            << DrupFlag::del;
             for(vector<Lit>::const_iterator
                 it = blockedClauses[i].lits.begin(), end = blockedClauses[i].lits.end()
                 ; it != end
                 ; it++
             ) {
-                (*solver->drup) << *it << " ";
+                (*solver->drup) << *it;
             }
-            (*solver->drup) << "0\n";
+            (*solver->drup) << DrupFlag::fin;
         }
     }
     #endif
@@ -1521,7 +1997,7 @@ bool Simplifier::unEliminate(Var var)
         #ifdef VERBOSE_DEBUG_RECONSTRUCT
         cout << "Uneliminating " << cl << " on var " << var+1 << endl;
         #endif
-        solver->addClause(cl);
+        solver->addClauseOuter(cl);
         if (!solver->okay())
             return false;
     }
@@ -1629,10 +2105,12 @@ bool Simplifier::propImplicits()
             if (solver->value(lit) == l_True
                 || solver->value(lit2) == l_True)
             {
-                if (ws[i].learnt())
+                if (ws[i].learnt()) {
                     numRemovedHalfLearnt++;
-                else
+                } else {
                     numRemovedHalfNonLearnt++;
+                    solver->touchIrred(lit2);
+                }
 
                 continue;
             }
@@ -1653,10 +2131,12 @@ bool Simplifier::propImplicits()
                 toEnqueue.push_back(lit);
 
                 //Remove binary clause
-                if (ws[i].learnt())
+                if (ws[i].learnt()) {
                     numRemovedHalfLearnt++;
-                else
+                } else {
                     numRemovedHalfNonLearnt++;
+                    solver->touchIrred(lit2);
+                }
 
                 continue;
             }
@@ -1668,10 +2148,12 @@ bool Simplifier::propImplicits()
                 toEnqueue.push_back(lit2);
 
                 //Remove binary clause
-                if (ws[i].learnt())
+                if (ws[i].learnt()) {
                     numRemovedHalfLearnt++;
-                else
+                } else {
                     numRemovedHalfNonLearnt++;
+                    solver->touchIrred(lit2);
+                }
 
                 continue;
             }
@@ -1966,6 +2448,8 @@ void Simplifier::blockImplicit(
                     assert(!ws[i].learnt());
                     solver->binTri.irredLits -= 2;
                     solver->binTri.irredBins--;
+                    solver->touchIrred(lit);
+                    solver->touchIrred(lit2);
                 } else {
                     blockedTri++;
                     dummy.push_back(lit3);
@@ -1976,6 +2460,9 @@ void Simplifier::blockImplicit(
                     assert(!ws[i].learnt());
                     solver->binTri.irredLits -= 3;
                     solver->binTri.irredTris--;
+                    solver->touchIrred(lit);
+                    solver->touchIrred(lit2);
+                    solver->touchIrred(lit3);
                 }
 
                 blockedClauses.push_back(BlockedClause(tautOn, dummy, solver->interToOuterMain));
@@ -2170,9 +2657,9 @@ void Simplifier::asymmTE()
         //ONLY non-learnt
         //TODO stamping
         /*for (const Lit *l = cl.begin(), *end = cl.end(); l != end; l++) {
-            const vector<LitExtra>& cache = solver->implCache[l->toInt()].lits;
+            const LitExtraVec& cache = solver->implCache[l->toInt()].lits;
             *toDecrease -= cache.size();
-            for (vector<LitExtra>::const_iterator cacheLit = cache.begin(), endCache = cache.end(); cacheLit != endCache; cacheLit++) {
+            for (LitExtraVec::const_iterator cacheLit = cache.begin(), endCache = cache.end(); cacheLit != endCache; cacheLit++) {
                 if (cacheLit->getOnlyNLBin()
                     && !seen[(~cacheLit->getLit()).toInt()]
                 ) {
@@ -2191,9 +2678,9 @@ void Simplifier::asymmTE()
 //            for (const Lit* l = cl.begin(), *end = cl.end(); l != end; l++) {
 
                 //TODO stamping
-                /*const vector<LitExtra>& cache = solver->implCache[l->toInt()].lits;
+                /*const LitExtraVec& cache = solver->implCache[l->toInt()].lits;
                 *toDecrease -= cache.size();
-                for (vector<LitExtra>::const_iterator cacheLit = cache.begin(), endCache = cache.end(); cacheLit != endCache; cacheLit++) {
+                for (LitExtraVec::const_iterator cacheLit = cache.begin(), endCache = cache.end(); cacheLit != endCache; cacheLit++) {
                     if ((cacheLit->getOnlyNLBin() || cl.learnt()) //subsume non-learnt with non-learnt
                         && seen[cacheLit->getLit().toInt()]
                     ) {
@@ -2300,6 +2787,7 @@ void Simplifier::setLimits()
     numMaxBlocked     = 40LL *1000LL*1000LL;
     numMaxBlockedImpl = 1800LL *1000LL*1000LL;
     numMaxVarElimAgressiveCheck  = 300LL *1000LL*1000LL;
+    numMaxBVA         = solver->conf.bvaLimitM*1000LL*1000LL;
 
     //numMaxElim = 0;
     //numMaxElim = std::numeric_limits<int64_t>::max();
@@ -2332,6 +2820,17 @@ void Simplifier::setLimits()
     }
     runStats.origNumMaxElimVars = numMaxElimVars;
 
+    //Scale by how well this has paid off compared to the other simplifications
+    const double budget = solver->inprocSched->budget(Inproc::simplify);
+    numMaxSubsume0 = (double)numMaxSubsume0 * budget;
+    numMaxSubsume1 = (double)numMaxSubsume1 * budget;
+    numMaxElim = (double)numMaxElim * budget;
+    numMaxAsymm = (double)numMaxAsymm * budget;
+    numMaxBlocked = (double)numMaxBlocked * budget;
+    numMaxBlockedImpl = (double)numMaxBlockedImpl * budget;
+    numMaxVarElimAgressiveCheck = (double)numMaxVarElimAgressiveCheck * budget;
+    numMaxBVA = (double)numMaxBVA * budget;
+
     if (!solver->conf.doSubsume1) {
         numMaxSubsume1 = 0;
     }
@@ -2404,6 +2903,8 @@ void Simplifier::findStrengthened(
     , const CL_ABST_TYPE abs
     , vector<ClOffset>& out_subsumed
     , vector<Lit>& out_lits
+    , int64_t& limit
+    , Stats& stats
 )
 {
     #ifdef VERBOSE_DEBUG
@@ -2423,10 +2924,11 @@ void Simplifier::findStrengthened(
         }
     }
     assert(minVar != var_Undef);
-    *toDecrease -= cl.size();
+    limit -= cl.size();
+    const CL_ABST_TYPE abs2 = calcAbstraction2(cl);
 
-    fillSubs(offset, cl, abs, out_subsumed, out_lits, Lit(minVar, true));
-    fillSubs(offset, cl, abs, out_subsumed, out_lits, Lit(minVar, false));
+    fillSubs(offset, cl, abs, abs2, out_subsumed, out_lits, Lit(minVar, true), limit, stats);
+    fillSubs(offset, cl, abs, abs2, out_subsumed, out_lits, Lit(minVar, false), limit, stats);
 }
 
 /**
@@ -2439,13 +2941,16 @@ void inline Simplifier::fillSubs(
     const ClOffset offset
     , const T& cl
     , const CL_ABST_TYPE abs
+    , const CL_ABST_TYPE abs2
     , vector<ClOffset>& out_subsumed
     , vector<Lit>& out_lits
     , const Lit lit
+    , int64_t& limit
+    , Stats& stats
 ) {
     Lit litSub;
     const vec<Watched>& cs = solver->watches[lit.toInt()];
-    *toDecrease -= cs.size()*15 + 40;
+    limit -= cs.size()*15 + 40;
     for (vec<Watched>::const_iterator
         it = cs.begin(), end = cs.end()
         ; it != end
@@ -2466,8 +2971,14 @@ void inline Simplifier::fillSubs(
         if (cl.size() > cl2.size())
             continue;
 
-        *toDecrease -= cl.size() + cl2.size();
-        litSub = subset1(cl, cl2);
+        stats.sigChecked++;
+        if (!subsetAbst(abs2, cl2.abst2)) {
+            stats.sigFiltered++;
+            continue;
+        }
+
+        limit -= cl.size() + cl2.size();
+        litSub = subset1(cl, cl2, limit);
         if (litSub != lit_Error) {
             out_subsumed.push_back(it->getOffset());
             out_lits.push_back(litSub);
@@ -2547,10 +3058,10 @@ void Simplifier::removeClausesHelper(
                     && !solver->conf.doCache
                 ) {
                    *(solver->drup)
-                   << "d "
-                   << lits[0] << " "
+                   << DrupFlag::del
+                   << lits[0]
                    << lits[1]
-                   << " 0\n";
+                   << DrupFlag::fin;
                 }
                 #endif
             }
@@ -2589,11 +3100,11 @@ void Simplifier::removeClausesHelper(
                 #ifdef DRUP
                 if (solver->drup) {
                    *(solver->drup)
-                   << "d "
-                   << lits[0] << " "
-                   << lits[1] << " "
+                   << DrupFlag::del
+                   << lits[0]
+                   << lits[1]
                    << lits[2]
-                   << " 0\n";
+                   << DrupFlag::fin;
                 }
                 #endif
             }
@@ -2626,6 +3137,28 @@ uint32_t Simplifier::numNonLearntBins(const Lit lit) const
 }
 
 int Simplifier::testVarElim(const Var var)
+{
+    elimWork.seen.resize(solver->nVars()*2, 0);
+    elimWork.limit = *toDecrease;
+    elimWork.aggressiveLimit = numMaxVarElimAgressiveCheck;
+    elimWork.usedAgressive = 0;
+
+    const int ret = testVarElim(var, elimWork);
+
+    *toDecrease = elimWork.limit;
+    numMaxVarElimAgressiveCheck = elimWork.aggressiveLimit;
+    runStats.usedAgressiveCheckToELim += elimWork.usedAgressive;
+
+    return ret;
+}
+
+/**
+@brief Calculates the resolvents of var into work.resolvents, and its cost
+
+Only changes the order of the occurrence lists of var, so it can run on several
+threads at once for different variables. Returns 1000 if it's not worth it.
+*/
+int Simplifier::testVarElim(const Var var, ElimWork& work)
 {
     assert(solver->ok);
     assert(!var_elimed[var]);
@@ -2634,17 +3167,17 @@ int Simplifier::testVarElim(const Var var)
     assert(solver->value(var) == l_Undef);
 
     //Gather data
-    HeuristicData pos = calcDataForHeuristic(Lit(var, false));
-    HeuristicData neg = calcDataForHeuristic(Lit(var, true));
+    HeuristicData pos = calcDataForHeuristic(Lit(var, false), work.limit);
+    HeuristicData neg = calcDataForHeuristic(Lit(var, true), work.limit);
 
     //Heuristic calculation took too much time
-    if (*toDecrease < 0) {
+    if (work.limit < 0) {
         return 1000;
     }
 
     //Check if we should do agressive check or not
-    const bool agressive = (numMaxVarElimAgressiveCheck > 0);
-    runStats.usedAgressiveCheckToELim += agressive;
+    const bool agressive = (work.aggressiveLimit > 0);
+    work.usedAgressive += agressive;
 
     //set-up
     const Lit lit = Lit(var, false);
@@ -2652,7 +3185,7 @@ int Simplifier::testVarElim(const Var var)
     vec<Watched>& negs = solver->watches[(~lit).toInt()];
     std::sort(poss.begin(), poss.end(), WatchSorter());
     std::sort(negs.begin(), negs.end(), WatchSorter());
-    resolvents.clear();
+    work.resolvents.clear();
 
     //Pure literal, no resolvents
     //we look at "pos" and "neg" (and not poss&negs) because we don't care about learnt clauses
@@ -2677,7 +3210,7 @@ int Simplifier::testVarElim(const Var var)
         ; it++
     ) {
         //Decrement available time
-        *toDecrease -= 3;
+        work.limit -= 3;
 
         //Ignore learnt
         if (((it->isBinary() || it->isTri()) && it->learnt())
@@ -2692,7 +3225,7 @@ int Simplifier::testVarElim(const Var var)
             ; it2++
         ) {
             //Decrement available time
-            *toDecrease -= 3;
+            work.limit -= 3;
 
             //Ignore learnt
             if (
@@ -2705,30 +3238,30 @@ int Simplifier::testVarElim(const Var var)
             }
 
             //Resolve the two clauses
-            bool ok = merge(*it, *it2, lit, agressive);
+            bool ok = merge(*it, *it2, lit, agressive, work);
 
             //The resolvent is tautological
             if (!ok)
                 continue;
 
             #ifdef VERBOSE_DEBUG_VARELIM
-            cout << "Adding new clause due to varelim: " << dummy << endl;
+            cout << "Adding new clause due to varelim: " << work.dummy << endl;
             #endif
 
             //Update after-stats
             after_clauses++;
-            after_literals += dummy.size();
-            if (dummy.size() > 3)
+            after_literals += work.dummy.size();
+            if (work.dummy.size() > 3)
                 after_long++;
-            if (dummy.size() == 3)
+            if (work.dummy.size() == 3)
                 after_tri++;
-            if (dummy.size() == 2)
+            if (work.dummy.size() == 2)
                 after_bin++;
 
             //Early-abort or over time
             if (after_clauses > before_clauses
                 //Over-time
-                || *toDecrease < -10LL*1000LL
+                || work.limit < -10LL*1000LL
             )
                 return 1000;
 
@@ -2744,7 +3277,7 @@ int Simplifier::testVarElim(const Var var)
                     , solver->clAllocator->getPointer(it2->getOffset())->stats
             );
 
-            resolvents.push_back(std::make_pair(dummy, stats));
+            work.resolvents.push_back(std::make_pair(work.dummy, stats));
         }
     }
 
@@ -2813,6 +3346,17 @@ bool Simplifier::maybeEliminate(const Var var)
         return false;
     }
 
+    return eliminate(var, elimWork.resolvents);
+}
+
+/**
+@brief Eliminates the variable, replacing its clauses with the resolvents
+
+The resolvents must have been calculated by testVarElim() on the current
+clauses of the variable
+*/
+bool Simplifier::eliminate(const Var var, const Resolvents& resolvents)
+{
     runStats.triedToElimVars++;
 
     //The literal
@@ -2847,7 +3391,7 @@ bool Simplifier::maybeEliminate(const Var var)
     assert(solver->watches[(~lit).toInt()].empty());
 
     //Add resolvents calculated in testVarElim()
-    for(vector<pair<vector<Lit>, ClauseStats> >::const_iterator
+    for(Resolvents::const_iterator
         it = resolvents.begin(), end = resolvents.end()
         ; it != end
         ; it++
@@ -2973,6 +3517,16 @@ end:
     runStats.numVarsElimed++;
     solver->unsetDecisionVar(var);
 
+    //Re-score the neighbours at the next round, whether updated above or not
+    for(vector<Var>::const_iterator
+        it = touched.getTouchedList().begin()
+        , end = touched.getTouchedList().end()
+        ; it != end
+        ; it++
+    ) {
+        solver->touchIrred(*it);
+    }
+
     return solver->ok;
 }
 
@@ -3029,6 +3583,7 @@ bool Simplifier::merge(
     , const Watched& qs
     , const Lit noPosLit
     , const bool aggressive
+    , ElimWork& work
 ) {
     //If clause has already been freed, skip
     if (ps.isClause()
@@ -3042,13 +3597,16 @@ bool Simplifier::merge(
         return false;
     }
 
-    dummy.clear(); //The final clause
-    toClear.clear(); //Used to clear 'seen'
+    vector<unsigned char>& seen = work.seen;
+    vector<Lit>& dummy = work.dummy; //The final clause
+    vector<Lit>& toClear = work.toClear; //Used to clear 'seen'
+    dummy.clear();
+    toClear.clear();
 
     //Handle PS
     bool retval = true;
     if (ps.isBinary() || ps.isTri()) {
-        *toDecrease -= 1;
+        work.limit -= 1;
         assert(ps.lit1() != noPosLit);
 
         seen[ps.lit1().toInt()] = 1;
@@ -3065,7 +3623,7 @@ bool Simplifier::merge(
     if (ps.isClause()) {
         Clause& cl = *solver->clAllocator->getPointer(ps.getOffset());
         //assert(!clauseData[ps.clsimp.index].defOfOrGate);
-        *toDecrease -= cl.size();
+        work.limit -= cl.size();
         for (uint32_t i = 0; i < cl.size(); i++){
             //Skip noPosLit
             if (cl[i] == noPosLit)
@@ -3078,7 +3636,7 @@ bool Simplifier::merge(
 
     //Handle QS
     if (qs.isBinary() || qs.isTri()) {
-        *toDecrease -= 2;
+        work.limit -= 2;
         assert(qs.lit1() != ~noPosLit);
 
         if (seen[(~qs.lit1()).toInt()]) {
@@ -3109,7 +3667,7 @@ bool Simplifier::merge(
     if (qs.isClause()) {
         Clause& cl = *solver->clAllocator->getPointer(qs.getOffset());
         //assert(!clauseData[qs.clsimp.index].defOfOrGate);
-        *toDecrease -= cl.size();
+        work.limit -= cl.size();
         for (uint32_t i = 0; i < cl.size(); i++){
 
             //Skip ~noPosLit
@@ -3138,10 +3696,10 @@ bool Simplifier::merge(
         && solver->conf.doAsymmTE
     ) {
         for (size_t i = 0
-            ; i < dummy.size() && numMaxVarElimAgressiveCheck > 0
+            ; i < dummy.size() && work.aggressiveLimit > 0
             ; i++
         ) {
-            numMaxVarElimAgressiveCheck -= 3;
+            work.aggressiveLimit -= 3;
             const Lit lit = toClear[i];
             assert(lit.var() != noPosLit.var());
 
@@ -3150,9 +3708,9 @@ bool Simplifier::merge(
                 && !qs.isBinary()
                 && solver->conf.doCache
             ) {
-                const vector<LitExtra>& cache = solver->implCache[lit.toInt()].lits;
-                numMaxVarElimAgressiveCheck -= cache.size()/3;
-                for(vector<LitExtra>::const_iterator
+                const LitExtraVec& cache = solver->implCache[lit.toInt()].lits;
+                work.aggressiveLimit -= cache.size()/3;
+                for(LitExtraVec::const_iterator
                     it = cache.begin(), end = cache.end()
                     ; it != end
                     ; it++
@@ -3183,7 +3741,7 @@ bool Simplifier::merge(
             /*
             //TODO
             //Use watchlists
-            if (numMaxVarElimAgressiveCheck > 0) {
+            if (work.aggressiveLimit > 0) {
                 if (agressiveCheck(lit, noPosLit, retval))
                     goto end;
             }*/
@@ -3201,8 +3759,8 @@ bool Simplifier::merge(
         //pendency
 
         if (!ps.isBinary() && !qs.isBinary()) {
-            numMaxVarElimAgressiveCheck -= 20;
-            if (solver->stamp.stampBasedClRem(toClear)) {
+            work.aggressiveLimit -= 20;
+            if (solver->stamp.stampBasedClRem(toClear, work.stampNorm, work.stampInv)) {
                 goto end;
             }
         }
@@ -3210,7 +3768,7 @@ bool Simplifier::merge(
 
     end:
     //Clear 'seen'
-    *toDecrease -= toClear.size()/2 + 1;
+    work.limit -= toClear.size()/2 + 1;
     for (vector<Lit>::const_iterator
         it = toClear.begin(), end = toClear.end()
         ; it != end
@@ -3302,6 +3860,7 @@ bool Simplifier::agressiveCheck(
 
 Simplifier::HeuristicData Simplifier::calcDataForHeuristic(
     const Lit lit
+    , int64_t& limit
     , bool setit
     , bool countIt
     , unsigned otherSize
@@ -3314,7 +3873,7 @@ Simplifier::HeuristicData Simplifier::calcDataForHeuristic(
     size_t count = 0;
 
     const vec<Watched>& ws = solver->watches[lit.toInt()];
-    *toDecrease -= ws.size() + 100;
+    limit -= ws.size() + 100;
     for (vec<Watched>::const_iterator
         it = ws.begin(), end = ws.end()
         ; it != end
@@ -3437,6 +3996,7 @@ pair<int, int> Simplifier::heuristicCalcVarElimScore(const Var var)
     #if 0
     const HeuristicData pos = calcDataForHeuristic(
         lit
+        , *toDecrease
         , true
     );
 
@@ -3445,6 +4005,7 @@ pair<int, int> Simplifier::heuristicCalcVarElimScore(const Var var)
     bool countIt = ((pos.bin + pos.tri + pos.longer) <= sizeof(unsigned char)*8);
     const HeuristicData neg = calcDataForHeuristic(
         ~lit
+        , *toDecrease
         , false
         , countIt
         , pos.bin + pos.tri + pos.longer
@@ -3453,6 +4014,7 @@ pair<int, int> Simplifier::heuristicCalcVarElimScore(const Var var)
     //Clear the 'seen' array
     calcDataForHeuristic(
         lit
+        , *toDecrease
         , false
         , false
         , 0
@@ -3466,8 +4028,8 @@ pair<int, int> Simplifier::heuristicCalcVarElimScore(const Var var)
         return std::make_pair(neg.count, 0);
     }
     #else
-    const HeuristicData pos = calcDataForHeuristic(lit);
-    const HeuristicData neg = calcDataForHeuristic(~lit);
+    const HeuristicData pos = calcDataForHeuristic(lit, *toDecrease);
+    const HeuristicData neg = calcDataForHeuristic(~lit, *toDecrease);
     #endif
 
     //Estimate cost
@@ -3515,14 +4077,35 @@ pair<int, int> Simplifier::heuristicCalcVarElimScore(const Var var)
     return std::make_pair(normCost, litCost);
 }
 
+void Simplifier::invalidateTouchedScores()
+{
+    for(vector<Var>::const_iterator
+        it = solver->irredTouched.getTouchedList().begin()
+        , end = solver->irredTouched.getTouchedList().end()
+        ; it != end
+        ; it++
+    ) {
+        if (*it < varElimScoreValid.size())
+            varElimScoreValid[*it] = false;
+    }
+    solver->irredTouched.clear();
+}
+
 void Simplifier::orderVarsForElimInit()
 {
     varElimOrder.clear();
-    varElimComplexity.clear();
+    if (!solver->conf.incVarElimScore) {
+        varElimScoreValid.clear();
+    }
     varElimComplexity.resize(
         solver->nVars()
         , std::make_pair<int, int>(1000, 1000)
     );
+    varElimScoreValid.resize(solver->nVars(), false);
+
+    //Scores are kept between the rounds, only re-calculate them for the
+    //vars whose irreducible clauses have changed since
+    invalidateTouchedScores();
 
     //Go through all vars
     for (
@@ -3530,18 +4113,24 @@ void Simplifier::orderVarsForElimInit()
         ; var < solver->nVars() && *toDecrease > 0
         ; var++
     ) {
-        *toDecrease -= 50;
-
         //Can this variable be eliminated at all?
         if (solver->value(var) != l_Undef
             || solver->varData[var].removed != Removed::none
+            || inXor[var]
             //|| !gateFinder->canElim(var)
         ) {
             continue;
         }
 
         assert(!varElimOrder.inHeap(var));
-        varElimComplexity[var] = strategyCalcVarElimScore(var);;
+        if (varElimScoreValid[var]) {
+            *toDecrease -= 5;
+            runStats.varElimScoreKept++;
+        } else {
+            *toDecrease -= 50;
+            varElimComplexity[var] = strategyCalcVarElimScore(var);
+            varElimScoreValid[var] = true;
+        }
         varElimOrder.insert(var);
     }
     assert(varElimOrder.heapProperty());
@@ -3575,8 +4164,37 @@ std::pair<int, int> Simplifier::strategyCalcVarElimScore(const Var var)
     return cost;
 }
 
+/**
+@brief The XOR constraints are not in the occurrence lists
+
+Their vars are marked, so that no clause is removed that could be needed for
+them to be satisfied when the solution is extended
+*/
+void Simplifier::markXorVars()
+{
+    inXor.clear();
+    inXor.resize(solver->nVars(), 0);
+    for(vector<Xor>::const_iterator
+        it = solver->xors.begin(), end = solver->xors.end()
+        ; it != end
+        ; it++
+    ) {
+        for(vector<Var>::const_iterator
+            it2 = it->vars.begin(), end2 = it->vars.end()
+            ; it2 != end2
+            ; it2++
+        ) {
+            inXor[*it2] = 1;
+        }
+    }
+}
+
 inline bool Simplifier::allTautologySlim(const Lit lit)
 {
+    //Flipping it when extending the solution could falsify an XOR
+    if (inXor[lit.var()])
+        return false;
+
     //clauses which contain '~lit'
     const vec<Watched>& ws = solver->watches[(~lit).toInt()];
     for (vec<Watched>::const_iterator
@@ -3701,6 +4319,7 @@ uint64_t Simplifier::memUsed() const
     b += varElimOrder.memUsed();
     b += varElimComplexity.capacity()*sizeof(int)*2;
     b += touched.memUsed();
+    b += varElimScoreValid.capacity()*sizeof(char);
     b += clauses.capacity()*sizeof(ClOffset);
 
     return b;
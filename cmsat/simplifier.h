@@ -53,6 +53,7 @@ class ClauseCleaner;
 class SolutionExtender;
 class Solver;
 class GateFinder;
+class BVA;
 class XorFinderAbst;
 
 struct BlockedClause {
@@ -97,6 +98,11 @@ public:
         , const vector<uint32_t>& interToOuter
     );
     bool unEliminate(const Var var);
+
+    //Also used by the BgSimplifier
+    template<class T1, class T2>
+    static bool subset(const T1& A, const T2& B, int64_t& limit);
+    static bool subsetAbst(const CL_ABST_TYPE A, const CL_ABST_TYPE B);
     uint64_t memUsed() const;
     uint64_t memUsedXor() const;
 
@@ -132,6 +138,8 @@ public:
             , subsumedByStr(0)
             , subsumedByVE(0)
             , litsRemStrengthen(0)
+            , sigChecked(0)
+            , sigFiltered(0)
 
             //Elimination
             , numVarsElimed(0)
@@ -148,6 +156,7 @@ public:
             , triedToElimVars(0)
             , usedAgressiveCheckToELim(0)
             , newClauses(0)
+            , varElimScoreKept(0)
 
             , zeroDepthAssings(0)
         {
@@ -193,6 +202,8 @@ public:
             subsumedByStr += other.subsumedByStr;
             subsumedByVE  += other.subsumedByVE;
             litsRemStrengthen += other.litsRemStrengthen;
+            sigChecked += other.sigChecked;
+            sigFiltered += other.sigFiltered;
 
             //Elim
             numVarsElimed += other.numVarsElimed;
@@ -209,6 +220,7 @@ public:
             triedToElimVars += other.triedToElimVars;
             usedAgressiveCheckToELim += other.usedAgressiveCheckToELim;
             newClauses += other.newClauses;
+            varElimScoreKept += other.varElimScoreKept;
 
             zeroDepthAssings += other.zeroDepthAssings;
 
@@ -313,10 +325,20 @@ public:
                 , litsRemStrengthen
             );
 
+            printStatsLine("c abst2 filtered"
+                , sigFiltered
+                , (double)sigFiltered/(double)sigChecked*100.0
+                , "% of abst matches"
+            );
+
             printStatsLine("c cl-new"
                 , newClauses
             );
 
+            printStatsLine("c elim scores kept"
+                , varElimScoreKept
+            );
+
             printStatsLine("c tried to elim"
                 , triedToElimVars
                 , (double)usedAgressiveCheckToELim/(double)triedToElimVars*100.0
@@ -392,6 +414,8 @@ public:
         uint64_t subsumedByStr;
         uint64_t subsumedByVE;
         uint64_t litsRemStrengthen;
+        uint64_t sigChecked; ///<Passed the abstraction in the occur list, clause looked at
+        uint64_t sigFiltered; ///<Of these, thrown out by the second abstraction
 
         //Stats for var-elim
         int64_t numVarsElimed;
@@ -408,6 +432,7 @@ public:
         uint64_t triedToElimVars;
         uint64_t usedAgressiveCheckToELim;
         uint64_t newClauses;
+        uint64_t varElimScoreKept; ///<Elimination score kept from the previous round
 
         //General stat
         uint64_t zeroDepthAssings;
@@ -417,6 +442,7 @@ public:
     uint32_t getNumERVars() const;
     const vector<BlockedClause>& getBlockedClauses() const;
     const GateFinder* getGateFinder() const;
+    const BVA* getBVA() const;
     const Stats& getStats() const;
     void checkElimedUnassignedAndStats() const;
     void checkElimedUnassigned() const;
@@ -430,6 +456,7 @@ private:
 
     void finishUp(size_t origTrailSize);
     vector<ClOffset> clauses;
+    vector<uint32_t> occurCount; ///<Occurrences of each literal in the clauses being linked in
     bool subsumeWithBinaries();
 
     //Persistent data
@@ -456,6 +483,7 @@ private:
     int64_t  numMaxBlocked;
     int64_t  numMaxBlockedImpl;
     int64_t  numMaxVarElimAgressiveCheck;
+    int64_t  numMaxBVA;
     int64_t* toDecrease;
 
     //Propagation&handling of stuff
@@ -468,9 +496,13 @@ private:
         , bool irred
         , uint64_t& numLitsAdded
     );
+    uint64_t occurMemUsageMB(const vector<ClOffset>& toAdd) const;
+    bool shouldLinkIn(const Clause& cl, bool irred, uint64_t linkedInLits) const;
+    void reserveOccur(const vector<ClOffset>& toAdd, bool irred);
     void setLimits();
     void performSubsumption();
     bool performStrengthening();
+    bool performParallelSubsumption();
 
     //Finish-up
     void addBackToSolver();
@@ -502,6 +534,8 @@ private:
         , const CL_ABST_TYPE abs
         , vector<ClOffset>& out_subsumed
         , vector<Lit>& out_lits
+        , int64_t& limit
+        , Stats& stats
     );
 
     template<class T>
@@ -509,18 +543,18 @@ private:
         const ClOffset offset
         , const T& ps
         , CL_ABST_TYPE abs
+        , CL_ABST_TYPE abs2
         , vector<ClOffset>& out_subsumed
         , vector<Lit>& out_lits
         , const Lit lit
+        , int64_t& limit
+        , Stats& stats
     );
 
-    template<class T1, class T2>
-    bool subset(const T1& A, const T2& B);
     bool subsetReverse(const Clause& B) const;
 
     template<class T1, class T2>
-    Lit subset1(const T1& A, const T2& B);
-    bool subsetAbst(const CL_ABST_TYPE A, const CL_ABST_TYPE B);
+    Lit subset1(const T1& A, const T2& B, int64_t& limit);
 
     struct WatchSorter {
         bool operator()(const Watched& first, const Watched& second)
@@ -600,6 +634,35 @@ private:
         size_t str;
     };
     Sub1Ret subsume1(ClOffset offset);
+    void subsume1With(
+        const ClOffset offset
+        , const ClOffset offset2
+        , const Lit litSub
+        , Sub1Ret& ret
+    );
+
+    /////////////////////
+    //Parallel subsume1: find candidates on threads, apply serially
+
+    ///Clause "subsumer" subsumes "subsumed" if lit is lit_Undef, otherwise strengthens it by removing lit
+    struct Sub1Cand {
+        Sub1Cand(const ClOffset _subsumer, const ClOffset _subsumed, const Lit _lit) :
+            subsumer(_subsumer)
+            , subsumed(_subsumed)
+            , lit(_lit)
+        {}
+
+        ClOffset subsumer;
+        ClOffset subsumed;
+        Lit lit;
+    };
+    void findSub1Cands(
+        const size_t start
+        , const size_t end
+        , int64_t limit
+        , vector<Sub1Cand>* out
+        , Stats* stats
+    );
 
     /////////////////////
     //Variable elimination
@@ -625,16 +688,65 @@ private:
         {}
     };
     void        orderVarsForElimInit();
+    void        markXorVars();
+    vector<char> inXor; ///<Vars of XOR constraints are neither eliminated nor blocked on
+    void        invalidateTouchedScores();
     Heap<VarOrderLt> varElimOrder;
+    vector<char> varElimScoreValid; ///<varElimComplexity is up-to-date unless solver->irredTouched says otherwise
     uint32_t    numNonLearntBins(const Lit lit) const;
     //void        addLearntBinaries(const Var var);
     void        removeClausesHelper(const vec<Watched>& todo, const Lit lit);
 
 
     TouchList   touched;
+    typedef vector<pair<vector<Lit>, ClauseStats> > Resolvents;
     bool        maybeEliminate(const Var x);
+    bool        eliminate(const Var var, const Resolvents& resolvents);
+
+    ///Scratch space and time limits of testVarElim(), one per thread
+    struct ElimWork {
+        ElimWork() :
+            limit(0)
+            , aggressiveLimit(0)
+            , usedAgressive(0)
+        {}
+
+        vector<unsigned char> seen;
+        vector<Lit> dummy; ///<The resolvent being built by merge()
+        vector<Lit> toClear;
+        vector<Lit> stampNorm;
+        vector<Lit> stampInv;
+        Resolvents resolvents;
+        int64_t limit;
+        int64_t aggressiveLimit;
+        uint64_t usedAgressive;
+    };
+    ElimWork    elimWork; ///<Of the serial elimination
     int         testVarElim(Var var);
-    vector<pair<vector<Lit>, ClauseStats> > resolvents;
+    int         testVarElim(const Var var, ElimWork& work);
+
+    //Parallel elimination
+    struct ElimResult {
+        ElimResult() :
+            cost(0)
+            , numPos(0)
+            , numNeg(0)
+        {}
+
+        int cost; ///<As returned by testVarElim()
+        size_t numPos; ///<Occurrence list sizes, to see if they have changed since
+        size_t numNeg;
+        Resolvents resolvents;
+    };
+    void        eliminateVarsParallel(size_t& vars_elimed, size_t& wenThrough);
+    void        findResolvents(
+        const vector<Var>* batch
+        , const size_t first
+        , const size_t step
+        , ElimWork* work
+        , vector<ElimResult>* results
+    );
+    void        markElimNeighbours(const Var var, vector<unsigned char>& varMark, vector<Var>& marked);
 
     struct HeuristicData
     {
@@ -659,6 +771,7 @@ private:
     };
     HeuristicData calcDataForHeuristic(
         const Lit lit
+        , int64_t& limit
         , bool setit = false
         , bool countIt = false
         , unsigned otherSize = 0
@@ -672,6 +785,7 @@ private:
         , const Watched& qs
         , const Lit noPosLit
         , const bool useCache
+        , ElimWork& work
     );
     bool agressiveCheck(
         const Lit lit
@@ -704,6 +818,11 @@ private:
     friend class GateFinder;
     GateFinder *gateFinder;
 
+    /////////////////////
+    //Bounded variable addition
+    friend class BVA;
+    BVA *bva;
+
     //validity checking
     void checkForElimedVars();
     void printOccur(const Lit lit) const;
@@ -729,9 +848,11 @@ inline bool Simplifier::subsetAbst(const CL_ABST_TYPE A, const CL_ABST_TYPE B)
     return ((A & ~B) == 0);
 }
 
-//A subsumes B (A <= B)
+/**
+@brief A subsumes B (A <= B). Both must be sorted
+*/
 template<class T1, class T2>
-bool Simplifier::subset(const T1& A, const T2& B)
+bool Simplifier::subset(const T1& A, const T2& B, int64_t& limit)
 {
     #ifdef MORE_DEUBUG
     cout << "A:" << A << endl;
@@ -772,7 +893,7 @@ bool Simplifier::subset(const T1& A, const T2& B)
     ret = false;
 
     end:
-    *toDecrease -= i2*4 + i*4;
+    limit -= i2*4 + i*4;
     return ret;
 }
 
@@ -798,7 +919,7 @@ clause B
 and returns the literal to remove if (2) is true
 */
 template<class T1, class T2>
-Lit Simplifier::subset1(const T1& A, const T2& B)
+Lit Simplifier::subset1(const T1& A, const T2& B, int64_t& limit)
 {
     Lit retLit = lit_Undef;
 
@@ -830,7 +951,7 @@ Lit Simplifier::subset1(const T1& A, const T2& B)
     retLit = lit_Error;
 
     end:
-    *toDecrease -= i2*4 + i*4;
+    limit -= i2*4 + i*4;
     return retLit;
 }
 
@@ -849,6 +970,11 @@ inline const Simplifier::Stats& Simplifier::getStats() const
     return globalStats;
 }
 
+inline const BVA* Simplifier::getBVA() const
+{
+    return bva;
+}
+
 /**
 @brief Finds clauses that are backward-subsumed by given clause
 
@@ -884,6 +1010,7 @@ template<class T> void Simplifier::findSubsumed0(
     //Go through the occur list of the literal that has the smallest occur list
     vec<Watched>& occ = solver->watches[ps[min_i].toInt()];
     *toDecrease -= occ.size()*8 + 40;
+    const CL_ABST_TYPE abs2 = calcAbstraction2(ps);
 
     vec<Watched>::iterator it = occ.begin();
     vec<Watched>::iterator it2 = occ.begin();
@@ -910,6 +1037,8 @@ template<class T> void Simplifier::findSubsumed0(
                     removeWBin(solver->watches, it->lit1(), ps[min_i], it->learnt());
                     solver->binTri.irredBins--;
                     solver->binTri.irredLits-=2;
+                    solver->touchIrred(ps[0]);
+                    solver->touchIrred(ps[1]);
                     continue;
                 }
             }
@@ -935,6 +1064,9 @@ template<class T> void Simplifier::findSubsumed0(
                 } else {
                     solver->binTri.irredTris--;
                     solver->binTri.irredLits-=3;
+                    for(size_t i = 0; i < 3; i++) {
+                        solver->touchIrred(lits[i]);
+                    }
                 }
                 continue;
             }
@@ -959,8 +1091,14 @@ template<class T> void Simplifier::findSubsumed0(
         if (ps.size() > cl2.size())
             continue;
 
+        runStats.sigChecked++;
+        if (!subsetAbst(abs2, cl2.abst2)) {
+            runStats.sigFiltered++;
+            continue;
+        }
+
         *toDecrease -= 50;
-        if (subset(ps, cl2)) {
+        if (subset(ps, cl2, *toDecrease)) {
             out_subsumed.push_back(it->getOffset());
             #ifdef VERBOSE_DEBUG
             cout << "subsumed cl offset: " << it->getOffset() << endl;
@@ -0,0 +1,327 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos and collaborators. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+
+#include "sls.h"
+#include "solver.h"
+#include "time_mem.h"
+
+using namespace CMSat;
+using std::cout;
+using std::endl;
+
+SLS::SLS(Solver* _solver) :
+    solver(_solver)
+    , mtrand(_solver->conf.origSeed)
+    , work(0)
+{}
+
+/**
+@brief Walks from the saved polarities, and writes the best assignment found back
+
+The walk stops when all clauses are satisfied, or when conf.slsWorkLimit
+literal-visits have been made.
+*/
+bool SLS::run()
+{
+    assert(solver->ok);
+    assert(solver->decisionLevel() == 0);
+    const double myTime = cpuTime();
+    runStats.clear();
+    runStats.numCalls = 1;
+    work = 0;
+
+    addClauses();
+    initAssignment();
+
+    size_t best = unsat.size();
+    flipsSinceBest.clear();
+    while (!unsat.empty()
+        && work < solver->conf.slsWorkLimit
+    ) {
+        const uint32_t clNum = unsat[mtrand.randInt(unsat.size()-1)];
+        const Var var = pickFlipVar(clNum);
+        flip(var);
+        runStats.numFlips++;
+
+        flipsSinceBest.push_back(var);
+        if (unsat.size() < best) {
+            best = unsat.size();
+            flipsSinceBest.clear();
+        }
+    }
+
+    //Go back to the best assignment
+    for(vector<Var>::const_iterator
+        it = flipsSinceBest.begin(), end = flipsSinceBest.end()
+        ; it != end
+        ; it++
+    ) {
+        value[*it] ^= 1;
+    }
+
+    //Vars not in any clause keep their polarities
+    for(size_t var = 0; var < value.size(); var++) {
+        if (used[var])
+            solver->varData[var].polarity = value[var];
+    }
+
+    runStats.sumBestUnsat = best;
+    runStats.sumClauses = numTrue.size();
+    runStats.numModels = (best == 0);
+    runStats.cpu_time = cpuTime() - myTime;
+    if (solver->conf.verbosity >= 2) {
+        runStats.printShort();
+    }
+    globalStats += runStats;
+    freeMem();
+
+    return best == 0;
+}
+
+void SLS::addClause(const Lit* begin, const Lit* end)
+{
+    const size_t start = lits.size();
+    for(const Lit* l = begin; l != end; l++) {
+        const lbool val = solver->value(*l);
+        if (val == l_True) {
+            lits.resize(start);
+            return;
+        }
+
+        if (val == l_Undef)
+            lits.push_back(*l);
+    }
+    work += end - begin;
+
+    //All false at level 0 is not possible, the solver would be UNSAT
+    assert(lits.size() > start);
+
+    const uint32_t clNum = numTrue.size();
+    for(size_t i = start; i < lits.size(); i++) {
+        occur[lits[i].toInt()].push_back(clNum);
+        used[lits[i].var()] = 1;
+    }
+    clStart.push_back(lits.size());
+    numTrue.push_back(0);
+}
+
+void SLS::addClauses()
+{
+    lits.clear();
+    clStart.clear();
+    clStart.push_back(0);
+    numTrue.clear();
+    occur.clear();
+    occur.resize(solver->nVars()*2);
+    used.clear();
+    used.resize(solver->nVars(), 0);
+
+    //Long irredundant clauses
+    for(vector<ClOffset>::const_iterator
+        it = solver->longIrredCls.begin(), end = solver->longIrredCls.end()
+        ; it != end
+        ; it++
+    ) {
+        const Clause& cl = *solver->clAllocator->getPointer(*it);
+        addClause(cl.begin(), cl.end());
+    }
+
+    //Implicit irredundant clauses, each only once: from the smallest literal
+    Lit tmp[3];
+    for(size_t wsLit = 0; wsLit < solver->nVars()*2; wsLit++) {
+        const Lit lit = Lit::toLit(wsLit);
+        const vec<Watched>& ws = solver->watches[wsLit];
+        for(vec<Watched>::const_iterator
+            it = ws.begin(), end = ws.end()
+            ; it != end
+            ; it++
+        ) {
+            if (it->isBinary()
+                && !it->learnt()
+                && lit < it->lit1()
+            ) {
+                tmp[0] = lit;
+                tmp[1] = it->lit1();
+                addClause(tmp, tmp + 2);
+            }
+
+            if (it->isTri()
+                && !it->learnt()
+                && lit < it->lit1()
+                && lit < it->lit2()
+            ) {
+                tmp[0] = lit;
+                tmp[1] = it->lit1();
+                tmp[2] = it->lit2();
+                addClause(tmp, tmp + 3);
+            }
+        }
+    }
+
+    //At-most-one constraints attached for the search, in their pairwise form
+    for(vector<vector<Lit> >::const_iterator
+        it = solver->cards.begin(), end = solver->cards.end()
+        ; it != end
+        ; it++
+    ) {
+        const vector<Lit>& card = *it;
+        for(size_t i = 0; i < card.size(); i++) {
+            for(size_t i2 = i+1; i2 < card.size(); i2++) {
+                tmp[0] = ~card[i];
+                tmp[1] = ~card[i2];
+                addClause(tmp, tmp + 2);
+            }
+        }
+    }
+
+    //Break count weighting of ProbSAT (exponential), by the avg. clause size
+    const double avgSize = numTrue.empty() ? 0 : (double)lits.size()/(double)numTrue.size();
+    double cb;
+    if (avgSize <= 3.5) cb = 2.5;
+    else if (avgSize <= 5.5) cb = 3.7;
+    else cb = 5.4;
+
+    breakProb.resize(64);
+    for(size_t i = 0; i < breakProb.size(); i++) {
+        breakProb[i] = std::pow(cb, -(double)i);
+    }
+}
+
+void SLS::initAssignment()
+{
+    value.resize(solver->nVars());
+    for(size_t var = 0; var < value.size(); var++) {
+        value[var] = solver->varData[var].polarity;
+    }
+
+    unsat.clear();
+    whereUnsat.resize(numTrue.size());
+    for(uint32_t clNum = 0; clNum < numTrue.size(); clNum++) {
+        uint32_t num = 0;
+        for(uint32_t i = clStart[clNum]; i < clStart[clNum+1]; i++) {
+            num += isTrue(lits[i]);
+        }
+        numTrue[clNum] = num;
+        if (num == 0)
+            makeUnsat(clNum);
+    }
+    work += lits.size();
+}
+
+Var SLS::pickFlipVar(const uint32_t clNum)
+{
+    probs.clear();
+    double sum = 0;
+    for(uint32_t i = clStart[clNum]; i < clStart[clNum+1]; i++) {
+        const uint32_t brk = breakCount(lits[i].var());
+        const double prob = breakProb[std::min<size_t>(brk, breakProb.size()-1)];
+        probs.push_back(prob);
+        sum += prob;
+    }
+
+    double rnd = mtrand.randDblExc()*sum;
+    for(uint32_t i = clStart[clNum]; i < clStart[clNum+1]; i++) {
+        rnd -= probs[i - clStart[clNum]];
+        if (rnd <= 0)
+            return lits[i].var();
+    }
+
+    return lits[clStart[clNum+1]-1].var();
+}
+
+///Number of clauses that would become unsatisfied by flipping 'var'
+uint32_t SLS::breakCount(const Var var)
+{
+    const Lit trueLit = Lit(var, !value[var]);
+    const vector<uint32_t>& occ = occur[trueLit.toInt()];
+    work += occ.size();
+
+    uint32_t brk = 0;
+    for(vector<uint32_t>::const_iterator
+        it = occ.begin(), end = occ.end()
+        ; it != end
+        ; it++
+    ) {
+        brk += (numTrue[*it] == 1);
+    }
+
+    return brk;
+}
+
+void SLS::flip(const Var var)
+{
+    value[var] ^= 1;
+    const Lit trueLit = Lit(var, !value[var]);
+
+    const vector<uint32_t>& madeTrue = occur[trueLit.toInt()];
+    for(vector<uint32_t>::const_iterator
+        it = madeTrue.begin(), end = madeTrue.end()
+        ; it != end
+        ; it++
+    ) {
+        if (++numTrue[*it] == 1)
+            makeSat(*it);
+    }
+
+    const vector<uint32_t>& madeFalse = occur[(~trueLit).toInt()];
+    for(vector<uint32_t>::const_iterator
+        it = madeFalse.begin(), end = madeFalse.end()
+        ; it != end
+        ; it++
+    ) {
+        if (--numTrue[*it] == 0)
+            makeUnsat(*it);
+    }
+    work += madeTrue.size() + madeFalse.size();
+}
+
+void SLS::makeUnsat(const uint32_t clNum)
+{
+    whereUnsat[clNum] = unsat.size();
+    unsat.push_back(clNum);
+}
+
+void SLS::makeSat(const uint32_t clNum)
+{
+    const uint32_t at = whereUnsat[clNum];
+    const uint32_t last = unsat.back();
+    unsat[at] = last;
+    whereUnsat[last] = at;
+    unsat.pop_back();
+}
+
+void SLS::freeMem()
+{
+    vector<Lit>().swap(lits);
+    vector<uint32_t>().swap(clStart);
+    vector<vector<uint32_t> >().swap(occur);
+    vector<uint32_t>().swap(numTrue);
+    vector<uint32_t>().swap(unsat);
+    vector<uint32_t>().swap(whereUnsat);
+    vector<char>().swap(value);
+    vector<char>().swap(used);
+    vector<Var>().swap(flipsSinceBest);
+}
@@ -0,0 +1,185 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos and collaborators. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+
+#ifndef __SLS_H__
+#define __SLS_H__
+
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include "solvertypes.h"
+#include "MersenneTwister.h"
+
+namespace CMSat {
+
+using std::vector;
+
+class Solver;
+
+/**
+@brief ProbSAT-style stochastic local search on the irredundant clauses
+
+Works on a flat copy of the irredundant clauses (long ones and the implicit
+binary and tertiary ones in the watchlists), simplified with the top-level
+assignment. Starts from the saved polarities and writes the best assignment
+found back into them. Must be called at decision level 0.
+*/
+class SLS {
+    public:
+        SLS(Solver* solver);
+
+        ///Returns true if the saved polarities are now a model of the irredundant clauses
+        bool run();
+
+        struct Stats
+        {
+            Stats() :
+                numCalls(0)
+                , cpu_time(0)
+                , numFlips(0)
+                , numModels(0)
+                , sumBestUnsat(0)
+                , sumClauses(0)
+            {}
+
+            void clear()
+            {
+                Stats tmp;
+                *this = tmp;
+            }
+
+            Stats& operator+=(const Stats& other)
+            {
+                numCalls += other.numCalls;
+                cpu_time += other.cpu_time;
+                numFlips += other.numFlips;
+                numModels += other.numModels;
+                sumBestUnsat += other.sumBestUnsat;
+                sumClauses += other.sumClauses;
+
+                return *this;
+            }
+
+            void print() const
+            {
+                cout << "c ----- SLS STATS --------" << endl;
+                printStatsLine("c time"
+                    , cpu_time
+                    , cpu_time/(double)numCalls
+                    , "per call"
+                );
+
+                printStatsLine("c flips"
+                    , numFlips
+                    , (double)numFlips/cpu_time/(1000.0*1000.0)
+                    , "M/s"
+                );
+
+                printStatsLine("c called"
+                    , numCalls
+                    , numModels
+                    , "found model"
+                );
+
+                printStatsLine("c avg best unsat cls"
+                    , (double)sumBestUnsat/(double)numCalls
+                    , (double)sumBestUnsat/(double)sumClauses*100.0
+                    , "% of cls"
+                );
+                cout << "c ----- SLS STATS END --------" << endl;
+            }
+
+            void printShort() const
+            {
+                cout
+                << "c [sls] flips: " << numFlips
+                << " best unsat: " << sumBestUnsat
+                << " of " << sumClauses << " cls"
+                << " model: " << (numModels ? "Y" : "N")
+                << " T: " << std::fixed << std::setprecision(2)
+                << cpu_time << " s"
+                << endl;
+            }
+
+            uint64_t numCalls;
+            double cpu_time;
+            uint64_t numFlips;
+            uint64_t numModels;
+            uint64_t sumBestUnsat; ///<Sum over calls of the fewest unsatisfied clauses reached
+            uint64_t sumClauses;
+        };
+
+        const Stats& getStats() const;
+
+    private:
+        void addClause(const Lit* begin, const Lit* end);
+        void addClauses();
+        void initAssignment();
+        Var pickFlipVar(const uint32_t clNum);
+        uint32_t breakCount(const Var var);
+        void flip(const Var var);
+        void makeUnsat(const uint32_t clNum);
+        void makeSat(const uint32_t clNum);
+        void freeMem();
+
+        bool isTrue(const Lit lit) const
+        {
+            return value[lit.var()] != lit.sign();
+        }
+
+        Solver* solver;
+        MTRand mtrand;
+
+        //Clauses, in a flat array
+        vector<Lit> lits;
+        vector<uint32_t> clStart; ///<Clause N is lits[clStart[N]..clStart[N+1])
+        vector<vector<uint32_t> > occur; ///<Clauses a literal is in
+        vector<uint32_t> numTrue; ///<Number of true literals in the clause
+
+        //Unsatisfied clauses, and where they are in 'unsat'
+        vector<uint32_t> unsat;
+        vector<uint32_t> whereUnsat;
+
+        //Assignment
+        vector<char> value;
+        vector<char> used; ///<Var is in some clause
+        vector<Var> flipsSinceBest; ///<To get back to the best assignment
+
+        //Probability of picking a literal, by its break count
+        vector<double> breakProb;
+        vector<double> probs;
+
+        uint64_t work;
+
+        //Stats
+        Stats runStats;
+        Stats globalStats;
+};
+
+inline const SLS::Stats& SLS::getStats() const
+{
+    return globalStats;
+}
+
+} //end namespace
+
+#endif //__SLS_H__
@@ -27,14 +27,23 @@
 #include "simplifier.h"
 #include "prober.h"
 #include "clausevivifier.h"
+#include "sls.h"
+#include "inprocsched.h"
+#include "bgsimplifier.h"
 #include "clausecleaner.h"
 #include "solutionextender.h"
 #include "varupdatehelper.h"
 #include "gatefinder.h"
+#include "bva.h"
+#include "cardfinder.h"
+#include "matrixfinder.h"
 #include "sqlstats.h"
 #include <fstream>
 #include <cmath>
 #include <fcntl.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
 #include "completedetachreattacher.h"
 #include "compfinder.h"
 #include "comphandler.h"
@@ -68,15 +77,27 @@ Solver::Solver(const SolverConf& _conf) :
     , clauseCleaner(NULL)
     , varReplacer(NULL)
     , compHandler(NULL)
+    , sls(NULL)
+    , inprocSched(NULL)
+    , bgSimplifier(NULL)
+    , cardFinder(NULL)
+    , matrixFinder(NULL)
     , mtrand(_conf.origSeed)
+    , memShed(MemShed::none)
     , needToInterrupt(false)
 
     //Stuff
     , nextCleanLimit(0)
+    , numLazyFreed(0)
     , numDecisionVars(0)
+    , numBVAVars(0)
     , zeroLevAssignsByCNF(0)
     , zeroLevAssignsByThreads(0)
 {
+    #ifdef DRUP
+    numDrupVarMaps = 0;
+    #endif
+
     if (conf.doSQL) {
         #ifdef USE_MYSQL
         sqlStats = new MySQLStats();
@@ -107,12 +128,32 @@ Solver::Solver(const SolverConf& _conf) :
     if (conf.doCompHandler) {
         compHandler = new CompHandler(this);
     }
+    if (conf.doSLS) {
+        sls = new SLS(this);
+    }
+    inprocSched = new InprocSched(this);
+    if (conf.doBgSimp) {
+        bgSimplifier = new BgSimplifier(this);
+    }
+    cardFinder = new CardFinder(this);
+    matrixFinder = new MatrixFinder(this);
     Searcher::solver = this;
 }
 
 Solver::~Solver()
 {
+    #ifdef DRUP
+    for(size_t i = 0; i < numDrupVarMaps; i++) {
+        drup->popVarMap();
+    }
+    #endif
+
+    delete bgSimplifier;
+    delete cardFinder;
+    delete matrixFinder;
     delete compHandler;
+    delete sls;
+    delete inprocSched;
     delete sqlStats;
     delete prober;
     delete simplifier;
@@ -123,14 +164,41 @@ Solver::~Solver()
     delete clAllocator;
 }
 
+#ifdef DRUP
+void Solver::setDrup(DrupWriter* _drup, const vector<Var>* toParent)
+{
+    assert(drup == NULL);
+    drup = _drup;
+    if (drup == NULL)
+        return;
+
+    if (toParent) {
+        drup->pushVarMap(toParent);
+        numDrupVarMaps++;
+    }
+    drup->pushVarMap(&interToOuterMain);
+    numDrupVarMaps++;
+}
+#endif
+
 bool Solver::addXorClause(const vector<Var>& vars, bool rhs)
 {
+    if (conf.doSimplify && simplifier->getAnythingHasBeenBlocked()) {
+        cout
+        << "ERROR: Cannot add new clauses to the system if blocking was"
+        << " enabled. Turn it off from conf.doBlockClauses"
+        << " (note: current state of blocking enabled: "
+        << conf.doBlockClauses << " )"
+        << endl;
+        exit(-1);
+    }
+
     vector<Lit> ps(vars.size());
     for(size_t i = 0; i < vars.size(); i++) {
         ps[i] = Lit(vars[i], false);
     }
 
-    if (!addClauseHelper(ps))
+    if (!addClauseHelper(ps, true))
         return false;
 
     if (!addXorClauseInt(ps, rhs, true))
@@ -139,6 +207,13 @@ bool Solver::addXorClause(const vector<Var>& vars, bool rhs)
     return okay();
 }
 
+/**
+@brief Adds an XOR constraint. Should ONLY be called internally
+
+Signs of the literals only flip 'rhs'. Up to 2 long, it is added as clauses,
+longer ones are stored in 'xors', to be attached for the search. When a DRUP
+proof is written, longer ones are added as clauses when solving starts
+*/
 bool Solver::addXorClauseInt(
     const vector< Lit >& lits
     , bool rhs
@@ -147,39 +222,36 @@ bool Solver::addXorClauseInt(
     assert(ok);
     assert(!attach || qhead == trail.size());
     assert(decisionLevel() == 0);
+    assert(!xorsAttached);
 
     vector<Lit> ps(lits);
+    for(vector<Lit>::iterator
+        it = ps.begin(), end = ps.end()
+        ; it != end
+        ; it++
+    ) {
+        if (it->sign()) {
+            rhs ^= true;
+            *it = it->unsign();
+        }
+    }
     std::sort(ps.begin(), ps.end());
+
     Lit p;
     uint32_t i, j;
     for (i = j = 0, p = lit_Undef; i != ps.size(); i++) {
-        assert(!ps[i].sign()); //Every literal has to be unsigned
-
-        if (ps[i].var() == p.var()) {
+        if (value(ps[i]) != l_Undef) {
+            //modify rhs instead of adding
+            rhs ^= value(ps[i]).getBool();
+        } else if (ps[i] == p) {
             //added, but easily removed
             j--;
             p = lit_Undef;
-
-            //Flip rhs if neccessary
-            if (value(ps[i]) != l_Undef) {
-                rhs ^= value(ps[i]).getBool();
-            }
-
-        } else if (value(ps[i]) == l_Undef) {
-            //If signed, unsign it and flip rhs
-            if (ps[i].sign()) {
-                rhs ^= true;
-                ps[i] = ps[i].unsign();
-            }
-
+        } else {
             //Add and remember as last one to have been added
             ps[j++] = p = ps[i];
 
             assert(!conf.doSimplify || !simplifier->getVarElimed(p.var()));
-        } else {
-            //modify rhs instead of adding
-            assert(value(ps[i]) != l_Undef);
-            rhs ^= value(ps[i]).getBool();
         }
     }
     ps.resize(ps.size() - (i - j));
@@ -196,7 +268,7 @@ bool Solver::addXorClauseInt(
                 #ifdef DRUP
                 if (drup) {
                     *drup
-                    << "0\n";
+                    << DrupFlag::fin;
                 }
                 #endif
 
@@ -210,7 +282,7 @@ bool Solver::addXorClauseInt(
             #ifdef DRUP
             if (drup) {
                 *drup
-                << lit << " 0\n";
+                << lit << DrupFlag::fin;
             }
             #endif
 
@@ -234,13 +306,231 @@ bool Solver::addXorClauseInt(
             break;
 
         default:
-            assert(false && "larger than 2-long XORs are not supported yet");
+            #ifdef DRUP
+            if (drup) {
+                xorsToCut.push_back(Xor(ps, rhs));
+                break;
+            }
+            #endif
+            xors.push_back(Xor(ps, rhs));
             break;
     }
 
     return ok;
 }
 
+#ifdef DRUP
+/**
+@brief Adds the XORs longer than 2 given since the last solve() as clauses
+
+They are cut only now, so the new variables come after the variables of the
+problem we got, in the proof, too
+*/
+void Solver::cutXors()
+{
+    vector<Lit> lits;
+    for(vector<Xor>::const_iterator
+        it = xorsToCut.begin(), end = xorsToCut.end()
+        ; ok && it != end
+        ; it++
+    ) {
+        lits.clear();
+        for(vector<Var>::const_iterator
+            it2 = it->vars.begin(), end2 = it->vars.end()
+            ; it2 != end2
+            ; it2++
+        ) {
+            lits.push_back(Lit(*it2, false));
+        }
+        addXorAsClauses(lits, it->rhs, true);
+    }
+    xorsToCut.clear();
+}
+
+/**
+@brief Adds an XOR longer than 2 as clauses, since the proof cannot express it
+
+It is cut into pieces of at most 4 variables, linked by new variables that are
+not part of the user's numbering, and every piece is expanded to its 2^(n-1)
+clauses. A new variable is the first literal of the clauses defining it, and
+those where it is negated go first, so they are RAT on it
+*/
+void Solver::addXorAsClauses(vector<Lit> ps, const bool rhs, const bool attach)
+{
+    vector<Lit> piece;
+    vector<Lit> lits;
+    while(ok && !ps.empty()) {
+        bool pieceRhs = rhs;
+        piece.clear();
+        if (ps.size() > 4) {
+            //newLit = XOR of the last 3, and it replaces them
+            const Lit newLit = Lit(newVarInt(), false);
+            piece.push_back(newLit);
+            piece.insert(piece.end(), ps.end() - 3, ps.end());
+            ps.resize(ps.size() - 3);
+            ps.push_back(newLit);
+            pieceRhs = false;
+        } else {
+            piece.swap(ps);
+        }
+
+        //Every clause forbids one assignment of the wrong parity. Bit
+        //'size-1-i' of the mask is the value of piece[i] it forbids
+        const uint32_t size = piece.size();
+        for(uint32_t mask = 1U << size; mask-- > 0;) {
+            if ((bool)(__builtin_popcount(mask) & 1) == pieceRhs)
+                continue;
+
+            lits.clear();
+            for(uint32_t i = 0; i < size; i++) {
+                lits.push_back(piece[i] ^ (bool)((mask >> (size-1-i)) & 1));
+            }
+
+            //Logged as-is too, since addClauseInt() sorts the literals
+            *drup << lits << DrupFlag::fin;
+            Clause* cl = addClauseInt(lits, false, ClauseStats(), attach);
+            if (cl != NULL) {
+                longIrredCls.push_back(clAllocator->getOffset(cl));
+            }
+            if (!ok)
+                return;
+        }
+    }
+}
+#endif
+
+/**
+@brief Puts the XOR constraints into the watchlists for the search
+
+Both literals of vars[0] and vars[1] watch each. They must be unset, so the
+constraints are cleaned first. Those put in a Gauss-Jordan matrix are not
+watched one by one.
+*/
+bool Solver::attachXors()
+{
+    assert(!xorsAttached);
+    if (!cleanXors()
+        || !matrixFinder->findMatrixes()
+    ) {
+        return false;
+    }
+
+    for(size_t i = 0; i < xors.size(); i++) {
+        if (matrixFinder->isInMatrix(i))
+            continue;
+
+        const Xor& x = xors[i];
+        for(size_t k = 0; k < 2; k++) {
+            assert(value(x.vars[k]) == l_Undef);
+            watches[Lit(x.vars[k], false).toInt()].push(Watched(i, watch_xor_t));
+            watches[Lit(x.vars[k], true).toInt()].push(Watched(i, watch_xor_t));
+        }
+    }
+    xorsAttached = true;
+
+    //Building the matrices may have set variables
+    if (qhead < trail.size())
+        ok = propagate().isNULL();
+
+    return ok;
+}
+
+void Solver::detachXors()
+{
+    if (!xorsAttached)
+        return;
+
+    assert(decisionLevel() == 0);
+    matrixFinder->clearMatrixes();
+    toClear.clear();
+    for(vector<Xor>::const_iterator
+        it = xors.begin(), end = xors.end()
+        ; it != end
+        ; it++
+    ) {
+        for(size_t k = 0; k < 2; k++) {
+            //Each watchlist is only cleaned once
+            if (seen[Lit(it->vars[k], false).toInt()])
+                continue;
+            seen[Lit(it->vars[k], false).toInt()] = 1;
+            toClear.push_back(Lit(it->vars[k], false));
+
+            for(size_t sign = 0; sign < 2; sign++) {
+                vec<Watched>& ws = watches[Lit(it->vars[k], sign).toInt()];
+                vec<Watched>::iterator i = ws.begin();
+                vec<Watched>::iterator j = i;
+                for (vec<Watched>::iterator end2 = ws.end(); i != end2; i++) {
+                    if (!i->isXor())
+                        *j++ = *i;
+                }
+                ws.shrink_(i-j);
+            }
+        }
+    }
+    for(vector<Lit>::const_iterator
+        it = toClear.begin(), end = toClear.end()
+        ; it != end
+        ; it++
+    ) {
+        seen[it->toInt()] = 0;
+    }
+    toClear.clear();
+
+    //The constraints may be renumbered by cleanXors(), and the matrices are gone
+    for(vector<Lit>::const_iterator
+        it = trail.begin(), end = trail.end()
+        ; it != end
+        ; it++
+    ) {
+        if (varData[it->var()].reason.getType() == xor_t)
+            varData[it->var()].reason = PropBy();
+    }
+    gaussReasons.clear();
+    xorsAttached = false;
+}
+
+/**
+@brief Re-adds the XOR constraints with the replaced and set variables updated
+
+Those that become 2-long or shorter are turned into clauses. Repeated until
+no more variables get set
+*/
+bool Solver::cleanXors()
+{
+    assert(ok);
+    assert(!xorsAttached);
+    assert(decisionLevel() == 0);
+    assert(qhead == trail.size());
+
+    vector<Xor> toClean;
+    vector<Lit> lits;
+    size_t origTrailSize;
+    do {
+        origTrailSize = trail.size();
+        toClean.clear();
+        toClean.swap(xors);
+        for(vector<Xor>::const_iterator
+            it = toClean.begin(), end = toClean.end()
+            ; it != end
+            ; it++
+        ) {
+            lits.clear();
+            for(vector<Var>::const_iterator
+                it2 = it->vars.begin(), end2 = it->vars.end()
+                ; it2 != end2
+                ; it2++
+            ) {
+                lits.push_back(varReplacer->getLitReplacedWith(Lit(*it2, false)));
+            }
+
+            if (!addXorClauseInt(lits, it->rhs, true))
+                return false;
+        }
+    } while (trail.size() > origTrailSize);
+
+    return true;
+}
+
 /**
 @brief Adds a clause to the problem. Should ONLY be called internally
 
@@ -306,7 +596,7 @@ Clause* Solver::addClauseInt(
 
     #ifdef DRUP
     if (drup && addDrup) {
-        (*drup) << ps << " 0\n";
+        (*drup) << ps << DrupFlag::fin;
     }
     #endif
 
@@ -351,6 +641,9 @@ Clause* Solver::addClauseInt(
             if (learnt)
                 c->makeLearnt(stats.glue);
             c->stats = stats;
+            if (!learnt) {
+                touchIrredLits(ps);
+            }
 
             //In class 'Simplifier' we don't need to attach normall
             if (attach)
@@ -374,9 +667,9 @@ void Solver::attachClause(
     if (drup) {
         for(size_t i = 0; i < cl.size(); i++) {
             *drup
-            << cl[i] << " ";
+            << cl[i];
         }
-        *drup << "0\n";
+        *drup << DrupFlag::fin;
     }
     #endif
 
@@ -399,9 +692,9 @@ void Solver::attachTriClause(
     #if defined(DRUP_DEBUG) && defined(DRUP)
     if (drup) {
         *drup
-        << lit1 << " "
-        << lit2 << " "
-        << lit3 << " 0\n";
+        << lit1
+        << lit2
+        << lit3 << DrupFlag::fin;
     }
     #endif
 
@@ -412,6 +705,9 @@ void Solver::attachTriClause(
     } else {
         binTri.irredLits += 3;
         binTri.irredTris++;
+        touchIrred(lit1);
+        touchIrred(lit2);
+        touchIrred(lit3);
     }
 
     //Call Solver's function for heavy-lifting
@@ -427,8 +723,8 @@ void Solver::attachBinClause(
     #if defined(DRUP_DEBUG) && defined(DRUP)
     if (drup) {
         *drup
-        << lit1 << " "
-        << lit2 << " 0\n";
+        << lit1
+        << lit2 << DrupFlag::fin;
     }
     #endif
 
@@ -439,6 +735,8 @@ void Solver::attachBinClause(
     } else {
         binTri.irredLits += 2;
         binTri.irredBins++;
+        touchIrred(lit1);
+        touchIrred(lit2);
     }
     binTri.numNewBinsSinceSCC++;
 
@@ -458,6 +756,9 @@ void Solver::detachTriClause(
     } else {
         binTri.irredLits -= 3;
         binTri.irredTris--;
+        touchIrred(lit1);
+        touchIrred(lit2);
+        touchIrred(lit3);
     }
 
     PropEngine::detachTriClause(lit1, lit2, lit3, learnt);
@@ -474,6 +775,8 @@ void Solver::detachBinClause(
     } else {
         binTri.irredLits -= 2;
         binTri.irredBins--;
+        touchIrred(lit1);
+        touchIrred(lit2);
     }
 
     PropEngine::detachBinClause(lit1, lit2, learnt);
@@ -482,8 +785,8 @@ void Solver::detachBinClause(
 void Solver::detachClause(const Clause& cl, const bool removeDrup)
 {
     #ifdef DRUP
-    if (drup && doDRUP) {
-        (*drup) << "d " << cl << " 0\n";
+    if (drup && removeDrup) {
+        (*drup) << DrupFlag::del << cl << DrupFlag::fin;
     }
     #endif
 
@@ -504,16 +807,26 @@ void Solver::detachModifiedClause(
     , const Clause* address
 ) {
     //Update stats
-    if (address->learnt())
+    if (address->learnt()) {
         binTri.redLits -= origSize;
-    else
+    } else {
         binTri.irredLits -= origSize;
+        touchIrred(lit1);
+        touchIrred(lit2);
+        touchIrredLits(*address);
+    }
 
     //Call heavy-lifter
     PropEngine::detachModifiedClause(lit1, lit2, origSize, address);
 }
 
-bool Solver::addClauseHelper(vector<Lit>& ps)
+/**
+@brief Checks&updates the literals of a clause to be added
+
+If 'outside' is set, the literals are in the numbering of newVar(), otherwise
+in the outer numbering
+*/
+bool Solver::addClauseHelper(vector<Lit>& ps, const bool outside)
 {
     //If already UNSAT, just return
     if (!ok)
@@ -529,16 +842,21 @@ bool Solver::addClauseHelper(vector<Lit>& ps)
         exit(-1);
     }
 
-    //Check for too large variable number
-    for (Lit lit: ps) {
-        if (lit.var() >= nVarsReal()) {
+    //Check for too large variable number. The user cannot use the
+    //variables added by BVA
+    const uint32_t maxVars = outside ? nVarsOutside() : nVarsReal();
+    for (Lit& lit: ps) {
+        if (lit.var() >= maxVars) {
             cout
             << "ERROR: Variable " << lit.var() + 1
             << " inserted, but max var is "
-            << nVarsReal() +1
+            << maxVars
             << endl;
             exit(-1);
         }
+        if (outside)
+            lit = outsideToOuterLit(lit);
+
         assert(lit.var() < nVarsReal()
         && "Clause inserted, but variable inside has not been declared with PropEngine::newVar() !");
 
@@ -616,6 +934,17 @@ it acts on them such that they are correct, and calls addClauseInt() to do
 the heavy-lifting
 */
 bool Solver::addClause(const vector<Lit>& lits)
+{
+    return addClauseOuter(lits, true);
+}
+
+/**
+@brief Adds a clause in outer numbering, or from the user if 'outside' is set
+
+Used to put back clauses removed by the Simplifier and CompHandler, which may
+contain the variables added by BVA
+*/
+bool Solver::addClauseOuter(const vector<Lit>& lits, const bool outside)
 {
     if (conf.doSimplify && simplifier->getAnythingHasBeenBlocked()) {
         cout
@@ -638,7 +967,7 @@ bool Solver::addClause(const vector<Lit>& lits)
     vector<Lit> finalCl;
     #endif
 
-    if (!addClauseHelper(ps)) {
+    if (!addClauseHelper(ps, outside)) {
         return false;
     }
 
@@ -662,16 +991,16 @@ bool Solver::addClause(const vector<Lit>& lits)
         //Dump only if non-empty (UNSAT handled later)
         if (!finalCl.empty()) {
             (*drup)
-            << finalCl << " 0\n";
+            << finalCl << DrupFlag::fin;
         }
 
         //Empty clause, it's UNSAT
         if (!solver->okay()) {
             (*drup)
-            << "0\n";
+            << DrupFlag::fin;
         }
         (*drup)
-        << "d " << origCl << " 0\n";
+        << DrupFlag::del << origCl << DrupFlag::fin;
     }
     #endif
 
@@ -692,7 +1021,7 @@ bool Solver::addLearntClause(
     vector<Lit> ps(lits.size());
     std::copy(lits.begin(), lits.end(), ps.begin());
 
-    if (!addClauseHelper(ps))
+    if (!addClauseHelper(ps, true))
         return false;
 
     Clause* cl = addClauseInt(ps, true, stats);
@@ -845,6 +1174,9 @@ void Solver::renumberVariables()
 
     //Update local data
     updateArray(backupActivity, interToOuter);
+    vmtfQueue.updateVars(outerToInter);
+    updateArray(targetPolarity, interToOuter);
+    updateArray(bestPolarity, interToOuter);
     updateArray(backupPolarity, interToOuter);
     updateArray(decisionVar, interToOuter);
     PropEngine::updateVars(outerToInter, interToOuter, interToOuter2);
@@ -884,6 +1216,7 @@ void Solver::renumberVariables()
     if (conf.doSimplify) {
         simplifier->updateVars(outerToInter, interToOuter);
     }
+    irredTouched.clear();
     varReplacer->updateVars(outerToInter, interToOuter);
     if (conf.doCache) {
         implCache.updateVars(seen, outerToInter, interToOuter2);
@@ -971,7 +1304,9 @@ void Solver::saveVarMem(const uint32_t newNumVars)
     watches.resize(newNumVars*2);
     watches.shrink_to_fit();
     implCache.newNumVars(newNumVars);
-    stamp.newNumVars(newNumVars);
+    if (conf.doStamp) {
+        stamp.newNumVars(newNumVars);
+    }
 
     //Resize 'seen'
     seen.resize(newNumVars*2);
@@ -992,7 +1327,9 @@ void Solver::unSaveVarMem()
 
     watches.resize(nVarsReal()*2);
     implCache.newNumVars(nVarsReal());
-    stamp.newNumVars(nVarsReal());
+    if (conf.doStamp) {
+        stamp.newNumVars(nVarsReal());
+    }
 
     //Resize 'seen'
     seen.resize(nVarsReal()*2);
@@ -1005,8 +1342,25 @@ void Solver::unSaveVarMem()
     //printMemStats();
 }
 
+/**
+@brief Adds a variable for the user
+
+The variables added by BVA are not known to the user, so the user's numbering
+(outside) only differs from the outer one once BVA has added some
+*/
 Var Solver::newVar(const bool dvar)
 {
+    outsideToOuter.push_back(newVarInt(dvar));
+    return outsideToOuter.size()-1;
+}
+
+Var Solver::newVarInt(const bool dvar)
+{
+    //The new variable takes the next number, so the memory saved on the
+    //variables removed earlier must be given back
+    if (nVars() < nVarsReal()) {
+        unSaveVarMem();
+    }
     const Var var = decisionVar.size();
 
     if (conf.doStamp
@@ -1177,11 +1531,50 @@ bool Solver::reduceDBStructPropConfl::operator() (
     return x->size() > y->size();
 }
 
+/**
+@brief Moves the local tier of the learnt clauses to the front of longRedCls
+
+Core clauses (glue <= tierCoreGlue) are kept forever. Mid-tier clauses (glue
+<= tierMidGlue) are kept as long as they are used: they propagated, caused a
+conflict or took part in conflict analysis since the clause stats were last
+cleared (at the end of every cleaning, by default). All other clauses are in
+the local tier. Glues are updated in propNormalClause(), so clauses get
+promoted between the tiers as they are used.
+
+@returns the number of clauses in the local tier
+*/
+size_t Solver::arrangeTiers(CleaningStats& tmpStats)
+{
+    size_t numLocal = 0;
+    for(size_t i = 0; i < longRedCls.size(); i++) {
+        const Clause* cl = clAllocator->getPointer(longRedCls[i]);
+        if (cl->stats.glue <= conf.tierCoreGlue) {
+            tmpStats.tierCore++;
+            continue;
+        }
+
+        if (cl->stats.glue <= conf.tierMidGlue
+            && cl->stats.numPropAndConfl() + cl->stats.numUsedUIP > 0
+        ) {
+            tmpStats.tierMid++;
+            continue;
+        }
+
+        std::swap(longRedCls[i], longRedCls[numLocal]);
+        numLocal++;
+    }
+    tmpStats.tierLocal += numLocal;
+
+    return numLocal;
+}
+
 /**
 @brief Removes learnt clauses that have been found not to be too good
 
 Either based on glue or MiniSat-style learnt clause activities, the clauses are
-sorted and then removed
+sorted and then removed. Removed clauses are not detached: propagation drops
+the watches of freed clauses as it meets them, and consolidateMem() clears
+the rest
 */
 CleaningStats Solver::reduceDB()
 {
@@ -1230,10 +1623,8 @@ CleaningStats Solver::reduceDB()
         << endl;
     }
 
-    //Complete detach&reattach of OK clauses will be *much* faster
-    CompleteDetachReatacher detachReattach(this);
-    detachReattach.detachNonBinsNonTris();
-
+    //Clauses are only marked as freed, their watches are removed lazily by
+    //propagation, or all at once when the memory is consolidated
     //pre-remove
     if (conf.doPreClauseCleanPropAndConfl) {
         //Reduce based on props&confls
@@ -1265,9 +1656,9 @@ CleaningStats Solver::reduceDB()
                 #ifdef DRUP
                 if (drup) {
                     (*drup)
-                    << "d "
+                    << DrupFlag::del
                     << *cl
-                    << " 0\n";
+                    << DrupFlag::fin;
                 }
                 #endif
                 clAllocator->clauseFree(offset);
@@ -1281,6 +1672,7 @@ CleaningStats Solver::reduceDB()
 
     //Clean according to type
     tmpStats.clauseCleaningType = conf.clauseCleaningType;
+    size_t removeLimit = longRedCls.size();
     switch (conf.clauseCleaningType) {
         case CLEAN_CLAUSES_GLUE_BASED :
             //Sort for glue-based removal
@@ -1309,6 +1701,23 @@ CleaningStats Solver::reduceDB()
                 , reduceDBStructPropConfl(clAllocator));
             tmpStats.propConflBasedClean = 1;
             break;
+
+        case CLEAN_CLAUSES_TIERED :
+            //Only the local tier, at the front, may be removed
+            removeLimit = arrangeTiers(tmpStats);
+            removeNum = std::max<long long>(
+                (double)removeLimit*conf.ratioRemoveClauses
+                , (long)longRedCls.size()-(long)maxToHave
+            );
+            removeNum = std::min<uint64_t>(removeNum, removeLimit);
+            std::nth_element(
+                longRedCls.begin()
+                , longRedCls.begin() + removeNum
+                , longRedCls.begin() + removeLimit
+                , reduceDBStructPropConfl(clAllocator)
+            );
+            tmpStats.tieredClean = 1;
+            break;
     }
 
     #ifdef VERBOSE_DEBUG
@@ -1322,7 +1731,7 @@ CleaningStats Solver::reduceDB()
     //Remove clauses
     size_t i, j;
     for (i = j = 0
-        ; i < longRedCls.size() && tmpStats.removed.num < removeNum
+        ; i < removeLimit && tmpStats.removed.num < removeNum
         ; i++
     ) {
         ClOffset offset = longRedCls[i];
@@ -1347,9 +1756,9 @@ CleaningStats Solver::reduceDB()
         #ifdef DRUP
         if (drup) {
             (*drup)
-            << "d "
+            << DrupFlag::del
             << *cl
-            << " 0\n";
+            << DrupFlag::fin;
         }
         #endif
         clAllocator->clauseFree(offset);
@@ -1393,9 +1802,8 @@ CleaningStats Solver::reduceDB()
 
     //Resize learnt datastruct
     longRedCls.resize(longRedCls.size() - (i - j));
-
-    //Reattach what's left
-    detachReattach.reattachLongs();
+    numLazyFreed += tmpStats.preRemove.num + tmpStats.removed.num;
+    binTri.redLits -= tmpStats.preRemove.lits + tmpStats.removed.lits;
 
     //Print results
     tmpStats.cpu_time = cpuTime() - myTime;
@@ -1436,8 +1844,22 @@ lbool Solver::solve(const vector<Lit>* _assumptions)
     nextCleanLimit += nextCleanLimitInc;
     if (_assumptions != NULL) {
         assumptions = *_assumptions;
+        for(vector<Lit>::iterator
+            it = assumptions.begin(), end = assumptions.end()
+            ; it != end
+            ; it++
+        ) {
+            assert(it->var() < nVarsOutside());
+            *it = outsideToOuterLit(*it);
+        }
     }
 
+    #ifdef DRUP
+    if (ok) {
+        cutXors();
+    }
+    #endif
+
     //Check if adding the clauses caused UNSAT
     lbool status = l_Undef;
     if (!ok) {
@@ -1482,8 +1904,16 @@ lbool Solver::solve(const vector<Lit>* _assumptions)
         //Abide by maxConfl limit
         numConfls = std::min<uint32_t>(numConfls, conf.maxConfl - sumStats.conflStats.numConflicts);
 
-        //Solve and update stats
+        //Solve and update stats. At-most-one and XOR constraints are only
+        //propagated natively during the search
+        if (!attachXors()) {
+            status = l_False;
+            break;
+        }
+        cardFinder->findAndAttach();
         status = Searcher::solve(assumptions, numConfls);
+        cardFinder->detach();
+        detachXors();
 
         //If stats indicate that recursive minimization is not helping
         //turn it off
@@ -1585,6 +2015,7 @@ lbool Solver::solve(const vector<Lit>* _assumptions)
 
         if (status != l_False) {
             Searcher::resetStats();
+            shedMemoryIfNeeded();
             fullReduce();
         }
 
@@ -1621,6 +2052,16 @@ lbool Solver::solve(const vector<Lit>* _assumptions)
 
         //Renumber model back to original variable numbering
         updateArrayRev(model, interToOuterMain);
+
+        //The variables added by BVA or for cut XORs are not part of the
+        //problem we got
+        if (nVarsOutside() < model.size()) {
+            vector<lbool> outsideModel(nVarsOutside());
+            for(size_t i = 0; i < nVarsOutside(); i++) {
+                outsideModel[i] = model[outsideToOuter[i]];
+            }
+            model.swap(outsideModel);
+        }
     }
     checkDecisionVarCorrectness();
 
@@ -1649,10 +2090,19 @@ to try to simplifcy the problem at hand.
 lbool Solver::simplifyProblem()
 {
     assert(ok);
+
+    //Simplifiers expect no watches to freed clauses
+    if (numLazyFreed > 0)
+        consolidateMem();
     testAllClauseAttach();
     #ifdef DEBUG_IMPLICIT_STATS
     checkStats();
     #endif
+
+    //The background job's results are only valid until the first change
+    if (conf.doBgSimp && !bgSimplifier->finish())
+        goto end;
+
     reArrangeClauses();
 
     if (conf.verbosity >= 6) {
@@ -1670,11 +2120,16 @@ lbool Solver::simplifyProblem()
         }
     }
 
+    shedMemoryIfNeeded();
+
+    //The XOR constraints are not split into components
     if (conf.doCompHandler
+        && xors.empty()
         && getNumFreeVars() < conf.compVarLimit
         && solveStats.numSimplify >= conf.handlerFromSimpNum
         //Only every 2nd, since it can be costly to find parts
         && solveStats.numSimplify % 2 == 0
+        && memShed < MemShed::no_new_comps
     ) {
         if (!compHandler->handle())
             goto end;
@@ -1703,14 +2158,20 @@ lbool Solver::simplifyProblem()
     }
 
     //Treat implicits
-    if (conf.doStrSubImplicit) {
+    if (conf.doStrSubImplicit && inprocSched->shouldRun(Inproc::implicit)) {
+        inprocSched->start(Inproc::implicit);
         clauseVivifier->subsumeImplicit();
+        inprocSched->finish(Inproc::implicit);
     }
 
     //PROBE
     updateDominators();
-    if (conf.doProbe && !prober->probe()) {
-        goto end;
+    if (conf.doProbe && inprocSched->shouldRun(Inproc::probe)) {
+        inprocSched->start(Inproc::probe);
+        const bool ret = prober->probe();
+        inprocSched->finish(Inproc::probe);
+        if (!ret)
+            goto end;
     }
 
     //If we are over the limit, exit
@@ -1721,13 +2182,19 @@ lbool Solver::simplifyProblem()
     }
 
     //Don't replace first -- the stamps won't work so well
-    if (conf.doClausVivif && !clauseVivifier->vivify(true)) {
-        goto end;
+    if (conf.doClausVivif && inprocSched->shouldRun(Inproc::vivify)) {
+        inprocSched->start(Inproc::vivify);
+        const bool ret = clauseVivifier->vivify(true);
+        inprocSched->finish(Inproc::vivify);
+        if (!ret)
+            goto end;
     }
 
     //Treat implicits
-    if (conf.doStrSubImplicit) {
+    if (conf.doStrSubImplicit && inprocSched->shouldRun(Inproc::implicit)) {
+        inprocSched->start(Inproc::implicit);
         clauseVivifier->subsumeImplicit();
+        inprocSched->finish(Inproc::implicit);
     }
 
     //SCC&VAR-REPL
@@ -1744,16 +2211,23 @@ lbool Solver::simplifyProblem()
         return l_Undef;
 
     //Var-elim, gates, subsumption, strengthening
-    if (conf.doSimplify && !simplifier->simplify())
-        goto end;
+    if (conf.doSimplify && inprocSched->shouldRun(Inproc::simplify)) {
+        inprocSched->start(Inproc::simplify);
+        const bool ret = simplifier->simplify();
+        inprocSched->finish(Inproc::simplify);
+        if (!ret)
+            goto end;
+    }
 
     //Treat implicits
-    if (conf.doStrSubImplicit) {
-        if (!clauseVivifier->strengthenImplicit()) {
+    if (conf.doStrSubImplicit && inprocSched->shouldRun(Inproc::implicit)) {
+        inprocSched->start(Inproc::implicit);
+        const bool ret = clauseVivifier->strengthenImplicit();
+        if (ret)
+            clauseVivifier->subsumeImplicit();
+        inprocSched->finish(Inproc::implicit);
+        if (!ret)
             goto end;
-        }
-
-        clauseVivifier->subsumeImplicit();
     }
 
     //Clean cache before vivif
@@ -1761,8 +2235,12 @@ lbool Solver::simplifyProblem()
         goto end;
 
     //Vivify clauses
-    if (conf.doClausVivif && !clauseVivifier->vivify(true)) {
-        goto end;
+    if (conf.doClausVivif && inprocSched->shouldRun(Inproc::vivify)) {
+        inprocSched->start(Inproc::vivify);
+        const bool ret = clauseVivifier->vivify(true);
+        inprocSched->finish(Inproc::vivify);
+        if (!ret)
+            goto end;
     }
 
     //Search & replace 2-long XORs
@@ -1803,10 +2281,19 @@ lbool Solver::simplifyProblem()
     }
 
     if (conf.doRenumberVars) {
-        //Clean cache before renumber -- very important, otherwise
-        //we will be left with lits inside the cache that are out-of-bounds
-        if (conf.doCache && !implCache.clean(this))
-            goto end;
+        //Clean XORs and cache before renumber -- very important, otherwise
+        //we will be left with lits inside them that are out-of-bounds,
+        //since set vars are moved to the end. Both can set vars, so the
+        //cleaning is repeated until neither does
+        size_t origTrailSize;
+        do {
+            origTrailSize = trail.size();
+            if (!cleanXors())
+                goto end;
+
+            if (conf.doCache && !implCache.clean(this))
+                goto end;
+        } while (trail.size() > origTrailSize);
 
         renumberVariables();
     }
@@ -1832,6 +2319,7 @@ end:
         clearClauseStats(longRedCls);
     }
 
+    inprocSched->endRound();
     solveStats.numSimplify++;
 
     if (!ok) {
@@ -1843,6 +2331,85 @@ end:
     }
 }
 
+/**
+@brief Sheds load if the process is getting close to the memory budget
+
+Takes at most one step per call, in the order of MemShed, so the effect of the
+previous step can show up in the resident set size before the next one
+*/
+void Solver::shedMemoryIfNeeded()
+{
+    if (conf.maxMemMB == 0
+        || memShed == MemShed::no_new_comps
+    ) {
+        return;
+    }
+
+    const uint64_t usedMB = memUsedResident()/(1024ULL*1024ULL);
+    const uint64_t shedFromMB = (double)conf.maxMemMB*conf.memShedRatio;
+    if (usedMB <= shedFromMB)
+        return;
+
+    memShed = (MemShed)((int)memShed + 1);
+    string step;
+    switch(memShed) {
+        case MemShed::implcache:
+            step = "freeing implication cache";
+            if (conf.doCache) {
+                implCache.free();
+                vector<LitReachData> tmp;
+                litReachable.swap(tmp);
+                conf.doCache = false;
+            }
+            break;
+
+        case MemShed::stamps:
+            step = "freeing stamps";
+            if (conf.doStamp) {
+                stamp.freeMem();
+                conf.doStamp = false;
+            }
+            break;
+
+        case MemShed::reducedb:
+            //The reduceDB() called right after this will use the new ratios
+            step = "cleaning learnt clauses aggressively";
+            conf.ratioRemoveClauses = std::max(conf.ratioRemoveClauses, 0.8);
+            conf.maxNumLearntsRatio = std::min(conf.maxNumLearntsRatio, 1.0);
+            break;
+
+        case MemShed::occur: {
+            step = "capping occurrence list sizes";
+            const uint64_t headroomMB =
+                usedMB < conf.maxMemMB ? (conf.maxMemMB - usedMB)/2 : 0;
+            conf.maxOccurIrredMB = std::min(conf.maxOccurIrredMB, headroomMB);
+            conf.maxOccurRedMB = std::min(conf.maxOccurRedMB, headroomMB/4);
+            break;
+        }
+
+        case MemShed::no_new_comps:
+            step = "not starting new component solvers";
+            break;
+
+        case MemShed::none:
+            assert(false);
+            break;
+    }
+
+    #if defined(__GLIBC__)
+    //Give the freed memory back to the OS, so the next check sees it
+    malloc_trim(0);
+    #endif
+
+    if (conf.verbosity >= 1) {
+        cout
+        << "c [mem] used " << usedMB << " MB"
+        << " of budget " << conf.maxMemMB << " MB"
+        << " --> " << step
+        << endl;
+    }
+}
+
 ClauseUsageStats Solver::sumClauseData(
     const vector<ClOffset>& toprint
     , const bool learnt
@@ -2061,7 +2628,7 @@ void Solver::fullReduce()
         //printClauseStatsSQL(learnts);
     }
     CleaningStats iterCleanStat = reduceDB();
-    consolidateMem();
+    consolidateMem(false);
 
     if (conf.doSQL) {
         sqlStats->reduceDB(irredStats, redStats, iterCleanStat, solver);
@@ -2076,9 +2643,15 @@ void Solver::fullReduce()
     nextCleanLimitInc *= conf.increaseClean;
 }
 
-void Solver::consolidateMem()
+/**
+@brief Compacts the clause arena, detaching&reattaching all long clauses
+
+This is also what removes the watches of the clauses reduceDB() freed. Unless
+forced, it is only done if there is a lot of unused space in the arena
+*/
+void Solver::consolidateMem(const bool force)
 {
-    clAllocator->consolidate(this, true);
+    clAllocator->consolidate(this, force);
 }
 
 void Solver::printStats() const
@@ -2149,6 +2722,14 @@ void Solver::printMinStats() const
         , "% time"
     );
     sCCFinder->getStats().printShort();
+    if (conf.doSLS) {
+        printStatsLine("c SLS time"
+            , sls->getStats().cpu_time
+            , sls->getStats().cpu_time/cpu_time*100.0
+            , "% time"
+        );
+        sls->getStats().printShort();
+    }
     printStatsLine("c vrep replace time"
         , varReplacer->getStats().cpu_time
         , varReplacer->getStats().cpu_time/cpu_time*100.0
@@ -2207,6 +2788,9 @@ void Solver::printFullStats() const
     printStatsLine("c props/conflict"
         , (double)propStats.propagations/(double)sumStats.conflStats.numConflicts
     );
+    if (conf.restartType == Restart::bandit) {
+        restartBandit.print();
+    }
     cout << "c ------- FINAL TOTAL SOLVING STATS END ---------" << endl;
 
     printStatsLine("c clause clean time"
@@ -2258,6 +2842,15 @@ void Solver::printFullStats() const
         );
 
         simplifier->getStats().print(nVars());
+
+        if (conf.doBVA) {
+            printStatsLine("c BVA time"
+                , simplifier->getBVA()->getStats().cpu_time
+                , simplifier->getBVA()->getStats().cpu_time/cpu_time*100.0
+                , "% time"
+            );
+            simplifier->getBVA()->getStats().print();
+        }
     }
 
     //GateFinder stats
@@ -2285,6 +2878,41 @@ void Solver::printFullStats() const
     );
     sCCFinder->getStats().print();
 
+    if (conf.doSLS) {
+        printStatsLine("c SLS time"
+            , sls->getStats().cpu_time
+            , sls->getStats().cpu_time/cpu_time*100.0
+            , "% time"
+        );
+        sls->getStats().print();
+    }
+
+    if (conf.doInprocSched) {
+        inprocSched->print();
+    }
+
+    if (conf.doBgSimp) {
+        bgSimplifier->getStats().print();
+    }
+
+    if (conf.doCardFind) {
+        printStatsLine("c card time"
+            , cardFinder->getStats().cpu_time
+            , cardFinder->getStats().cpu_time/cpu_time*100.0
+            , "% time"
+        );
+        cardFinder->getStats().print();
+    }
+
+    if (conf.doGauss) {
+        printStatsLine("c gauss time"
+            , matrixFinder->getStats().cpu_time
+            , matrixFinder->getStats().cpu_time/cpu_time*100.0
+            , "% time"
+        );
+        matrixFinder->getStats().print();
+    }
+
 
     printStatsLine("c vrep replace time"
         , varReplacer->getStats().cpu_time
@@ -2518,6 +3146,9 @@ void Solver::printMemStats() const
         , (double)account/(double)totalMem*100.0
         , "%"
     );
+
+    //Real, tagged allocations, including malloc overhead
+    MemTracker::print();
 }
 
 void Solver::dumpBinClauses(
@@ -2991,12 +3622,35 @@ bool Solver::verifyClauses(const vector<ClOffset>& cs) const
     return verificationOK;
 }
 
+bool Solver::verifyXors() const
+{
+    bool verificationOK = true;
+
+    for (vector<Xor>::const_iterator
+        it = xors.begin(), end = xors.end()
+        ; it != end
+        ; it++
+    ) {
+        bool rhs = false;
+        for (uint32_t j = 0; j < it->vars.size(); j++)
+            rhs ^= (modelValue(Lit(it->vars[j], false)) == l_True);
+
+        if (rhs != it->rhs) {
+            cout << "unsatisfied xor: " << *it << endl;
+            verificationOK = false;
+        }
+    }
+
+    return verificationOK;
+}
+
 bool Solver::verifyModel() const
 {
     bool verificationOK = true;
     verificationOK &= verifyClauses(longIrredCls);
     verificationOK &= verifyClauses(longRedCls);
     verificationOK &= verifyImplicitClauses();
+    verificationOK &= verifyXors();
 
     if (conf.verbosity >= 1 && verificationOK) {
         cout
@@ -3647,7 +4301,7 @@ Lit Solver::updateLitForDomin(Lit lit) const
 
 void Solver::updateDominators()
 {
-    for(vector<Timestamp>::iterator
+    for(TimestampVec::iterator
         it = stamp.tstamp.begin(), end = stamp.tstamp.end()
         ; it != end
         ; it++
@@ -3692,9 +4346,9 @@ void Solver::calcReachability()
         for (uint32_t sig1 = 0; sig1 < 2; sig1++)  {
             const Lit lit = Lit(var, sig1);
 
-            const vector<LitExtra>& cache = implCache[lit.toInt()].lits;
+            const LitExtraVec& cache = implCache[lit.toInt()].lits;
             uint32_t cacheSize = cache.size();
-            for (vector<LitExtra>::const_iterator
+            for (LitExtraVec::const_iterator
                 it = cache.begin(), end = cache.end()
                 ; it != end
                 ; it++
@@ -30,6 +30,7 @@
 #include "implcache.h"
 #include "propengine.h"
 #include "searcher.h"
+#include "touchlist.h"
 #include "GitSHA1.h"
 #include <fstream>
 
@@ -45,6 +46,11 @@ class Prober;
 class Simplifier;
 class SCCFinder;
 class ClauseVivifier;
+class SLS;
+class InprocSched;
+class BgSimplifier;
+class CardFinder;
+class MatrixFinder;
 class CalcDefPolars;
 class SolutionExtender;
 class SQLStats;
@@ -52,6 +58,20 @@ class ImplCache;
 class CompFinder;
 class CompHandler;
 
+/**
+@brief Steps taken, in order, to stay within the memory budget (conf.maxMemMB)
+
+Each step is taken once, and they are never undone
+*/
+enum class MemShed {
+    none = 0
+    , implcache     ///<Implication cache freed&disabled
+    , stamps        ///<Stamps freed&disabled
+    , reducedb      ///<Aggressive learnt clause cleaning
+    , occur         ///<Occurrence list limits of the Simplifier capped
+    , no_new_comps  ///<No new component sub-solvers are started
+};
+
 class LitReachData {
     public:
         LitReachData() :
@@ -83,6 +103,7 @@ class Solver : public Searcher
         //////////////////////////////
         // Problem specification:
         Var  newVar(const bool dvar = true); ///< Add new variable
+        uint32_t nVarsOutside() const; ///<Number of variables added with newVar()
         bool addClause(const vector<Lit>& ps);  ///< Add clause to the solver
         bool addXorClause(const vector<Var>& vars, bool rhs);
         bool addLearntClause(
@@ -90,6 +111,13 @@ class Solver : public Searcher
             , const ClauseStats& stats = ClauseStats()
         );
 
+        #ifdef DRUP
+        ///Write the proof to "drup", in outer variable numbering. For
+        ///component sub-solvers, "toParent" maps our outer variables to the
+        ///parent's inner ones
+        void setDrup(DrupWriter* drup, const vector<Var>* toParent = NULL);
+        #endif
+
         struct BinTriStats
         {
             BinTriStats() :
@@ -133,6 +161,7 @@ class Solver : public Searcher
         const vector<Var>& getInterToOuterMain() const;
         size_t getNumVarsElimed() const;
         size_t getNumVarsReplaced() const;
+        MemShed getMemShed() const;
         void dumpIfNeeded() const;
         void print_elimed_vars() const;
         Var numActiveVars() const;
@@ -347,6 +376,16 @@ class Solver : public Searcher
             , bool rhs
             , const bool attach
         );
+        #ifdef DRUP
+        vector<Xor> xorsToCut; ///<Longer than 2, added as clauses when solving starts
+        void cutXors();
+        void addXorAsClauses(vector<Lit> ps, const bool rhs, const bool attach);
+        #endif
+
+        //XOR constraints are only in the watchlists during the search
+        bool attachXors();
+        void detachXors();
+        bool cleanXors(); ///<Update to replaced and set vars. Returns FALSE if UNSAT
         lbool simplifyProblem();
         SolveStats solveStats;
 
@@ -376,6 +415,13 @@ class Solver : public Searcher
         friend class PropEngine;
         friend class CompFinder;
         friend class CompHandler;
+        friend class SLS;
+        friend class InprocSched;
+        friend class BgSimplifier;
+        friend class BVA;
+        friend class CardFinder;
+        friend class Gaussian;
+        friend class MatrixFinder;
         Prober              *prober;
         Simplifier          *simplifier;
         SCCFinder           *sCCFinder;
@@ -383,6 +429,11 @@ class Solver : public Searcher
         ClauseCleaner       *clauseCleaner;
         VarReplacer         *varReplacer;
         CompHandler         *compHandler;
+        SLS                 *sls;
+        InprocSched         *inprocSched;
+        BgSimplifier        *bgSimplifier;
+        CardFinder          *cardFinder;
+        MatrixFinder        *matrixFinder;
         MTRand              mtrand;           ///< random number generator
 
         /////////////////////////////
@@ -393,25 +444,33 @@ class Solver : public Searcher
         //Renumberer
         vector<Var> outerToInterMain;
         vector<Var> interToOuterMain;
+        vector<Var> outsideToOuter; ///<Vars of newVar() to outer, skips the ones added internally (BVA, cut XORs)
+        Lit outsideToOuterLit(const Lit lit) const;
         vector<Var> outerToInter; //last renumber
         vector<Var> interToOuter; //last renumber
         vector<uint32_t> interToOuter2;
+        #ifdef DRUP
+        size_t numDrupVarMaps; ///<Pushed onto drup by setDrup()
+        #endif
         void renumberVariables();
         void freeUnusedWatches();
         void saveVarMem(uint32_t newNumVars);
         void unSaveVarMem();
+        Var newVarInt(const bool dvar = true);
 
         /////////////////////////////
         // SAT solution verification
         bool verifyModel() const;
         bool verifyImplicitClauses() const;
         bool verifyClauses(const vector<ClOffset>& cs) const;
+        bool verifyXors() const;
 
         ///////////////////////////
         // Clause cleaning
         void fullReduce();
         void clearClauseStats(vector<ClOffset>& clauseset);
         CleaningStats reduceDB();           ///<Reduce the set of learnt clauses.
+        size_t arrangeTiers(CleaningStats& tmpStats);
         struct reduceDBStructGlue
         {
             reduceDBStructGlue(ClauseAllocator* _clAllocator) :
@@ -449,13 +508,20 @@ class Solver : public Searcher
             bool operator () (const ClOffset x, const ClOffset y);
         };
 
+        /////////////////////
+        // Memory budget
+        MemShed              memShed;
+        void                 shedMemoryIfNeeded();
+
         /////////////////////
         // Data
         ImplCache            implCache;
         bool                 needToInterrupt;
         uint64_t             nextCleanLimit;
         uint64_t             nextCleanLimitInc;
+        size_t               numLazyFreed; ///<Freed by reduceDB(), maybe still watched
         uint32_t             numDecisionVars;
+        uint32_t             numBVAVars; ///<Added by BVA, not in outsideToOuter
         void setDecisionVar(const uint32_t var);
         void unsetDecisionVar(const uint32_t var);
         size_t               zeroLevAssignsByCNF;
@@ -471,16 +537,21 @@ class Solver : public Searcher
 
         /////////////////////
         // Clauses
-        bool addClauseHelper(vector<Lit>& ps);
+        bool addClauseHelper(vector<Lit>& ps, const bool outside);
+        bool addClauseOuter(const vector<Lit>& ps, const bool outside = false);
         vector<char>        decisionVar;
         vector<ClOffset>    longIrredCls;          ///< List of problem clauses that are larger than 2
         vector<ClOffset>    longRedCls;          ///< List of learnt clauses.
         BinTriStats binTri;
+        TouchList           irredTouched; ///<Vars whose irred clauses changed since var-elim last scored them
+        void                touchIrred(const Lit lit);
+        void                touchIrred(const Var var);
+        template<class T> void touchIrredLits(const T& lits);
         void                reArrangeClauses();
         void                reArrangeClause(ClOffset offset);
         void                checkLiteralCount() const;
         void                printAllClauses() const;
-        void                consolidateMem();
+        void                consolidateMem(const bool force = true);
 
         //////////////////
         // Stamping
@@ -526,6 +597,46 @@ inline void Solver::unsetDecisionVar(const uint32_t var)
     }
 }
 
+/**
+@brief Marks that an irreducible clause of 'lit' changed
+
+Only kept if var-elim keeps its scores between the rounds, see
+Simplifier::orderVarsForElimInit()
+*/
+inline void Solver::touchIrred(const Lit lit)
+{
+    if (conf.incVarElimScore)
+        irredTouched.touch(lit);
+}
+
+inline void Solver::touchIrred(const Var var)
+{
+    if (conf.incVarElimScore)
+        irredTouched.touch(var);
+}
+
+///Marks all literals of an irreducible clause as changed
+template<class T>
+inline void Solver::touchIrredLits(const T& lits)
+{
+    if (!conf.incVarElimScore)
+        return;
+
+    for(size_t i = 0; i < lits.size(); i++) {
+        irredTouched.touch(lits[i]);
+    }
+}
+
+inline uint32_t Solver::nVarsOutside() const
+{
+    return outsideToOuter.size();
+}
+
+inline Lit Solver::outsideToOuterLit(const Lit lit) const
+{
+    return Lit(outsideToOuter[lit.var()], lit.sign());
+}
+
 inline bool Solver::getNeedToDumpLearnts() const
 {
     return conf.needToDumpLearnts;
@@ -613,6 +724,11 @@ inline const vector<string>& Solver::getFileNamesUsed() const
     return fileNamesUsed;
 }
 
+inline MemShed Solver::getMemShed() const
+{
+    return memShed;
+}
+
 inline const Solver::BinTriStats& Solver::getBinTriStats() const
 {
     return binTri;
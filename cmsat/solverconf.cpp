@@ -31,9 +31,19 @@ SolverConf::SolverConf() :
         , var_inc_variability(0)
         , random_var_freq(0)
         , polarity_mode(PolarityMode::automatic)
+        , branchType(Branch::vsids)
+        , doTargetPhase(0)
+        , doRephase(false)
+        , rephaseInterval(1000)
+
+        //Local search
+        , doSLS(false)
+        , slsWorkLimit(30ULL*1000ULL*1000ULL)
 
         //Clause cleaning
         , clauseCleaningType(CLEAN_CLAUSES_PROPCONFL_BASED)
+        , tierCoreGlue(2)
+        , tierMidGlue(6)
         , doPreClauseCleanPropAndConfl(false)
         , preClauseCleanLimit(2)
         , preCleanMinConflTime(10000)
@@ -50,8 +60,13 @@ SolverConf::SolverConf() :
         , restart_inc(2)
         , burstSearchLen(300)
         , restartType(Restart::automatic)
+        , restartBanditExplore(0.5)
         , optimiseUnsat(0)
 
+        //Backtracking
+        , doChronoBT(false)
+        , chronoBTThreshold(100)
+
         //Clause minimisation
         , doRecursiveMinim (true)
         , doMinimLearntMore(true)
@@ -96,10 +111,12 @@ SolverConf::SolverConf() :
         , sqlUser ("cmsat_solver")
         , sqlPass ("")
         , sqlDatabase("cmsat")
+        , sqlMaxQueued(10000)
 
         //Var-elim
         , doVarElim        (true)
         , updateVarElimComplexityOTF(true)
+        , incVarElimScore(false)
         , varelimStrategy  (0)
         , varElimCostEstimateStrategy(0)
         , varElimRatioPerIter(0.12)
@@ -114,12 +131,20 @@ SolverConf::SolverConf() :
         , cacheUpdateCutoff(2000)
         , maxCacheSizeMB   (2048)
 
+        //Memory budget
+        , maxMemMB         (0)
+        , memShedRatio     (0.8)
+
         //XOR
         , doFindXors       (true)
         , maxXorToFind     (5)
         , useCacheWhenFindingXors(false)
         , doEchelonizeXOR  (true)
         , maxXORMatrix     (10LL*1000LL*1000LL)
+        , doGauss          (false)
+        , gaussMaxNumMatrixes(3)
+        , gaussMinMatrixRows(10)
+        , gaussMaxMatrixRows(3000)
 
         //Var-replacer
         , doFindAndReplaceEqLits(true)
@@ -129,16 +154,27 @@ SolverConf::SolverConf() :
         //Propagation & search
         , doLHBR           (false)
         , propBinFirst     (false)
+        , doTrailSave      (false)
+        , doCardFind       (false)
+        , cardMinSize      (5)
+        , cardFindLimitM   (20)
         , dominPickFreq    (400)
         , flipPolarFreq    (300)
 
         //Simplifier
         , doSimplify       (true)
+        , numSimpThreads   (1)
         , doSchedSimpProblem(true)
         , doPreSchedSimpProblem (true)
+        , doInprocSched    (false)
+        , inprocMinBudget  (0.1)
+        , inprocMaxBudget  (4.0)
+        , inprocStarvedEvery(4)
         , doSubsume1       (true)
         , doBlockClauses   (true)
         , doAsymmTE        (true)
+        , doBVA            (false)
+        , bvaLimitM        (100)
         , maxRedLinkInSize (200)
         , maxOccurIrredMB  (800)
         , maxOccurRedMB    (800)
@@ -157,6 +193,9 @@ SolverConf::SolverConf() :
 
         , doExtBinSubs     (true)
         , doClausVivif     (true)
+        , doBgSimp         (false)
+        , bgSimpEvery      (20000)
+        , bgSimpBudgetM    (30)
         , doSortWatched    (true)
         , doStrSubImplicit (true)
 
@@ -53,9 +53,19 @@ class SolverConf
          * Controls which polarity the decision heuristic chooses.
         **/
         PolarityMode polarity_mode;
+        Branch    branchType; ///<Decision heap (VSIDS) or VMTF queue. Automatic: VMTF with glue-based restarts
+        int       doTargetPhase; ///<Decide on target polarities. 0 = never, 1 = with geometric restarts, 2 = always
+        int       doRephase; ///<Periodically reset the saved polarities
+        uint64_t  rephaseInterval; ///<The N-th rephase is done N*this many conflicts after the previous
+
+        //Local search
+        int       doSLS; ///<Rephase with stochastic local search, finish if it finds a model
+        uint64_t  slsWorkLimit; ///<Literals visited per local search call
 
         //Clause cleaning
         clauseCleaningTypes clauseCleaningType;
+        uint32_t  tierCoreGlue; ///<Tiered cleaning: learnt clauses with at most this glue are never removed
+        uint32_t  tierMidGlue; ///<Tiered cleaning: learnt clauses with at most this glue are removed only if unused
         int       doPreClauseCleanPropAndConfl;
         uint32_t  preClauseCleanLimit;
         uint32_t  preCleanMinConflTime;
@@ -72,8 +82,13 @@ class SolverConf
         double    restart_inc;        ///<The factor with which the restart limit is multiplied in each restart.                    (default 1.5)
         uint64_t    burstSearchLen;
         Restart  restartType;   ///<If set, the solver will always choose the given restart strategy
+        double    restartBanditExplore; ///<Exploration factor of the UCB1 bandit choosing the restart type
         int       optimiseUnsat;
 
+        //Backtracking
+        int       doChronoBT; ///<Backtrack only one level if the jump would be long
+        uint32_t  chronoBTThreshold; ///<Jumps longer than this many levels are chronological
+
         //Clause minimisation
         int doRecursiveMinim;
         int doMinimLearntMore;  ///<Perform learnt-clause minimisation using watchists' binary and tertiary clauses? ("strong minimization" in PrecoSat)
@@ -118,10 +133,12 @@ class SolverConf
         string    sqlUser;
         string    sqlPass;
         string    sqlDatabase;
+        uint64_t    sqlMaxQueued; ///<Drop stats rows if more than this many are waiting to be written
 
         //Var-elim
         int      doVarElim;          ///<Perform variable elimination
         int      updateVarElimComplexityOTF;
+        int      incVarElimScore; ///<Keep elimination scores between rounds, re-score only changed vars
         int      varelimStrategy; ///<Guess varelim order, or calculate?
         int      varElimCostEstimateStrategy;
         double    varElimRatioPerIter;
@@ -136,12 +153,20 @@ class SolverConf
         uint64_t   cacheUpdateCutoff;
         uint64_t   maxCacheSizeMB;
 
+        //Memory budget
+        uint64_t  maxMemMB; ///<Process-wide memory budget. 0 means no budget
+        double    memShedRatio; ///<Start shedding load when this ratio of maxMemMB is used
+
         //XORs
         int      doFindXors;
         int      maxXorToFind;
         int      useCacheWhenFindingXors;
         int      doEchelonizeXOR;
         uint64_t  maxXORMatrix;
+        int      doGauss; ///<Propagate the XORs sharing variables through Gauss-Jordan matrices during search
+        uint32_t gaussMaxNumMatrixes;
+        uint32_t gaussMinMatrixRows; ///<Smaller sets of XORs are propagated one by one
+        uint32_t gaussMaxMatrixRows;
 
         //Var-replacement
         int doFindAndReplaceEqLits;
@@ -151,16 +176,27 @@ class SolverConf
         //Propagation & searching
         int      doLHBR; ///<Do lazy hyper-binary resolution
         int      propBinFirst;
+        int      doTrailSave; ///<Re-set implications from the trail undone by the last backjump
+        int      doCardFind; ///<Propagate the at-most-one constraints among the binary clauses natively during search
+        uint32_t cardMinSize; ///<Smallest at-most-one constraint to propagate natively
+        uint64_t cardFindLimitM; ///<Time limit of finding them, in millions of watchlist entries visited
         uint32_t  dominPickFreq;
         uint32_t  flipPolarFreq;
 
         //Simplifier
         int      doSimplify;         ///<Should try to subsume & self-subsuming resolve & variable-eliminate & block-clause eliminate?
+        uint32_t numSimpThreads; ///<Threads used by the occurrence-based simplifications
         int      doSchedSimpProblem;        ///<Should simplifyProblem() be scheduled regularly? (if set to FALSE, a lot of opmitisations are disabled)
         int      doPreSchedSimpProblem;          //Perform simplification at startup
+        int      doInprocSched; ///<Scale the time limits of the simplifications by their earlier payoff
+        double   inprocMinBudget; ///<Lowest budget multiplier. Techniques at it are starved
+        double   inprocMaxBudget; ///<Highest budget multiplier
+        uint32_t inprocStarvedEvery; ///<Starved techniques are only run every this many rounds
         int      doSubsume1;         ///<Perform self-subsuming resolution
         int      doBlockClauses;    ///<Should try to remove blocked clauses
         int      doAsymmTE; ///< Do Asymtotic blocked clause elimination
+        int      doBVA; ///<Bounded variable addition. No variables can be added afterwards
+        uint64_t bvaLimitM; ///<Time limit of BVA, in millions of occurrence list entries visited
         unsigned maxRedLinkInSize;
         uint64_t maxOccurIrredMB;
         uint64_t maxOccurRedMB;
@@ -183,6 +219,9 @@ class SolverConf
         int      doExtBinSubs;
 
         int      doClausVivif;      ///<Perform asymmetric branching at the beginning of the solving
+        int      doBgSimp; ///<Vivify&subsume new learnt clauses on a background thread
+        uint64_t bgSimpEvery; ///<Start a background job every this many conflicts
+        uint64_t bgSimpBudgetM; ///<Propagation budget of a background job, in millions of steps
         int      doSortWatched;      ///<Sort watchlists according to size&type: binary, tertiary, normal (>3-long), xor clauses
         int      doStrSubImplicit;
 
@@ -50,6 +50,7 @@ enum class Restart {
     , agility
     , never
     , automatic
+    , bandit
 };
 
 inline std::string restart_type_to_string(const Restart type)
@@ -72,6 +73,9 @@ inline std::string restart_type_to_string(const Restart type)
 
         case Restart::automatic:
             return "automatic";
+
+        case Restart::bandit:
+            return "bandit";
     }
 
     assert(false && "oops, one of the restart types has no string name");
@@ -79,6 +83,62 @@ inline std::string restart_type_to_string(const Restart type)
     return "Ooops, undefined!";
 }
 
+enum class Branch {
+    vsids
+    , vmtf
+    , automatic
+};
+
+inline std::string branch_type_to_string(const Branch type)
+{
+    switch(type) {
+        case Branch::vsids:
+            return "VSIDS";
+
+        case Branch::vmtf:
+            return "VMTF";
+
+        case Branch::automatic:
+            return "automatic";
+    }
+
+    assert(false && "oops, one of the branching types has no string name");
+
+    return "Ooops, undefined!";
+}
+
+enum class Rephase {
+    best
+    , original
+    , inverted
+    , random
+    , walk
+};
+
+inline std::string rephase_type_to_string(const Rephase type)
+{
+    switch(type) {
+        case Rephase::best:
+            return "best";
+
+        case Rephase::original:
+            return "original";
+
+        case Rephase::inverted:
+            return "inverted";
+
+        case Rephase::random:
+            return "random";
+
+        case Rephase::walk:
+            return "walk";
+    }
+
+    assert(false && "oops, one of the rephase types has no string name");
+
+    return "Ooops, undefined!";
+}
+
 //Removed by which algorithm. NONE = not eliminated
 enum class Removed {
     none
@@ -445,6 +505,8 @@ struct PropStats
         , bogoProps(0)
         , otfHyperTime(0)
         , otfHyperPropCalled(0)
+        , savedTrailLits(0)
+        , reimplied(0)
         #ifdef STATS_NEEDED
         , propsUnit(0)
         , propsBinIrred(0)
@@ -478,6 +540,8 @@ struct PropStats
         bogoProps += other.bogoProps;
         otfHyperTime += other.otfHyperTime;
         otfHyperPropCalled += other.otfHyperPropCalled;
+        savedTrailLits += other.savedTrailLits;
+        reimplied += other.reimplied;
         #ifdef STATS_NEEDED
         propsUnit += other.propsUnit;
         propsBinIrred += other.propsBinIrred;
@@ -506,6 +570,8 @@ struct PropStats
         bogoProps -= other.bogoProps;
         otfHyperTime -= other.otfHyperTime;
         otfHyperPropCalled -= other.otfHyperPropCalled;
+        savedTrailLits -= other.savedTrailLits;
+        reimplied -= other.reimplied;
         #ifdef STATS_NEEDED
         propsUnit -= other.propsUnit;
         propsBinIrred -= other.propsBinIrred;
@@ -560,6 +626,11 @@ struct PropStats
             , "/ sec"
         );
 
+        printStatsLine("c trail-save reimplied", reimplied
+            , 100.0*(double)reimplied/(double)savedTrailLits
+            , "% of saved lits"
+        );
+
         #ifdef STATS_NEEDED
         printStatsLine("c propsUnit", propsUnit
             , 100.0*(double)propsUnit/(double)propagations
@@ -630,6 +701,10 @@ struct PropStats
     uint64_t otfHyperTime;
     uint32_t otfHyperPropCalled;
 
+    //Trail saving
+    uint64_t savedTrailLits; ///<Literals saved when backjumping
+    uint64_t reimplied; ///<Literals set again from the saved trail
+
     #ifdef STATS_NEEDED
     //Stats for propagations
     uint64_t propsUnit;
@@ -5,6 +5,14 @@ using namespace CMSat;
 
 bool Stamp::stampBasedClRem(
     const vector<Lit>& lits
+) const {
+    return stampBasedClRem(lits, stampNorm, stampInv);
+}
+
+bool Stamp::stampBasedClRem(
+    const vector<Lit>& lits
+    , vector<Lit>& stampNorm
+    , vector<Lit>& stampInv
 ) const {
     StampSorter sortNorm(tstamp, STAMP_IRRED, false);
     StampSorterInv sortInv(tstamp, STAMP_IRRED, false);
@@ -171,7 +179,7 @@ void Stamp::updateDominators(const VarReplacer* replacer)
 
 void Stamp::clearStamps()
 {
-    for(vector<Timestamp>::iterator
+    for(TimestampVec::iterator
         it = tstamp.begin(), end = tstamp.end()
         ; it != end
         ; it++
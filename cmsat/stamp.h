@@ -3,6 +3,7 @@
 #include "solvertypes.h"
 #include "clause.h"
 #include "constants.h"
+#include "memtracker.h"
 
 #ifndef __STAMP_H__
 #define __STAMP_H__
@@ -17,6 +18,9 @@ enum StampType {
     , STAMP_RED = 1
 };
 
+struct Timestamp;
+typedef vector<Timestamp, TrackedAlloc<Timestamp, MemTag::stamp> > TimestampVec;
+
 struct Timestamp
 {
     Timestamp()
@@ -53,6 +57,13 @@ class Stamp
 public:
     void remove_from_stamps(const Var var);
     bool stampBasedClRem(const vector<Lit>& lits) const;
+
+    ///With caller-owned scratch space, so threads can call it at the same time
+    bool stampBasedClRem(
+        const vector<Lit>& lits
+        , vector<Lit>& stampNorm
+        , vector<Lit>& stampInv
+    ) const;
     std::pair<size_t, size_t> stampBasedLitRem(
         vector<Lit>& lits
         , StampType stampType
@@ -65,7 +76,7 @@ public:
         tstamp.shrink_to_fit();
     }
 
-    vector<Timestamp>   tstamp;
+    TimestampVec   tstamp;
     void newVar()
     {
         tstamp.push_back(Timestamp());
@@ -78,7 +89,7 @@ public:
 
     void freeMem()
     {
-        vector<Timestamp> tmp;
+        TimestampVec tmp;
         tstamp.swap(tmp);
     }
 
@@ -86,7 +97,7 @@ private:
     struct StampSorter
     {
         StampSorter(
-            const vector<Timestamp>& _timestamp
+            const TimestampVec& _timestamp
             , const StampType _stampType
             , const bool _rev
         ) :
@@ -95,7 +106,7 @@ private:
             , rev(_rev)
         {}
 
-        const vector<Timestamp>& timestamp;
+        const TimestampVec& timestamp;
         const StampType stampType;
         const bool rev;
 
@@ -114,7 +125,7 @@ private:
     struct StampSorterInv
     {
         StampSorterInv(
-            const vector<Timestamp>& _timestamp
+            const TimestampVec& _timestamp
             , const StampType _stampType
             , const bool _rev
         ) :
@@ -123,7 +134,7 @@ private:
             , rev(_rev)
         {}
 
-        const vector<Timestamp>& timestamp;
+        const TimestampVec& timestamp;
         const StampType stampType;
         const bool rev;
 
@@ -83,6 +83,11 @@ static inline uint64_t memUsed()
     return (uint64_t)memReadStat(0) * (uint64_t)getpagesize();
 }
 
+static inline uint64_t memUsedResident()
+{
+    return (uint64_t)memReadStat(1) * (uint64_t)getpagesize();
+}
+
 
 #elif defined(__FreeBSD__)
 static inline uint64_t memUsed(void)
@@ -92,12 +97,22 @@ static inline uint64_t memUsed(void)
     return ru.ru_maxrss*1024;
 }
 
+static inline uint64_t memUsedResident(void)
+{
+    return memUsed();
+}
+
 
 #else
 static inline uint64_t memUsed()
 {
     return 0;
 }
+
+static inline uint64_t memUsedResident()
+{
+    return 0;
+}
 #endif
 
 #endif //TIME_MEM_H
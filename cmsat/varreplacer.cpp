@@ -136,6 +136,9 @@ bool VarReplacer::performReplace()
         solver->unsetDecisionVar(var);
         solver->setDecisionVar(it->var());
 
+        //All clauses of var will be moved to it
+        solver->touchIrred(it->var());
+
         //Update activities. Top receives activities of the ones below
         uint32_t& activity1 = solver->activities[var];
         uint32_t& activity2 = solver->activities[it->var()];
@@ -193,6 +196,11 @@ bool VarReplacer::performReplace()
         goto end;
     }
 
+    //Replace in the XOR constraints
+    if (!solver->cleanXors()) {
+        goto end;
+    }
+
     solver->testAllClauseAttach();
     solver->checkNoWrongAttach();
     solver->checkStats();
@@ -304,7 +312,7 @@ bool VarReplacer::replaceImplicit()
                     if (solver->drup) {
                         *(solver->drup)
                         << lit1
-                        << " 0\n";
+                        << DrupFlag::fin;
                     }
                     #endif
                     remove = true;
@@ -322,8 +330,8 @@ bool VarReplacer::replaceImplicit()
                         #ifdef DRUP
                         if (solver->drup) {
                             *(solver->drup)
-                            << lit1 << " " << lit3
-                            << " 0\n";
+                            << lit1 << lit3
+                            << DrupFlag::fin;
                         }
                         #endif
                     }
@@ -344,8 +352,8 @@ bool VarReplacer::replaceImplicit()
                         #ifdef DRUP
                         if (solver->drup) {
                             *(solver->drup)
-                            << lit1 << " " << lit2
-                            << " 0\n";
+                            << lit1 << lit2
+                            << DrupFlag::fin;
                         }
                         #endif
                     }
@@ -367,11 +375,11 @@ bool VarReplacer::replaceImplicit()
                         && origLit2 < origLit3
                     ) {
                         *(solver->drup)
-                        << "d "
-                        << origLit1 << " "
-                        << origLit2 << " "
+                        << DrupFlag::del
+                        << origLit1
+                        << origLit2
                         << origLit3
-                        << " 0\n";
+                        << DrupFlag::fin;
                     }
                     #endif
 
@@ -409,17 +417,17 @@ bool VarReplacer::replaceImplicit()
                     )
                 ) {
                     *(solver->drup)
-                    << lit1 << " "
-                    << lit2 << " "
+                    << lit1
+                    << lit2
                     << lit3
-                    << " 0\n"
+                    << DrupFlag::fin
 
                     //Delete old one
-                    << "d "
-                    << origLit1 << " "
-                    << origLit2 << " "
+                    << DrupFlag::del
+                    << origLit1
+                    << origLit2
                     << origLit3
-                    << " 0\n";
+                    << DrupFlag::fin;
                 }
                 #endif
 
@@ -443,7 +451,7 @@ bool VarReplacer::replaceImplicit()
                 if (solver->drup) {
                     *(solver->drup)
                     << lit2
-                    << " 0\n";
+                    << DrupFlag::fin;
                 }
                 #endif
                 remove = true;
@@ -467,10 +475,10 @@ bool VarReplacer::replaceImplicit()
                      && origLit1 < origLit2
                 ) {
                     *(solver->drup)
-                    << "d "
-                    << origLit1 << " "
+                    << DrupFlag::del
+                    << origLit1
                     << origLit2
-                    << " 0\n";
+                    << DrupFlag::fin;
                 }
                 #endif
 
@@ -487,12 +495,12 @@ bool VarReplacer::replaceImplicit()
             ) {
                 *(solver->drup)
                 //Add replaced
-                << lit1 << " " << lit2
-                << " 0\n"
+                << lit1 << lit2
+                << DrupFlag::fin
 
                 //Delete old one
-                << "d " << origLit1 << " " << origLit2
-                << " 0\n";
+                << DrupFlag::del << origLit1 << origLit2
+                << DrupFlag::fin;
             }
 
             #endif
@@ -585,9 +593,9 @@ bool VarReplacer::replace_set(vector<ClOffset>& cs)
         #ifdef DRUP
         if (solver->drup && changed) {
             *(solver->drup)
-            << "d "
+            << DrupFlag::del
             << origCl
-            << " 0\n";
+            << DrupFlag::fin;
         }
         #endif
     }
@@ -634,7 +642,7 @@ bool VarReplacer::handleUpdatedClause(
     if (solver->drup) {
         *(solver->drup)
         << c
-        << " 0\n";
+        << DrupFlag::fin;
     }
     #endif
 
@@ -771,8 +779,8 @@ bool VarReplacer::replace(
     #ifdef DRUP_DEBUG
     if (solver->drup) {
         *(solver->drup)
-        << ~lit1 << " " << (lit2 ^!xorEqualFalse) << " 0\n"
-        << lit1 << " " << (~lit2 ^!xorEqualFalse) << " 0\n"
+        << ~lit1 << (lit2 ^!xorEqualFalse) << DrupFlag::fin
+        << lit1 << (~lit2 ^!xorEqualFalse) << DrupFlag::fin
         ;
     }
     #endif
@@ -789,11 +797,11 @@ bool VarReplacer::replace(
             #ifdef DRUP
             if (solver->drup) {
                 *(solver->drup)
-                << ~lit1 << " " << lit2 << " 0\n"
-                << lit1 << " " << ~lit2 << " 0\n"
-                << lit1 << " 0\n"
-                << ~lit1 << " 0\n"
-                << "0\n"
+                << ~lit1 << lit2 << DrupFlag::fin
+                << lit1 << ~lit2 << DrupFlag::fin
+                << lit1 << DrupFlag::fin
+                << ~lit1 << DrupFlag::fin
+                << DrupFlag::fin
                 ;
             }
             #endif
@@ -809,8 +817,8 @@ bool VarReplacer::replace(
     #ifdef DRUP
     if (solver->drup) {
         *(solver->drup)
-        << ~lit1 << " " << lit2 << " 0\n"
-        << lit1 << " " << ~lit2 << " 0\n"
+        << ~lit1 << lit2 << DrupFlag::fin
+        << lit1 << ~lit2 << DrupFlag::fin
         ;
     }
     #endif
@@ -828,9 +836,9 @@ bool VarReplacer::replace(
             #ifdef DRUP
             if (solver->drup) {
                 *(solver->drup)
-                << ~lit1 << " 0\n"
-                << lit1 << " 0\n"
-                << "0\n";
+                << ~lit1 << DrupFlag::fin
+                << lit1 << DrupFlag::fin
+                << DrupFlag::fin;
             }
             #endif
             solver->ok = false;
@@ -855,7 +863,7 @@ bool VarReplacer::replace(
             if (solver->drup) {
                 *(solver->drup)
                 << toEnqueue
-                << " 0\n";
+                << DrupFlag::fin;
             }
             #endif
 
@@ -32,6 +32,7 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <stdlib.h>
 
 #include "constants.h"
+#include "memtracker.h"
 
 // NOTE! Don't use this vector on datatypes that cannot be re-located in memory
 // (with realloc)
@@ -82,7 +83,12 @@ public:
         data(array)
         , sz(size)
         , cap(size)
-    {}      // (takes ownership of array -- will be deallocated with 'free()')
+    {       // (takes ownership of array -- will be deallocated with 'free()')
+        CMSat::MemTracker::alloced(
+            CMSat::MemTagOf<T>::tag
+            , CMSat::MemTracker::realSize(data, cap*sizeof(T))
+        );
+    }
 
     vec(const vec<T>& other) :
         data(NULL)
@@ -104,6 +110,10 @@ public:
 
     // Ownership of underlying array:
     T* release  (void) {
+        CMSat::MemTracker::freed(
+            CMSat::MemTagOf<T>::tag
+            , CMSat::MemTracker::realSize(data, cap*sizeof(T))
+        );
         T* ret = data;
         data = NULL;
         sz = 0;
@@ -179,8 +189,9 @@ public:
     void reserve(uint32_t res)
     {
         if (cap < res) {
+            data = (T*)CMSat::MemTracker::trackedRealloc(
+                CMSat::MemTagOf<T>::tag, data, cap * sizeof(T), res * sizeof(T));
             cap = res;
-            data = (T*)realloc(data, cap * sizeof(T));
         }
     }
 
@@ -269,11 +280,12 @@ public:
 
         assert(cap > sz);
         if (sz == 0) {
-            free(data);
+            CMSat::MemTracker::trackedFree(CMSat::MemTagOf<T>::tag, data, cap*sizeof(T));
             data = NULL;
             cap = 0;
         } else {
-            data = (T*)realloc(data, sz*sizeof(T));
+            data = (T*)CMSat::MemTracker::trackedRealloc(
+                CMSat::MemTagOf<T>::tag, data, cap*sizeof(T), sz*sizeof(T));
             assert(data != NULL);
             cap = sz;
         }
@@ -287,13 +299,15 @@ void vec<T>::grow(uint32_t min_cap)
     if (min_cap <= cap) {
         return;
     }
+    const uint32_t oldCap = cap;
     if (cap == 0) {
         cap = (min_cap >= 2) ? min_cap : 2;
     } else do {
         cap = (cap * 3 + 1) >> 1;
     } while (cap < min_cap);
 
-    data = (T*)realloc(data, cap * sizeof(T));
+    data = (T*)CMSat::MemTracker::trackedRealloc(
+        CMSat::MemTagOf<T>::tag, data, oldCap * sizeof(T), cap * sizeof(T));
     if (data == NULL) {
         throw std::bad_alloc();
     }
@@ -344,7 +358,7 @@ void vec<T>::clear(bool dealloc)
         }
         sz = 0;
         if (dealloc) {
-            free(data);
+            CMSat::MemTracker::trackedFree(CMSat::MemTagOf<T>::tag, data, cap*sizeof(T));
             data = NULL;
             cap = 0;
         }
@@ -0,0 +1,227 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos and collaborators. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+
+#ifndef __VMTFQUEUE_H__
+#define __VMTFQUEUE_H__
+
+#include <vector>
+#include <algorithm>
+#include "solvertypes.h"
+
+namespace CMSat {
+
+/**
+@brief Variable-move-to-front decision queue
+
+All variables are in a doubly-linked list, ordered by the time they were last
+bumped. Bumping moves the variable to the end of the list. Decisions are
+taken from the end, i.e. the most recently bumped unassigned variable is
+picked.
+
+The 'search' cursor is the position from which the next decision is looked
+for. Every variable after it is assigned, so only the cursor needs to be moved
+back when a variable gets unassigned. Both bumping and unassigning are O(1).
+*/
+class VMTFQueue
+{
+public:
+    VMTFQueue() :
+        first(var_Undef)
+        , last(var_Undef)
+        , search(var_Undef)
+        , stamp(0)
+    {}
+
+    ///Append the new variable, as if it had just been bumped
+    void newVar(const Var var)
+    {
+        assert(var == links.size());
+        links.push_back(Link());
+        enqueue(var);
+        search = var;
+    }
+
+    ///Move to the end of the queue
+    void bump(const Var var, const bool isUnassigned)
+    {
+        if (var != last) {
+            dequeue(var);
+            enqueue(var);
+        } else {
+            links[var].stamp = ++stamp;
+        }
+
+        if (isUnassigned)
+            search = var;
+    }
+
+    ///Bump all variables in 'vars' once, keeping their relative order
+    void bumpAll(std::vector<Var>& vars, const std::vector<lbool>& assigns)
+    {
+        std::sort(vars.begin(), vars.end(), StampLt(links));
+        vars.erase(std::unique(vars.begin(), vars.end()), vars.end());
+        for(std::vector<Var>::const_iterator
+            it = vars.begin(), end = vars.end()
+            ; it != end
+            ; it++
+        ) {
+            bump(*it, assigns[*it] == l_Undef);
+        }
+    }
+
+    ///Variable got unassigned, move the cursor if it's after the cursor
+    void unassigned(const Var var)
+    {
+        if (search == var_Undef
+            || links[var].stamp > links[search].stamp
+        ) {
+            search = var;
+        }
+    }
+
+    ///Next decision candidate (var_Undef if none), skipping vars that 'filt' rejects
+    template<class F>
+    Var next(const F& filt)
+    {
+        Var var = search;
+        while(var != var_Undef && !filt(var)) {
+            var = links[var].prev;
+        }
+
+        if (var != var_Undef)
+            search = var;
+
+        return var;
+    }
+
+    ///Use when unassigned variables may be after the cursor
+    void resetSearch()
+    {
+        search = last;
+    }
+
+    uint64_t getStamp(const Var var) const
+    {
+        return links[var].stamp;
+    }
+
+    ///Renumber the variables, keeping their order
+    void updateVars(const std::vector<Var>& outerToInter)
+    {
+        std::vector<Var> order;
+        order.reserve(links.size());
+        for(Var var = first; var != var_Undef; var = links[var].next) {
+            order.push_back(outerToInter[var]);
+        }
+
+        first = last = var_Undef;
+        stamp = 0;
+        for(std::vector<Var>::const_iterator
+            it = order.begin(), end = order.end()
+            ; it != end
+            ; it++
+        ) {
+            enqueue(*it);
+        }
+        search = last;
+    }
+
+    size_t size() const
+    {
+        return links.size();
+    }
+
+    uint64_t memUsed() const
+    {
+        return links.capacity()*sizeof(Link);
+    }
+
+private:
+    struct Link
+    {
+        Link() :
+            prev(var_Undef)
+            , next(var_Undef)
+            , stamp(0)
+        {}
+
+        Var prev;
+        Var next;
+        uint64_t stamp; ///<When it was last bumped
+    };
+
+    struct StampLt
+    {
+        StampLt(const std::vector<Link>& _links) :
+            links(_links)
+        {}
+
+        bool operator()(const Var a, const Var b) const
+        {
+            return links[a].stamp < links[b].stamp;
+        }
+
+        const std::vector<Link>& links;
+    };
+
+    void dequeue(const Var var)
+    {
+        Link& l = links[var];
+        if (l.prev != var_Undef)
+            links[l.prev].next = l.next;
+        else
+            first = l.next;
+
+        if (l.next != var_Undef)
+            links[l.next].prev = l.prev;
+        else
+            last = l.prev;
+
+        //Cursor must stay on a var that is still in the list
+        if (search == var)
+            search = (l.next != var_Undef) ? l.next : l.prev;
+    }
+
+    void enqueue(const Var var)
+    {
+        Link& l = links[var];
+        l.prev = last;
+        l.next = var_Undef;
+        l.stamp = ++stamp;
+        if (last != var_Undef)
+            links[last].next = var;
+        else
+            first = var;
+
+        last = var;
+    }
+
+    std::vector<Link> links;
+    Var first;
+    Var last;
+    Var search;
+    uint64_t stamp;
+};
+
+} //end namespace
+
+#endif //__VMTFQUEUE_H__
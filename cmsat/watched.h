@@ -38,6 +38,8 @@ enum WatchType {
     watch_clause_t = 0
     , watch_binary_t = 1
     , watch_tertiary_t = 2
+    , watch_card_t = 3
+    , watch_xor_t = 4 ///<Stored as watch_card_t, told apart by data2
 };
 
 /**
@@ -48,6 +50,10 @@ This class contains two 32-bit datapieces. They are either used as:
 \li Two literals, in the case of tertiary clauses
 \li One blocking literal (i.e. an example literal from the clause) and a clause
 offset (as per ClauseAllocator ), in the case of normal clauses
+\li The index of an at-most-one constraint in PropEngine::cards, in the case of
+cardinality constraints
+\li The index of an XOR constraint in PropEngine::xors, in the case of XOR
+constraints. Both literals of its two watched variables have one
 */
 class Watched {
     public:
@@ -96,6 +102,19 @@ class Watched {
         {
         }
 
+        /**
+        @brief Constructor for an at-most-one or an XOR constraint
+        */
+        Watched(const uint32_t num, const WatchType t) :
+            data1(num)
+            , type(watch_card_t)
+            , data2(t == watch_xor_t)
+        {
+            #ifdef DEBUG_WATCHED
+            assert(t == watch_card_t || t == watch_xor_t);
+            #endif
+        }
+
         void setNormOffset(const ClOffset offset)
         {
             #ifdef DEBUG_WATCHED
@@ -121,6 +140,10 @@ class Watched {
                 return watch_binary_t;
             else if (isTri())
                 return watch_tertiary_t;
+            else if (isCard())
+                return watch_card_t;
+            else if (isXor())
+                return watch_xor_t;
             else
                 return watch_clause_t;
         }
@@ -140,6 +163,16 @@ class Watched {
             return (type == watch_tertiary_t);
         }
 
+        bool isCard() const
+        {
+            return (type == watch_card_t && data2 == 0);
+        }
+
+        bool isXor() const
+        {
+            return (type == watch_card_t && data2 == 1);
+        }
+
         /**
         @brief Get the sole other lit of the binary clause, or get lit2 of the tertiary clause
         */
@@ -233,13 +266,42 @@ class Watched {
             return data2;
         }
 
+        /**
+        @brief Get the index of the at-most-one constraint
+        */
+        uint32_t getCard() const
+        {
+            #ifdef DEBUG_WATCHED
+            assert(isCard());
+            #endif
+            return data1;
+        }
+
+        /**
+        @brief Get the index of the XOR constraint
+        */
+        uint32_t getXor() const
+        {
+            #ifdef DEBUG_WATCHED
+            assert(isXor());
+            #endif
+            return data1;
+        }
+
     private:
         uint32_t data1;
-        //binary, tertiary or long, as per WatchType
+        //binary, tertiary, long, or cardinality and XOR, as per WatchType
         uint32_t type:2;
         uint32_t data2:30;
 };
 
+///Watchlists (and the occurrence lists built on them) have their own MemTag
+template<>
+struct MemTagOf<Watched>
+{
+    static const MemTag tag = MemTag::watches;
+};
+
 inline std::ostream& operator<<(std::ostream& os, const Watched& ws)
 {
 
@@ -257,6 +319,14 @@ inline std::ostream& operator<<(std::ostream& os, const Watched& ws)
         << " (learnt: " << ws.learnt() << " )";
     }
 
+    if (ws.isCard()) {
+        os << "Card: " << ws.getCard();
+    }
+
+    if (ws.isXor()) {
+        os << "Xor: " << ws.getXor();
+    }
+
     return os;
 }
 
@@ -304,6 +374,20 @@ static inline void removeWCl(vec<Watched> &ws, const ClOffset c)
     ws.shrink_(1);
 }
 
+//////////////////
+// XOR constraint
+//////////////////
+static inline void removeWXor(vec<Watched> &ws, const uint32_t num)
+{
+    vec<Watched>::iterator i = ws.begin(), end = ws.end();
+    for (; i != end && (!i->isXor() || i->getXor() != num); i++);
+    assert(i != end);
+    vec<Watched>::iterator j = i;
+    i++;
+    for (; i != end; j++, i++) *j = *i;
+    ws.shrink_(1);
+}
+
 //////////////////
 // TRI Clause
 //////////////////
@@ -0,0 +1,76 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos and collaborators. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+
+#ifndef __XOR_H__
+#define __XOR_H__
+
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include "solvertypes.h"
+
+namespace CMSat {
+using std::vector;
+
+/**
+@brief An XOR constraint: the variables XOR-ed together give 'rhs'
+
+When it is attached for the search, vars[0] and vars[1] are watched, through
+both of their literals
+*/
+class Xor
+{
+    public:
+        Xor(const vector<Lit>& cl, const bool _rhs) :
+            rhs(_rhs)
+        {
+            for (uint32_t i = 0; i < cl.size(); i++) {
+                vars.push_back(cl[i].var());
+            }
+            std::sort(vars.begin(), vars.end());
+        }
+
+        bool operator==(const Xor& other) const
+        {
+            return (rhs == other.rhs && vars == other.vars);
+        }
+
+        vector<Var> vars;
+        bool rhs;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const Xor& thisXor)
+{
+    for (uint32_t i = 0; i < thisXor.vars.size(); i++) {
+        os << Lit(thisXor.vars[i], false);
+
+        if (i+1 < thisXor.vars.size())
+            os << " + ";
+    }
+    os << " =  " << std::boolalpha << thisXor.rhs << std::noboolalpha;
+
+    return os;
+}
+
+} //end namespace
+
+#endif //__XOR_H__
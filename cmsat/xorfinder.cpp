@@ -42,6 +42,9 @@ XorFinder::XorFinder(Simplifier* _subsumer, Solver* _solver) :
 bool XorFinder::findXors()
 {
     maxTimeFindXors = 200LL*1000LL*1000LL;
+    #ifdef DRUP
+    drupXorBudget = 1000LL*1000LL;
+    #endif
     double myTime = cpuTime();
     numCalls++;
     runStats.clear();
@@ -253,6 +256,12 @@ bool XorFinder::extractInfoFromBlock(
         //this matrix is way too large, skip :(
         return solver->okay();
     }
+
+    #ifdef DRUP
+    if (solver->drup) {
+        return extractInfoFromBlockWithProof(thisXors);
+    }
+    #endif
     mzd_t *mat = mzd_init(thisXors.size(), numCols);
     assert(mzd_is_zero(mat));
 
@@ -300,46 +309,212 @@ bool XorFinder::extractInfoFromBlock(
 
         //Extract RHS
         const bool rhs = mzd_read_bit(mat, i, numCols-1);
+        if (!addExtractedXor(lits, rhs))
+            goto end;
+    }
 
-        switch(lits.size()) {
-            case 0:
-                //0-long XOR clause is equal to 1? If so, it's UNSAT
-                if (rhs) {
-                    solver->addXorClauseInt(lits, 1, false);
-                    assert(!solver->okay());
-                    goto end;
-                }
-                break;
+    //Free mat, and return what need to be returned
+    end:
+    mzd_free(mat);
 
-            case 1: {
-                runStats.newUnits++;
-                solver->addXorClauseInt(lits, rhs, false);
-                if (!solver->okay())
-                    goto end;
-                break;
-            }
+    return solver->okay();
+}
 
-            case 2: {
-                runStats.newBins++;
-                solver->addXorClauseInt(lits, rhs, false);
-                if (!solver->okay())
-                    goto end;
-                break;
+/**
+@brief Adds the 0, 1 and 2-long XORs to the solver. Returns FALSE if UNSAT
+*/
+bool XorFinder::addExtractedXor(const vector<Lit>& lits, const bool rhs)
+{
+    switch(lits.size()) {
+        case 0:
+            //0-long XOR clause is equal to 1? If so, it's UNSAT
+            if (rhs) {
+                solver->addXorClauseInt(lits, 1, false);
+                assert(!solver->okay());
             }
+            break;
 
-            default:
-                //if resulting xor is larger than 2-long, we cannot extract anything.
-                break;
+        case 1:
+            runStats.newUnits++;
+            solver->addXorClauseInt(lits, rhs, false);
+            break;
+
+        case 2:
+            runStats.newBins++;
+            solver->addXorClauseInt(lits, rhs, false);
+            break;
+
+        default:
+            //if resulting xor is larger than 2-long, we cannot extract anything.
+            break;
+    }
+
+    return solver->okay();
+}
+
+#ifdef DRUP
+bool XorFinder::extractInfoFromBlockWithProof(const vector<size_t>& thisXors)
+{
+    vector<Xor> rows;
+    for(const size_t at: thisXors) {
+        rows.push_back(xors[at]);
+    }
+    vector<char> derived(rows.size(), false);
+    echelonizeWithProof(rows, derived);
+
+    vector<Lit> lits;
+    for(const Xor& x: rows) {
+        if (x.vars.size() > 2)
+            continue;
+
+        lits.clear();
+        for(const Var var: x.vars) {
+            lits.push_back(Lit(var, false));
         }
+        if (!addExtractedXor(lits, x.rhs))
+            break;
     }
 
-    //Free mat, and return what need to be returned
-    end:
-    mzd_free(mat);
+    //The short ones have been added by the solver, the long ones are useless
+    for(size_t i = 0; i < rows.size(); i++) {
+        if (derived[i] && rows[i].vars.size() > 2) {
+            drupDeleteXor(rows[i]);
+        }
+    }
 
     return solver->okay();
 }
 
+/**
+@brief Gauss-Jordan elimination that writes every row operation to the proof
+
+Row operations that would be too expensive to prove are skipped. The rows are
+then not fully reduced, but each of them is still implied by the original
+XORs, which is all we need.
+*/
+void XorFinder::echelonizeWithProof(vector<Xor>& rows, vector<char>& derived)
+{
+    for(size_t i = 0; i < rows.size(); i++) {
+        if (rows[i].vars.empty())
+            continue;
+
+        const Var pivot = rows[i].vars[0];
+        for(size_t j = 0; j < rows.size(); j++) {
+            if (j == i
+                || !std::binary_search(rows[j].vars.begin(), rows[j].vars.end(), pivot)
+            ) {
+                continue;
+            }
+
+            Xor sum(vector<Lit>(), false);
+            if (!addXorsWithProof(rows[j], rows[i], sum))
+                continue;
+
+            //Original XORs are the solver's clauses, don't delete those
+            if (derived[j]) {
+                drupDeleteXor(rows[j]);
+            }
+            rows[j] = sum;
+            derived[j] = true;
+        }
+    }
+}
+
+/**
+@brief Calculates sum = a + b, writing the CNF of "sum" to the proof
+
+The clauses of the sum are not RUP from the clauses of "a" and "b", since the
+variables they share remain unassigned. So every clause C of the sum is first
+derived with all possible assignments to the shared variables added to it (these
+are RUP), and then these are resolved back to C one shared variable at a time.
+
+Returns FALSE if this would need too many proof lines
+*/
+bool XorFinder::addXorsWithProof(const Xor& a, const Xor& b, Xor& sum)
+{
+    vector<Var> shared;
+    std::set_intersection(
+        a.vars.begin(), a.vars.end()
+        , b.vars.begin(), b.vars.end()
+        , std::back_inserter(shared)
+    );
+    sum.vars.clear();
+    std::set_symmetric_difference(
+        a.vars.begin(), a.vars.end()
+        , b.vars.begin(), b.vars.end()
+        , std::back_inserter(sum.vars)
+    );
+    sum.rhs = a.rhs ^ b.rhs;
+
+    if (sum.vars.size() > maxDrupXorSize
+        || shared.size() > maxDrupXorShared
+    ) {
+        return false;
+    }
+
+    //Every clause needs a full binary tree of lines over the shared vars
+    const int64_t cost = (1LL << sum.vars.size()) * ((2LL << shared.size()) - 1);
+    if (cost > drupXorBudget)
+        return false;
+    drupXorBudget -= cost;
+
+    vector<Lit> cl;
+    for(uint32_t comb = 0; comb < (1U << sum.vars.size()); comb++) {
+        //Only the combinations that are forbidden by the XOR are clauses
+        if ((uint32_t)__builtin_popcount(comb) % 2 == (uint32_t)sum.rhs)
+            continue;
+
+        cl.clear();
+        for(size_t i = 0; i < sum.vars.size(); i++) {
+            cl.push_back(Lit(sum.vars[i], (comb >> i) & 1));
+        }
+        drupSumClause(cl, shared, 0);
+    }
+
+    return true;
+}
+
+void XorFinder::drupSumClause(
+    vector<Lit>& cl
+    , const vector<Var>& shared
+    , const size_t at
+) {
+    if (at < shared.size()) {
+        for(unsigned sign = 0; sign < 2; sign++) {
+            cl.push_back(Lit(shared[at], sign));
+            drupSumClause(cl, shared, at+1);
+            cl.pop_back();
+        }
+    }
+
+    (*solver->drup) << cl << DrupFlag::fin;
+
+    //The two resolved ones are no longer needed
+    if (at < shared.size()) {
+        for(unsigned sign = 0; sign < 2; sign++) {
+            cl.push_back(Lit(shared[at], sign));
+            (*solver->drup) << DrupFlag::del << cl << DrupFlag::fin;
+            cl.pop_back();
+        }
+    }
+}
+
+void XorFinder::drupDeleteXor(const Xor& x)
+{
+    vector<Lit> cl;
+    for(uint32_t comb = 0; comb < (1U << x.vars.size()); comb++) {
+        if ((uint32_t)__builtin_popcount(comb) % 2 == (uint32_t)x.rhs)
+            continue;
+
+        cl.clear();
+        for(size_t i = 0; i < x.vars.size(); i++) {
+            cl.push_back(Lit(x.vars[i], (comb >> i) & 1));
+        }
+        (*solver->drup) << DrupFlag::del << cl << DrupFlag::fin;
+    }
+}
+#endif //DRUP
+
 vector<size_t> XorFinder::getXorsForBlock(const size_t blockNum)
 {
     vector<size_t> xorsInThisBlock;
@@ -541,12 +716,12 @@ void XorFinder::findXor(vector<Lit>& lits, CL_ABST_TYPE abst)
 
 //TODO stamping
 /*void XorFinder::findXorMatch(
-    const vector<LitExtra>& lits
+    const LitExtraVec& lits
     , const Lit lit
     , FoundXors& foundCls
 ) const {
 
-    for (vector<LitExtra>::const_iterator
+    for (LitExtraVec::const_iterator
         it = lits.begin(), end = lits.end()
         ; it != end
         ; it++
@@ -608,8 +783,8 @@ void XorFinder::findXorMatchExt(
             if (!seen[l->var()]) {
                 bool found = false;
                 //TODO stamping
-                /*const vector<LitExtra>& cache = solver->implCache[Lit(l->var(), true).toInt()].lits;
-                for(vector<LitExtra>::const_iterator it2 = cache.begin(), end2 = cache.end(); it2 != end2 && !found; it2++) {
+                /*const LitExtraVec& cache = solver->implCache[Lit(l->var(), true).toInt()].lits;
+                for(LitExtraVec::const_iterator it2 = cache.begin(), end2 = cache.end(); it2 != end2 && !found; it2++) {
                     if (seen[l->var()] && !seen2[l->var()]) {
                         found = true;
                         seen2[l->var()] = true;
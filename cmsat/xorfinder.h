@@ -29,6 +29,7 @@
 #include <set>
 #include "cset.h"
 #include "xorfinderabst.h"
+#include "xor.h"
 
 namespace CMSat {
 
@@ -40,40 +41,6 @@ using std::set;
 class Solver;
 class Simplifier;
 
-class Xor
-{
-    public:
-        Xor(const vector<Lit>& cl, const bool _rhs) :
-            rhs(_rhs)
-        {
-            for (uint32_t i = 0; i < cl.size(); i++) {
-                vars.push_back(cl[i].var());
-            }
-            std::sort(vars.begin(), vars.end());
-        }
-
-        bool operator==(const Xor& other) const
-        {
-            return (rhs == other.rhs && vars == other.vars);
-        }
-
-        vector<Var> vars;
-        bool rhs;
-};
-
-inline std::ostream& operator<<(std::ostream& os, const Xor& thisXor)
-{
-    for (uint32_t i = 0; i < thisXor.vars.size(); i++) {
-        os << Lit(thisXor.vars[i], false);
-
-        if (i+1 < thisXor.vars.size())
-            os << " + ";
-    }
-    os << " =  " << std::boolalpha << thisXor.rhs << std::noboolalpha;
-
-    return os;
-}
-
 class FoundXors
 {
     public:
@@ -306,7 +273,7 @@ private:
     );
     //TODO stamping finXorMatch with stamp
     /*void findXorMatch(
-        const vector<LitExtra>& lits
+        const LitExtraVec& lits
         , const Lit lit
         , FoundXors& foundCls
     ) const;*/
@@ -320,6 +287,19 @@ private:
     void cutIntoBlocks(const vector<size_t>& xorsToUse);
     bool extractInfoFromBlock(const vector<Var>& block, const size_t blockNum);
     vector<size_t> getXorsForBlock(const size_t blockNum);
+    bool addExtractedXor(const vector<Lit>& lits, const bool rhs);
+
+    #ifdef DRUP
+    //Proof-producing echelonization, used instead of M4RI when writing DRUP
+    bool extractInfoFromBlockWithProof(const vector<size_t>& thisXors);
+    void echelonizeWithProof(vector<Xor>& rows, vector<char>& derived);
+    bool addXorsWithProof(const Xor& a, const Xor& b, Xor& sum);
+    void drupSumClause(vector<Lit>& cl, const vector<Var>& shared, const size_t at);
+    void drupDeleteXor(const Xor& x);
+    static const size_t maxDrupXorSize = 8; ///<Longest sum we write out
+    static const size_t maxDrupXorShared = 4; ///<Most shared vars in a sum
+    int64_t drupXorBudget; ///<Number of proof lines we can still write
+    #endif
 
     //Major calculated data and indexes to this data
     vector<Xor> xors; ///<Recovered XORs